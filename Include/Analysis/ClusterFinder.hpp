@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Analysis/ParticleSnapshot.hpp"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Analysis {
+
+struct Cluster {
+  std::uint32_t id = 0;
+  std::uint32_t memberCount = 0;
+  float mass = 0.0f;
+  glm::vec2 center{0.0f, 0.0f};
+  float radius = 0.0f; // RMS distance of members from the centre
+};
+
+struct ClusterCatalog {
+  std::vector<Cluster> clusters;             // Sorted by descending mass
+  std::vector<std::int32_t> labels;          // Cluster id per snapshot entry
+  std::vector<std::uint32_t> particleIndices; // Pool slot per snapshot entry
+  float linkingLength = 0.0f;
+  double findSeconds = 0.0;
+
+  static constexpr std::int32_t NO_CLUSTER = -1;
+};
+
+// Friends-of-friends group finder. Particles closer than the linking length
+// are joined; connected groups with at least minMembers particles are
+// reported as clusters. Neighbours come from a uniform grid with cells no
+// smaller than the linking length, and groups are merged with a lock-free
+// union-find so the pair search runs across the whole thread pool.
+class ClusterFinder {
+public:
+  explicit ClusterFinder(Core::ThreadPool &threadPool);
+  ~ClusterFinder();
+
+  ClusterFinder(const ClusterFinder &) = delete;
+  ClusterFinder &operator=(const ClusterFinder &) = delete;
+
+  void SetLinkingLength(float length) { linkingLength_ = length; }
+  void SetMinMembers(std::size_t count) { minMembers_ = count; }
+  [[nodiscard]] float GetLinkingLength() const { return linkingLength_.load(); }
+
+  // Runs a search and blocks until it completes
+  [[nodiscard]] ClusterCatalog Find(const ParticleSnapshot &snapshot) const;
+
+  // Starts a search on a background thread unless one is already running.
+  // The result replaces GetLatest() when done.
+  bool FindAsync(ParticleSnapshot snapshot);
+  [[nodiscard]] bool IsBusy() const;
+  [[nodiscard]] std::shared_ptr<const ClusterCatalog> GetLatest() const;
+
+private:
+  Core::ThreadPool &threadPool_;
+
+  // Read once per search, so they may be changed while one is running
+  std::atomic<float> linkingLength_{3.0f};
+  std::atomic<std::size_t> minMembers_{20};
+
+  std::future<void> pending_;
+  mutable std::mutex resultMutex_;
+  std::shared_ptr<const ClusterCatalog> latest_;
+
+  static constexpr std::size_t CHUNK_SIZE = 16384;
+  static constexpr std::size_t CELLS_PER_PARTICLE = 2;
+};
+
+} // namespace Analysis
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Analysis {
+
+// Structure-of-arrays copy of the active particles, taken on the frame thread
+// so background analyses never touch live simulation state.
+struct ParticleSnapshot {
+  std::vector<glm::vec2> positions;
+  std::vector<glm::vec2> velocities;
+  std::vector<float> masses;
+  std::vector<std::uint32_t> particleIndices; // Slot in the particle pool
+
+  [[nodiscard]] std::size_t GetSize() const noexcept {
+    return positions.size();
+  }
+
+  static ParticleSnapshot Capture(std::span<const Graphics::Particle> particles,
+                                  Core::ThreadPool &threadPool);
+
+  static constexpr std::size_t CAPTURE_CHUNK_SIZE = 16384;
+};
+
+} // namespace Analysis
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Analysis/ParticleSnapshot.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Analysis {
+
+inline constexpr std::size_t MAX_FOURIER_MODE = 4;
+
+struct RadialBin {
+  float innerRadius = 0.0f;
+  float outerRadius = 0.0f;
+  std::uint32_t count = 0;
+  float mass = 0.0f;
+  float surfaceDensity = 0.0f;
+  float rotationVelocity = 0.0f; // Mass-weighted mean tangential velocity
+  float radialVelocity = 0.0f;
+  float radialDispersion = 0.0f;
+  float tangentialDispersion = 0.0f;
+  std::array<float, MAX_FOURIER_MODE> fourierAmplitudes{}; // A_m for m=1..4
+};
+
+struct RadialProfile {
+  double simulationTime = 0.0;
+  glm::vec2 center{0.0f, 0.0f};
+  std::vector<RadialBin> bins;
+  std::array<float, MAX_FOURIER_MODE> globalFourierAmplitudes{};
+  double analysisSeconds = 0.0;
+};
+
+struct ProfileSettings {
+  std::size_t binCount = 48;
+  float maxRadius = 700.0f;
+};
+
+// Radial density profile, rotation curve, velocity dispersion and m=1..4
+// Fourier amplitudes around a centre body. Each chunk of the snapshot fills
+// its own histogram; partial histograms are merged in chunk order so the
+// result does not depend on the worker count.
+class ProfileAnalyzer {
+public:
+  explicit ProfileAnalyzer(Core::ThreadPool &threadPool);
+  ~ProfileAnalyzer();
+
+  ProfileAnalyzer(const ProfileAnalyzer &) = delete;
+  ProfileAnalyzer &operator=(const ProfileAnalyzer &) = delete;
+
+  void SetSettings(const ProfileSettings &settings) { settings_ = settings; }
+  [[nodiscard]] const ProfileSettings &GetSettings() const { return settings_; }
+
+  // Appends every finished profile to a CSV file (one row per bin)
+  bool OpenCsvStream(const std::string &path);
+
+  [[nodiscard]] RadialProfile Analyze(const ParticleSnapshot &snapshot,
+                                      const glm::vec2 &center,
+                                      const glm::vec2 &centerVelocity,
+                                      double simulationTime) const;
+
+  // Analyzes on a background thread unless a run is already in flight
+  bool AnalyzeAsync(ParticleSnapshot snapshot, const glm::vec2 &center,
+                    const glm::vec2 &centerVelocity, double simulationTime);
+  [[nodiscard]] bool IsBusy() const;
+  [[nodiscard]] std::shared_ptr<const RadialProfile> GetLatest() const;
+
+private:
+  [[nodiscard]] RadialProfile Analyze(const ParticleSnapshot &snapshot,
+                                      const ProfileSettings &settings,
+                                      const glm::vec2 &center,
+                                      const glm::vec2 &centerVelocity,
+                                      double simulationTime) const;
+  void WriteCsv(const RadialProfile &profile);
+
+private:
+  Core::ThreadPool &threadPool_;
+  ProfileSettings settings_;
+
+  std::future<void> pending_;
+  mutable std::mutex resultMutex_;
+  std::shared_ptr<const RadialProfile> latest_;
+
+  std::ofstream csv_;
+
+  static constexpr std::size_t CHUNK_SIZE = 16384;
+};
+
+} // namespace Analysis
@@ -1,14 +1,117 @@
 #pragma once
 
+#include "Utils/SpscRing.hpp"
 #include <SFML/Audio.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace Audio {
 
+// Real-input FFT of a fixed power-of-two size. The input is packed into a
+// half-size complex transform with real and imaginary parts in separate
+// arrays, so the butterfly loops vectorize; tables and scratch are
+// allocated up front and Forward never allocates.
+class RealFFT {
+public:
+  explicit RealFFT(std::size_t size);
+
+  [[nodiscard]] std::size_t GetSize() const noexcept { return size_; }
+
+  // input.size() == GetSize(); writes GetSize() / 2 + 1 bin magnitudes
+  void Forward(std::span<const float> input, std::span<float> magnitudes);
+
+private:
+  std::size_t size_;
+  std::size_t half_;
+  std::vector<std::uint32_t> bitReverse_;
+  // Per-stage twiddles laid out contiguously: stage with span 2h uses h
+  // entries starting at offset h - 1
+  std::vector<float> twiddleRe_;
+  std::vector<float> twiddleIm_;
+  std::vector<float> splitRe_;
+  std::vector<float> splitIm_;
+  std::vector<float> re_;
+  std::vector<float> im_;
+};
+
+struct AudioFeatures {
+  static constexpr std::size_t BAND_COUNT = 8;
+
+  // Log-spaced band energies, normalized to their recent peak (0..1)
+  std::array<float, BAND_COUNT> bands{};
+  float level = 0.0f;         // RMS of the analysis window
+  float onsetStrength = 0.0f; // Spectral flux relative to its threshold
+  bool onset = false;
+  double time = 0.0; // Seconds of audio analyzed so far
+
+  [[nodiscard]] float GetBass() const { return 0.5f * (bands[0] + bands[1]); }
+};
+
+// Streaming spectrum analysis of the microphone or a music file. Analysis
+// runs on SFML's audio thread inside the recorder/stream callback; results
+// reach the frame loop through a lock-free SPSC ring, so neither side ever
+// waits for the other. Frames the frame loop does not collect in time are
+// dropped rather than queued.
 class AudioAnalyzer {
 public:
-  AudioAnalyzer() = default;
-  ~AudioAnalyzer() = default;
+  static constexpr std::size_t FFT_SIZE = 1024;
+  static constexpr std::size_t HOP_SIZE = 512;
+
+  AudioAnalyzer();
+  ~AudioAnalyzer();
+
+  AudioAnalyzer(const AudioAnalyzer &) = delete;
+  AudioAnalyzer &operator=(const AudioAnalyzer &) = delete;
+
+  bool StartCapture(unsigned sampleRate = 44100);
+  // Plays the file and analyzes what is played
+  bool PlayFile(const std::string &path);
+  void Stop();
+
+  [[nodiscard]] bool IsRunning() const;
+
+  // Frame thread: the newest features since the last call, with onsets in
+  // between folded in. Returns false if nothing new arrived.
+  bool Poll(AudioFeatures &features);
+
+private:
+  class CaptureSource;
+  class MusicSource;
+
+  void Prepare(unsigned sampleRate);
+  // Audio thread only
+  void Process(const sf::Int16 *samples, std::size_t sampleCount,
+               unsigned channelCount);
+  void AnalyzeFrame();
+
+  std::unique_ptr<CaptureSource> capture_;
+  std::unique_ptr<MusicSource> music_;
+
+  // Audio thread state, sized in Prepare
+  RealFFT fft_{FFT_SIZE};
+  std::array<float, FFT_SIZE> window_{};
+  std::array<float, FFT_SIZE> history_{};
+  std::array<float, FFT_SIZE> frame_{};
+  std::array<float, FFT_SIZE / 2 + 1> spectrum_{};
+  std::array<float, FFT_SIZE / 2 + 1> previousSpectrum_{};
+  std::array<std::size_t, AudioFeatures::BAND_COUNT + 1> bandEdges_{};
+  std::array<float, AudioFeatures::BAND_COUNT> bandPeaks_{};
+  std::array<float, 32> fluxHistory_{};
+  std::size_t fluxIndex_ = 0;
+  std::size_t historyIndex_ = 0;
+  std::size_t samplesSinceHop_ = 0;
+  std::size_t framesSinceOnset_ = 0;
+  float previousFlux_ = 0.0f;
+  unsigned sampleRate_ = 44100;
+  std::uint64_t samplesAnalyzed_ = 0;
+
+  Utils::SpscRing<AudioFeatures, 64> ring_;
 };
 
-} // namespace Audio
\ No newline at end of file
+} // namespace Audio
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Utils/TripleBuffer.hpp"
+#include <SFML/Audio.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Audio {
+
+struct SonifierVoice {
+  float frequency = 220.0f; // Hz
+  float amplitude = 0.0f;   // 0..1
+  float pan = 0.0f;         // -1 (left) .. 1 (right)
+};
+
+// Snapshot of what the simulation wants to hear, published once per frame
+struct SonifierParameters {
+  static constexpr std::size_t MAX_VOICES = 16;
+
+  std::array<SonifierVoice, MAX_VOICES> voices{};
+  std::size_t voiceCount = 0;
+  // Bumped for every new transient; the audio thread fires one per change
+  std::uint32_t transientSerial = 0;
+  float transientAmplitude = 0.0f;
+  float transientPan = 0.0f;
+};
+
+struct SonifierOptions {
+  unsigned sampleRate = 44100;
+  // Frames per buffer handed to the device; SFML keeps three in flight, so
+  // the latency is about 3 * bufferFrames / sampleRate
+  std::size_t bufferFrames = 512;
+  float masterGain = 0.5f;
+};
+
+// Stereo synthesizer streaming simulation state as sound. The audio
+// callback only reads precomputed wavetables and preallocated buffers and
+// takes parameters from a wait-free triple buffer, so a slow simulation
+// frame can delay what is heard but never stall the device. Voice
+// frequency and amplitude changes are ramped across a buffer so parameter
+// updates arriving at frame rate do not click.
+class Sonifier : public sf::SoundStream {
+public:
+  explicit Sonifier(const SonifierOptions &options = {});
+  ~Sonifier() override;
+
+  Sonifier(const Sonifier &) = delete;
+  Sonifier &operator=(const Sonifier &) = delete;
+
+  // Simulation thread; never blocks
+  void Publish(const SonifierParameters &parameters) {
+    parameters_.Publish(parameters);
+  }
+
+  [[nodiscard]] const SonifierOptions &GetOptions() const noexcept {
+    return options_;
+  }
+
+protected:
+  bool onGetData(Chunk &data) override;
+  void onSeek(sf::Time timeOffset) override;
+
+private:
+  static constexpr std::size_t WAVETABLE_SIZE = 2048;
+  static constexpr std::size_t NOISE_SIZE = 16384;
+
+  struct VoiceState {
+    float phase = 0.0f; // In wavetable samples
+    float frequency = 0.0f;
+    float amplitude = 0.0f;
+    float pan = 0.0f;
+  };
+
+  [[nodiscard]] float Oscillate(float &phase, float increment) const;
+
+  SonifierOptions options_;
+  Utils::TripleBuffer<SonifierParameters> parameters_;
+
+  // Audio thread only
+  std::vector<float> wavetable_; // WAVETABLE_SIZE + 1 for interpolation
+  std::vector<float> noise_;
+  std::vector<float> mix_; // Interleaved stereo
+  std::vector<sf::Int16> samples_;
+  std::array<VoiceState, SonifierParameters::MAX_VOICES> voices_{};
+  std::uint32_t transientSerial_ = 0;
+  float transientEnvelope_ = 0.0f;
+  float transientDecay_ = 0.0f; // Per-sample envelope factor
+  float transientPan_ = 0.0f;
+  float transientPhase_ = 0.0f;
+  std::size_t noisePosition_ = 0;
+};
+
+} // namespace Audio
@@ -32,6 +32,8 @@ public:
 
   [[nodiscard]] glm::vec2 ScreenToWorld(const glm::vec2 &screenPos) const;
   [[nodiscard]] glm::vec2 WorldToScreen(const glm::vec2 &worldPos) const;
+  // Axis-aligned world rectangle covering the whole screen
+  void GetWorldBounds(glm::vec2 &min, glm::vec2 &max) const;
 
   void Update();
 
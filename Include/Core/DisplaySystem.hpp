@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Utils/FlightRecorder.hpp"
 #include <SFML/Graphics.hpp>
 #include <chrono>
 #include <memory>
@@ -24,6 +25,8 @@ struct DisplayConfig {
   bool vsync = true;
   unsigned int framerate_limit = 60;
   unsigned int antialiasing_level = 8;
+  bool flight_recorder = true;
+  std::string hitch_directory = "Hitches";
 };
 
 enum class DisplayError {
@@ -52,6 +55,9 @@ public:
   [[nodiscard]] InputManager &GetInputManager() noexcept {
     return *inputManager_;
   }
+  [[nodiscard]] PerformanceProfiler &GetProfiler() noexcept {
+    return *profiler_;
+  }
   [[nodiscard]] VisualMode* GetCurrentMode() noexcept {
     return currentModeIndex_ < visualModes_.size() 
         ? visualModes_[currentModeIndex_].get() 
@@ -60,9 +66,13 @@ public:
 
 private:
   void ProcessEvents();
+  void HandleEvent(const sf::Event &event);
+  [[nodiscard]] bool CanSleep() const;
+  void WaitForEvents();
   void Update(float deltaTime);
   void Render();
   void UpdatePerformanceMetrics();
+  [[nodiscard]] TraceContext GetTraceContext() const;
 
 private:
   sf::RenderWindow window_;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Core {
+
+class ThreadPool;
+
+enum class ExecutionBackendType { ThreadPool, StdParallel, OpenMP, Serial };
+
+[[nodiscard]] std::string ToString(ExecutionBackendType type);
+[[nodiscard]] std::optional<ExecutionBackendType>
+ParseExecutionBackend(std::string_view name);
+
+// Whether the backend was compiled in (OpenMP needs -fopenmp, StdParallel
+// needs a standard library with parallel algorithms)
+[[nodiscard]] bool IsExecutionBackendAvailable(ExecutionBackendType type);
+[[nodiscard]] std::vector<ExecutionBackendType> GetAvailableExecutionBackends();
+
+// Runs chunked particle passes. Every backend sees the same fixed chunks,
+// so per-particle results and chunk-ordered reductions are identical
+// whichever backend runs them.
+class ExecutionBackend {
+public:
+  using ChunkFunction = std::function<void(std::size_t, std::size_t)>;
+
+  virtual ~ExecutionBackend() = default;
+
+  // Calls func(begin, end) for each chunk of [0, count) and blocks until
+  // all chunks are done
+  virtual void ForEachChunk(std::size_t count, std::size_t chunkSize,
+                            const ChunkFunction &func) = 0;
+
+  [[nodiscard]] virtual ExecutionBackendType GetType() const = 0;
+  [[nodiscard]] std::string GetName() const { return ToString(GetType()); }
+
+  // Partials are folded with combine in chunk order
+  template <typename T, typename F, typename Combine>
+  T Reduce(std::size_t count, std::size_t chunkSize, T init, F &&func,
+           Combine &&combine) {
+    if (chunkSize == 0) {
+      chunkSize = 1;
+    }
+    std::vector<T> partials((count + chunkSize - 1) / chunkSize, init);
+    ForEachChunk(count, chunkSize, [&](std::size_t begin, std::size_t end) {
+      partials[begin / chunkSize] = func(begin, end);
+    });
+
+    T result = init;
+    for (const auto &partial : partials) {
+      result = combine(result, partial);
+    }
+    return result;
+  }
+};
+
+// Falls back to the thread pool backend if the requested one is unavailable
+[[nodiscard]] std::unique_ptr<ExecutionBackend>
+CreateExecutionBackend(ExecutionBackendType type, ThreadPool &threadPool);
+
+} // namespace Core
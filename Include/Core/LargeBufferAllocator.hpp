@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <string>
+
+namespace Core {
+
+class ThreadPool;
+
+enum class PagePolicy {
+  Default,              // Regular 4 KB pages
+  TransparentHugePages, // madvise(MADV_HUGEPAGE) on an aligned mapping
+  HugeTLB               // MAP_HUGETLB from the reserved pool, THP fallback
+};
+
+[[nodiscard]] std::string ToString(PagePolicy policy);
+
+// Process-wide settings for large particle and vertex buffers. Allocations
+// of at least LARGE_BUFFER_THRESHOLD bytes are mmap'd with the requested
+// page policy and first-touched in parallel on the given pool, so on NUMA
+// machines the pages land on the nodes of the workers that process them.
+// Pass nullptr before the pool is destroyed.
+void ConfigureLargeBuffers(PagePolicy policy);
+void SetFirstTouchPool(ThreadPool *threadPool);
+
+// Policy actually obtained by the most recent large allocation
+[[nodiscard]] PagePolicy GetEffectivePagePolicy();
+
+inline constexpr std::size_t LARGE_BUFFER_THRESHOLD = 2 * 1024 * 1024;
+
+void *AllocateLargeBuffer(std::size_t bytes);
+void DeallocateLargeBuffer(void *pointer, std::size_t bytes) noexcept;
+
+// Standard allocator that routes large requests through AllocateLargeBuffer
+template <typename T> class LargeBufferAllocator {
+public:
+  using value_type = T;
+
+  LargeBufferAllocator() noexcept = default;
+  template <typename U>
+  LargeBufferAllocator(const LargeBufferAllocator<U> &) noexcept {}
+
+  [[nodiscard]] T *allocate(std::size_t count) {
+    const std::size_t bytes = count * sizeof(T);
+    if (bytes >= LARGE_BUFFER_THRESHOLD) {
+      return static_cast<T *>(AllocateLargeBuffer(bytes));
+    }
+    return static_cast<T *>(
+        ::operator new(bytes, std::align_val_t{alignof(T)}));
+  }
+
+  void deallocate(T *pointer, std::size_t count) noexcept {
+    const std::size_t bytes = count * sizeof(T);
+    if (bytes >= LARGE_BUFFER_THRESHOLD) {
+      DeallocateLargeBuffer(pointer, bytes);
+    } else {
+      ::operator delete(pointer, std::align_val_t{alignof(T)});
+    }
+  }
+
+  template <typename U>
+  bool operator==(const LargeBufferAllocator<U> &) const noexcept {
+    return true;
+  }
+};
+
+} // namespace Core
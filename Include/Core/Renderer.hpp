@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Graphics/ParticleRenderBackend.hpp"
 #include <SFML/Graphics.hpp>
 #include <glm/glm.hpp>
 #include <memory>
@@ -7,7 +8,6 @@
 #include <vector>
 
 namespace Graphics {
-struct Particle;
 struct Mesh {
   // Placeholder for mesh data
 };
@@ -44,7 +44,16 @@ public:
   void BeginFrame();
   void EndFrame();
 
+  // Copies the window contents drawn so far, so idle frames can be
+  // redrawn without rendering the scene again
+  void CaptureScene();
+  void DrawCachedScene();
+  void InvalidateCachedScene() noexcept { hasCachedScene_ = false; }
+  [[nodiscard]] bool HasCachedScene() const noexcept { return hasCachedScene_; }
+
+  // Draws with the current blend mode through the particle render backend
   void DrawParticles(std::span<const Graphics::Particle> particles);
+  void SetParticleRenderBackend(Graphics::ParticleRenderBackendType type);
   void DrawMesh(const Graphics::Mesh &mesh, const Transform &transform);
   void DrawText(const std::string &text, const glm::vec2 &position,
                 const TextStyle &style);
@@ -67,23 +76,19 @@ public:
     return window_;
   }
 
-private:
-  void UpdateVertexArray();
-  void FlushBatch();
-
 private:
   sf::RenderWindow &window_;
   std::unique_ptr<Camera2D> camera_;
 
-  sf::VertexArray vertexArray_;
-  std::vector<sf::Vertex> vertices_;
+  std::unique_ptr<Graphics::ParticleRenderBackend> particleBackend_;
 
   sf::RenderTexture renderTexture_;
   sf::Sprite renderSprite_;
 
-  sf::BlendMode currentBlendMode_ = sf::BlendAlpha;
+  sf::Texture sceneCache_;
+  bool hasCachedScene_ = false;
 
-  static constexpr std::size_t MAX_BATCH_SIZE = 10000;
+  sf::BlendMode currentBlendMode_ = sf::BlendAlpha;
 };
 
 } // namespace Core
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <concepts>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <memory>
@@ -14,6 +19,45 @@
 
 namespace Core {
 
+// Scheduling class of a pool task. Workers always take the most urgent
+// queued task, so frame work overtakes background work at task boundaries.
+enum class TaskPriority {
+  Critical,   // The frame is waiting on it (physics chunks, snapshot copies)
+  Normal,     // Default for Submit and ParallelFor
+  Background, // Nobody waits on it soon (analysis, encoding, file writes)
+};
+inline constexpr std::size_t TASK_PRIORITY_COUNT = 3;
+
+// Scheduling counters since the pool was created or last reset
+struct ThreadPoolMetrics {
+  // Bucket 0 is under 1 us, bucket b covers [2^(b-1), 2^b) us and the last
+  // bucket is open-ended
+  static constexpr std::size_t LATENCY_BUCKETS = 24;
+
+  struct Worker {
+    double busySeconds = 0.0;
+    double idleSeconds = 0.0;     // Waiting for a task
+    double lockWaitSeconds = 0.0; // Blocked on the queue mutex
+    std::uint64_t tasks = 0;
+  };
+
+  double wallSeconds = 0.0;
+  std::vector<Worker> workers;
+  // Time from Submit to a worker starting the task
+  std::array<std::uint64_t, LATENCY_BUCKETS> startLatency{};
+  std::uint64_t tasksSubmitted = 0;
+  double submitLockWaitSeconds = 0.0; // Summed over submitting threads
+  std::size_t queueDepth = 0;
+  std::size_t queueDepthHighWater = 0;
+
+  // Busy time over the wall time of all workers
+  [[nodiscard]] double GetUtilization() const;
+  // Upper edge, in microseconds, of the bucket holding the given fraction
+  // of start latencies
+  [[nodiscard]] double GetLatencyPercentile(double fraction) const;
+  [[nodiscard]] double GetLockWaitSeconds() const;
+};
+
 class ThreadPool {
 public:
   explicit ThreadPool(
@@ -29,6 +73,14 @@ public:
     requires std::invocable<F, Args...>
   auto Submit(F &&func,
               Args &&...args) -> std::future<std::invoke_result_t<F, Args...>> {
+    return Submit(TaskPriority::Normal, std::forward<F>(func),
+                  std::forward<Args>(args)...);
+  }
+
+  template <typename F, typename... Args>
+    requires std::invocable<F, Args...>
+  auto Submit(TaskPriority priority, F &&func,
+              Args &&...args) -> std::future<std::invoke_result_t<F, Args...>> {
     using return_type = std::invoke_result_t<F, Args...>;
 
     auto task = std::make_shared<std::packaged_task<return_type()>>(
@@ -39,16 +91,23 @@ public:
     std::future<return_type> result = task->get_future();
 
     {
-      std::unique_lock<std::mutex> lock(queueMutex_);
+      const auto submitted = Clock::now();
+      auto lock = LockQueue(submitLockWait_);
 
       if (stopping_) {
         throw std::runtime_error("Submit on stopped ThreadPool");
       }
 
-      tasks_.emplace([task]() { (*task)(); });
+      tasks_[static_cast<std::size_t>(priority)].push(
+          {[task]() { (*task)(); }, submitted});
+      OnEnqueued();
     }
 
+    // Reserved workers only wake for critical tasks
     condition_.notify_one();
+    if (priority == TaskPriority::Critical) {
+      criticalCondition_.notify_one();
+    }
     return result;
   }
 
@@ -68,25 +127,133 @@ public:
     }
   }
 
+  // Splits [0, count) into fixed-size chunks and runs func(begin, end) for
+  // each chunk on the pool. Blocks until every chunk has finished.
+  template <typename F>
+    requires std::invocable<F, std::size_t, std::size_t>
+  void ParallelFor(std::size_t count, std::size_t chunkSize, F &&func,
+                   TaskPriority priority = TaskPriority::Normal) {
+    if (count == 0) {
+      return;
+    }
+
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    std::vector<std::future<void>> futures;
+    futures.reserve((count + chunkSize - 1) / chunkSize);
+
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+      std::size_t end = std::min(begin + chunkSize, count);
+      futures.push_back(
+          Submit(priority, [&func, begin, end]() { func(begin, end); }));
+    }
+
+    // Wait for every chunk before rethrowing so no task outlives func.
+    for (auto &future : futures) {
+      future.wait();
+    }
+    for (auto &future : futures) {
+      future.get();
+    }
+  }
+
+  // Reduces [0, count) chunk by chunk: func(begin, end) returns a partial
+  // result and the partials are folded with combine in chunk order, so the
+  // result does not depend on the number of workers.
+  template <typename T, typename F, typename Combine>
+    requires std::invocable<F, std::size_t, std::size_t> &&
+             std::invocable<Combine, T, T>
+  T ParallelReduce(std::size_t count, std::size_t chunkSize, T init, F &&func,
+                   Combine &&combine) {
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    std::vector<T> partials((count + chunkSize - 1) / chunkSize, init);
+
+    ParallelFor(count, chunkSize,
+                [&partials, &func, chunkSize](std::size_t begin,
+                                              std::size_t end) {
+                  partials[begin / chunkSize] = func(begin, end);
+                });
+
+    T result = init;
+    for (const auto &partial : partials) {
+      result = combine(result, partial);
+    }
+    return result;
+  }
+
+  // Keeps the first count workers (at most all but one) free for critical
+  // tasks, so frame work never queues behind long background tasks
+  void SetReservedWorkers(std::size_t count);
+  [[nodiscard]] std::size_t GetReservedWorkers() const noexcept {
+    return reservedWorkers_;
+  }
+
   void WaitForAll();
+  // True on a worker of any pool. Work that would block on the pool, such as
+  // a nested ParallelFor, must run inline there or it can deadlock.
+  [[nodiscard]] static bool IsWorkerThread() noexcept;
   [[nodiscard]] std::size_t GetNumThreads() const noexcept {
     return workers_.size();
   }
-  [[nodiscard]] std::size_t GetNumPendingTasks() const;
+  // Queued plus running tasks; does not take the queue mutex
+  [[nodiscard]] std::size_t GetNumPendingTasks() const noexcept {
+    return pendingTasks_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] ThreadPoolMetrics GetMetrics() const;
+  void ResetMetrics();
 
 private:
-  void WorkerThread();
+  using Clock = std::chrono::steady_clock;
+
+  struct QueuedTask {
+    std::function<void()> func;
+    Clock::time_point submitted;
+  };
+
+  // Written only by the owning worker, so updates are plain relaxed stores
+  struct alignas(64) WorkerCounters {
+    std::atomic<std::uint64_t> busyNanoseconds{0};
+    std::atomic<std::uint64_t> idleNanoseconds{0};
+    std::atomic<std::uint64_t> lockWaitNanoseconds{0};
+    std::atomic<std::uint64_t> tasks{0};
+    std::array<std::atomic<std::uint64_t>, ThreadPoolMetrics::LATENCY_BUCKETS>
+        startLatency{};
+  };
+
+  void WorkerThread(std::size_t index);
+  // Most urgent queued task a worker may take; queueMutex_ must be held
+  [[nodiscard]] std::queue<QueuedTask> *NextQueue(bool criticalOnly);
+  // Locks queueMutex_, adding the time spent blocked when it was contended
+  [[nodiscard]] std::unique_lock<std::mutex>
+  LockQueue(std::atomic<std::uint64_t> &waitNanoseconds);
+  // Queue bookkeeping after a push; queueMutex_ must be held
+  void OnEnqueued();
+  [[nodiscard]] ThreadPoolMetrics ReadCounters() const;
 
 private:
   std::vector<std::jthread> workers_;
-  std::queue<std::function<void()>> tasks_;
+  std::array<std::queue<QueuedTask>, TASK_PRIORITY_COUNT> tasks_;
+  std::atomic<std::size_t> queuedTasks_{0};
+  // Submitted and not yet finished: moves once when a task is queued and
+  // once when it returns, so readers never see it between queue and worker
+  std::atomic<std::size_t> pendingTasks_{0};
 
   mutable std::mutex queueMutex_;
   std::condition_variable condition_;
+  std::condition_variable criticalCondition_; // Reserved workers wait here
   std::condition_variable finished_;
+  std::atomic<std::size_t> reservedWorkers_{0};
 
   std::atomic<bool> stopping_{false};
-  std::atomic<std::size_t> activeTasks_{0};
+
+  std::unique_ptr<WorkerCounters[]> workerCounters_;
+  std::atomic<std::uint64_t> submitLockWait_{0};
+  std::atomic<std::uint64_t> tasksSubmitted_{0};
+  std::atomic<std::size_t> queueDepthHighWater_{0};
+  // GetMetrics reports counters relative to the last reset
+  mutable std::mutex metricsMutex_;
+  ThreadPoolMetrics metricsBaseline_;
+  Clock::time_point metricsEpoch_ = Clock::now();
 };
 
 } // namespace Core
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Utils/FlightRecorder.hpp"
 #include <SFML/Graphics.hpp>
 #include <memory>
 #include <string>
@@ -19,6 +20,8 @@ public:
   virtual void Initialize() = 0;
   virtual void Update(float deltaTime) = 0;
   virtual void Render(sf::RenderTarget &target) = 0;
+  // Text and overlays drawn on top of the scene, including cached frames
+  virtual void RenderHUD(sf::RenderTarget &target) {}
   virtual void HandleInput(const InputEvent &event) = 0;
 
   [[nodiscard]] virtual std::string GetName() const = 0;
@@ -29,6 +32,20 @@ public:
 
   virtual void OnResize(unsigned int width, unsigned int height) {}
 
+  // Scene details attached to flight recorder dumps
+  [[nodiscard]] virtual TraceContext GetTraceContext() const { return {}; }
+
+  // An idle mode only changes in response to input, so the display system
+  // reuses the last frame and sleeps until the next event. Input handlers
+  // mark what they changed; the flags are cleared after each redraw.
+  [[nodiscard]] virtual bool IsIdle() const { return false; }
+
+  void MarkSceneDirty() noexcept { sceneDirty_ = hudDirty_ = true; }
+  void MarkHUDDirty() noexcept { hudDirty_ = true; }
+  void ClearDamage() noexcept { sceneDirty_ = hudDirty_ = false; }
+  [[nodiscard]] bool IsSceneDirty() const noexcept { return sceneDirty_; }
+  [[nodiscard]] bool IsHUDDirty() const noexcept { return hudDirty_; }
+
 protected:
   [[nodiscard]] DisplaySystem &GetDisplaySystem() noexcept {
     return displaySystem_;
@@ -39,6 +56,8 @@ protected:
 
 private:
   DisplaySystem &displaySystem_;
+  bool sceneDirty_ = true;
+  bool hudDirty_ = true;
 };
 
 template <typename T>
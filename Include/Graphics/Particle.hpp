@@ -5,16 +5,19 @@
 
 namespace Graphics {
 
+// Shared by the particle system, the render backends and the simulation
+// kernels. Checkpoints store these records as they are, so the layout is
+// part of that file format.
 struct Particle {
   glm::vec2 position{0.0f, 0.0f};
   glm::vec2 velocity{0.0f, 0.0f};
   glm::vec2 acceleration{0.0f, 0.0f};
-  float mass = 1.0f;
+  sf::Color color{255, 255, 255, 255};
   float size = 1.0f;
   float lifetime = 1.0f;
   float age = 0.0f;
-  sf::Color color = sf::Color::White;
-  bool active = false;
+  float mass = 1.0f;
+  bool active = true;
 };
 
-} // namespace Graphics
\ No newline at end of file
+} // namespace Graphics
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Graphics/Particle.hpp"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Core {
+class ExecutionBackend;
+}
+
+namespace Graphics {
+
+// Ways to get particles on screen. Quads and StreamedQuads draw the same
+// image; Points draws every particle as one pixel; CpuSplat rasterizes on
+// the CPU and uploads one texture, and works without a GPU until Submit.
+enum class ParticleRenderBackendType { Quads, StreamedQuads, Points, CpuSplat };
+
+[[nodiscard]] std::string ToString(ParticleRenderBackendType type);
+[[nodiscard]] std::optional<ParticleRenderBackendType>
+ParseParticleRenderBackend(std::string_view name);
+
+// Particles render as quads (much faster than circles)
+inline void WriteParticleQuad(const Particle &particle, sf::Vertex *vertices) {
+  const float halfSize = particle.size * 0.5f;
+  const sf::Vector2f pos(particle.position.x, particle.position.y);
+
+  vertices[0].position = pos + sf::Vector2f(-halfSize, -halfSize);
+  vertices[1].position = pos + sf::Vector2f(halfSize, -halfSize);
+  vertices[2].position = pos + sf::Vector2f(halfSize, halfSize);
+  vertices[3].position = pos + sf::Vector2f(-halfSize, halfSize);
+  for (int corner = 0; corner < 4; ++corner) {
+    vertices[corner].color = particle.color;
+  }
+}
+
+// StreamedQuads needs vertex buffer support from the driver
+[[nodiscard]] bool
+IsParticleRenderBackendAvailable(ParticleRenderBackendType type);
+[[nodiscard]] std::vector<ParticleRenderBackendType>
+GetAvailableParticleRenderBackends();
+
+// Draws spans of particles (inactive ones are skipped). Prepare does the
+// CPU work for a frame and Submit hands it to the target, so the two can
+// be timed, or run headless, separately.
+class ParticleRenderBackend {
+public:
+  virtual ~ParticleRenderBackend() = default;
+
+  [[nodiscard]] virtual ParticleRenderBackendType GetType() const = 0;
+  [[nodiscard]] std::string GetName() const { return ToString(GetType()); }
+
+  // Vertex generation runs on this backend; serial when none is set
+  void SetExecutionBackend(Core::ExecutionBackend *backend) {
+    executionBackend_ = backend;
+  }
+
+  // view and targetSize place world positions in pixels for backends that
+  // rasterize themselves
+  virtual void Prepare(std::span<const Particle> particles,
+                       const sf::View &view, sf::Vector2u targetSize) = 0;
+  virtual void Submit(sf::RenderTarget &target,
+                      const sf::RenderStates &states) = 0;
+
+  // Vertices of the last Prepare, for headless checks; empty for backends
+  // that do not build any
+  [[nodiscard]] virtual std::span<const sf::Vertex> GetVertices() const {
+    return {};
+  }
+
+  void Draw(std::span<const Particle> particles, sf::RenderTarget &target,
+            const sf::RenderStates &states) {
+    Prepare(particles, target.getView(), target.getSize());
+    Submit(target, states);
+  }
+
+protected:
+  // Calls func(begin, end) for fixed chunks of [0, count)
+  void ForEachChunk(std::size_t count,
+                    const std::function<void(std::size_t, std::size_t)> &func);
+
+  static constexpr std::size_t CHUNK_SIZE = 8192;
+
+private:
+  Core::ExecutionBackend *executionBackend_ = nullptr;
+};
+
+// Additive splats into an RGBA buffer the size of the target: a square of
+// the particle's size in pixels, at least one, with its color scaled by
+// its alpha. Touched pixels are opaque, so Submit with additive blending
+// matches the quads. The view's rotation is ignored.
+class CpuSplatRenderBackend : public ParticleRenderBackend {
+public:
+  [[nodiscard]] ParticleRenderBackendType GetType() const override {
+    return ParticleRenderBackendType::CpuSplat;
+  }
+
+  void Prepare(std::span<const Particle> particles, const sf::View &view,
+               sf::Vector2u targetSize) override;
+  void Submit(sf::RenderTarget &target,
+              const sf::RenderStates &states) override;
+
+  // Row-major RGBA8 of the last Prepare, for headless output
+  [[nodiscard]] std::span<const std::uint8_t> GetPixels() const noexcept {
+    return pixels_;
+  }
+  [[nodiscard]] sf::Vector2u GetSize() const noexcept { return size_; }
+
+private:
+  std::vector<std::uint8_t> pixels_;
+  sf::Vector2u size_{0, 0};
+  sf::Texture texture_;
+};
+
+// Falls back to Quads if the requested backend is unavailable
+[[nodiscard]] std::unique_ptr<ParticleRenderBackend>
+CreateParticleRenderBackend(ParticleRenderBackendType type);
+
+// Average wall time of frames drawn to an offscreen target, in
+// milliseconds. The target is read back at the end so GPU work is counted.
+[[nodiscard]] double
+BenchmarkParticleRenderBackend(ParticleRenderBackend &backend,
+                               std::span<const Particle> particles,
+                               sf::RenderTexture &target, int frames);
+
+// Times every available backend that draws full-size particles (Quads,
+// StreamedQuads, CpuSplat) on the given particles and returns the fastest
+[[nodiscard]] ParticleRenderBackendType
+SelectFastestParticleRenderBackend(std::span<const Particle> particles,
+                                   sf::Vector2u targetSize,
+                                   Core::ExecutionBackend *executionBackend);
+
+} // namespace Graphics
@@ -1,25 +1,23 @@
 #pragma once
 
+#include "Core/ExecutionBackend.hpp"
+#include "Core/LargeBufferAllocator.hpp"
+#include "Graphics/Particle.hpp"
+#include "Graphics/ParticleRenderBackend.hpp"
 #include <SFML/Graphics.hpp>
 #include <concepts>
 #include <glm/glm.hpp>
 #include <memory>
 #include <random>
+#include <span>
 #include <vector>
 
 namespace Graphics {
 
-struct Particle {
-  glm::vec2 position{0.0f, 0.0f};
-  glm::vec2 velocity{0.0f, 0.0f};
-  glm::vec2 acceleration{0.0f, 0.0f};
-  sf::Color color{255, 255, 255, 255};
-  float size = 1.0f;
-  float lifetime = 1.0f;
-  float age = 0.0f;
-  float mass = 1.0f;
-  bool active = true;
-};
+// Particle and vertex storage comes from the large-buffer allocator so big
+// pools get huge pages and NUMA-local first touch
+using ParticleBuffer = std::vector<Particle, Core::LargeBufferAllocator<Particle>>;
+using VertexBuffer = std::vector<sf::Vertex, Core::LargeBufferAllocator<sf::Vertex>>;
 
 template <typename T>
 concept ParticleEmitter = requires(T emitter, Particle &particle) {
@@ -39,8 +37,59 @@ public:
   ~ParticleSystem();
 
   void Update(float deltaTime);
+  // Per-particle step times, parallel to GetParticles(); particles with a
+  // zero step are left untouched
+  void Update(std::span<const float> stepTimes);
   void Render(sf::RenderTarget &target);
 
+  // Fused pipeline: the physics pass updates a chunk and writes its quads
+  // while the chunk is still in cache, instead of separate update, count
+  // and build passes. BeginFusedFrame gives every chunk of chunkSize
+  // particles its own vertex range; each chunk then calls UpdateRange and
+  // WriteVertices for itself, from any thread. After EndFusedFrame, Render
+  // draws those vertices until the particles change. Code that writes to
+  // GetParticles() directly must call InvalidateVertices.
+  void BeginFusedFrame(std::size_t chunkSize);
+  void UpdateRange(std::size_t begin, std::size_t end, float deltaTime);
+  void UpdateRange(std::size_t begin, std::size_t end,
+                   std::span<const float> stepTimes);
+  // The same updates on double position and velocity parallel to the
+  // particles (the physics engine's accurate tracer state); particles
+  // receive the rounded result
+  void UpdateRange(std::size_t begin, std::size_t end, float deltaTime,
+                   std::span<glm::dvec2> positions,
+                   std::span<glm::dvec2> velocities);
+  void UpdateRange(std::size_t begin, std::size_t end,
+                   std::span<const float> stepTimes,
+                   std::span<glm::dvec2> positions,
+                   std::span<glm::dvec2> velocities);
+  void WriteVertices(std::size_t begin, std::size_t end);
+  void EndFusedFrame() { fusedVerticesValid_ = true; }
+  void InvalidateVertices() { fusedVerticesValid_ = false; }
+  [[nodiscard]] bool HasFusedVertices() const noexcept {
+    return fusedVerticesValid_;
+  }
+  // Calls func(vertices, count) for every range of fused quads, in particle
+  // order. Full chunks run into the next one, so they share a range.
+  template <typename F> void ForEachFusedRange(F &&func) const {
+    std::size_t first = 0;
+    std::size_t count = 0;
+    for (std::size_t chunk = 0; chunk < fusedVertexCounts_.size(); ++chunk) {
+      const std::size_t begin = chunk * fusedChunkSize_ * 4;
+      if (begin != first + count) {
+        if (count > 0) {
+          func(&vertices_[first], count);
+        }
+        first = begin;
+        count = 0;
+      }
+      count += fusedVertexCounts_[chunk];
+    }
+    if (count > 0) {
+      func(&vertices_[first], count);
+    }
+  }
+
   template <ParticleEmitter E> void SetEmitter(std::unique_ptr<E> emitter) {
     emitter_ = std::move(emitter);
   }
@@ -53,11 +102,28 @@ public:
   void EmitBurst(std::size_t count, const Particle &particleTemplate);
 
   void Clear();
+  // Reallocates the pool to hold maxParticles slots, all of them inactive.
+  // Used by bulk loaders that write straight into GetParticles().
+  void Resize(std::size_t maxParticles);
   void SetBlendMode(sf::BlendMode mode) { blendMode_ = mode; }
+
+  // Vertex generation runs on this backend; serial when none is set
+  void SetExecutionBackend(Core::ExecutionBackend *backend) {
+    executionBackend_ = backend;
+    renderBackend_->SetExecutionBackend(backend);
+  }
+
+  // Draws the particles outside fused frames (quads by default)
+  void SetRenderBackend(std::unique_ptr<ParticleRenderBackend> backend);
+  [[nodiscard]] const ParticleRenderBackend &GetRenderBackend() const {
+    return *renderBackend_;
+  }
+  // Fused frames write quads, so they are only drawn by the quads backend
+  [[nodiscard]] bool CanFuseVertices() const;
   
   // Direct access for performance-critical updates
-  std::vector<Particle>& GetParticles() { return particles_; }
-  const std::vector<Particle>& GetParticles() const { return particles_; }
+  ParticleBuffer& GetParticles() { return particles_; }
+  const ParticleBuffer& GetParticles() const { return particles_; }
 
   [[nodiscard]] std::size_t GetActiveParticleCount() const;
   [[nodiscard]] std::size_t GetMaxParticles() const { return maxParticles_; }
@@ -67,16 +133,26 @@ public:
 
 private:
   void UpdateParticle(Particle &particle, float deltaTime);
+  void UpdateParticle(Particle &particle, glm::dvec2 &position,
+                      glm::dvec2 &velocity, float deltaTime);
+  void DrawFusedVertices(sf::RenderTarget &target,
+                         const sf::RenderStates &states);
   Particle *GetInactiveParticle();
 
 private:
-  std::vector<Particle> particles_;
+  ParticleBuffer particles_;
   std::size_t maxParticles_;
 
   std::unique_ptr<void, void (*)(void *)> emitter_{nullptr, [](void *) {}};
   std::vector<std::unique_ptr<void, void (*)(void *)>> updaters_;
 
-  sf::VertexArray vertices_;
+  // Fused frames: quads written per chunk at chunk begin * 4
+  VertexBuffer vertices_;
+  std::size_t fusedChunkSize_ = 0;
+  std::vector<std::size_t> fusedVertexCounts_;
+  bool fusedVerticesValid_ = false;
+  std::unique_ptr<ParticleRenderBackend> renderBackend_;
+  Core::ExecutionBackend *executionBackend_ = nullptr;
   sf::BlendMode blendMode_ = sf::BlendAdd;
 
   glm::vec2 gravity_{0.0f, 0.0f};
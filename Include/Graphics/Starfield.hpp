@@ -0,0 +1,127 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <glm/glm.hpp>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Graphics {
+
+// A tile of one parallax layer at one zoom level. Level L tiles are
+// BASE_TILE_SIZE / 2^L world units (of the layer) wide, so they cover about
+// the same screen area whatever the zoom.
+struct StarfieldTileKey {
+  std::int32_t x = 0;
+  std::int32_t y = 0;
+  std::int32_t level = 0;
+  std::uint32_t layer = 0;
+
+  bool operator==(const StarfieldTileKey &) const = default;
+};
+
+struct StarfieldTileKeyHash {
+  std::size_t operator()(const StarfieldTileKey &key) const noexcept;
+};
+
+// Endless background stars in parallax layers. Stars are generated per
+// world-space tile from a hash of the tile key, so a tile always comes out
+// the same and nothing is stored for tiles that are out of view. Missing
+// tiles are generated on background pool tasks; finished ones are kept as
+// quads in a least-recently-used cache of at most maxTiles tiles, from
+// which tiles no longer on screen are evicted first.
+class Starfield {
+public:
+  static constexpr std::size_t LAYER_COUNT = 3;
+  static constexpr float BASE_TILE_SIZE = 256.0f;
+  static constexpr std::size_t DEFAULT_MAX_TILES = 512;
+
+  explicit Starfield(Core::ThreadPool &threadPool, std::uint64_t seed = 1,
+                     std::size_t maxTiles = DEFAULT_MAX_TILES);
+  ~Starfield();
+
+  Starfield(const Starfield &) = delete;
+  Starfield &operator=(const Starfield &) = delete;
+
+  // Picks the visible tiles of every layer for a camera at position showing
+  // screenSize / zoom world units, takes in finished tiles and queues the
+  // missing ones. Tiles show up once generated, usually a frame later.
+  void Update(const glm::vec2 &position, const glm::vec2 &screenSize,
+              float zoom, float rotation);
+  // Draws the visible cached tiles, farthest layer first; the target's view
+  // is restored afterwards
+  void Render(sf::RenderTarget &target);
+
+  // Quads of a tile's stars, in layer world units
+  [[nodiscard]] static std::vector<sf::Vertex>
+  GenerateTile(const StarfieldTileKey &key, std::uint64_t seed);
+
+  [[nodiscard]] std::size_t GetCachedTileCount() const noexcept {
+    return tiles_.size();
+  }
+  [[nodiscard]] std::size_t GetPendingTileCount() const noexcept {
+    return pending_.size();
+  }
+  [[nodiscard]] std::size_t GetVisibleTileCount() const noexcept {
+    return visibleCount_;
+  }
+
+private:
+  // Tiles queued at once, so a jump across the field does not flood the
+  // pool; the rest are queued on later frames
+  static constexpr std::size_t MAX_PENDING_TILES = 64;
+
+  struct Layer {
+    float parallax;     // Fraction of the camera motion and zoom followed
+    float brightness;   // Peak star alpha, 0..1
+    std::uint32_t starsPerTile;
+  };
+  static constexpr std::array<Layer, LAYER_COUNT> LAYERS{{
+      {0.05f, 0.45f, 24},
+      {0.15f, 0.7f, 14},
+      {0.35f, 1.0f, 8},
+  }};
+
+  struct CachedTile {
+    std::vector<sf::Vertex> vertices;
+    std::list<StarfieldTileKey>::iterator lru;
+    std::uint64_t lastVisibleFrame = 0;
+  };
+
+  // What a layer shows this frame
+  struct LayerView {
+    glm::vec2 center{0.0f, 0.0f};
+    glm::vec2 size{0.0f, 0.0f};
+    float rotation = 0.0f;
+    std::vector<StarfieldTileKey> visible;
+  };
+
+  void CollectFinishedTiles();
+  void Evict();
+
+  Core::ThreadPool &threadPool_;
+  std::uint64_t seed_;
+  std::size_t maxTiles_;
+  std::uint64_t frame_ = 0;
+
+  std::unordered_map<StarfieldTileKey, CachedTile, StarfieldTileKeyHash>
+      tiles_;
+  std::list<StarfieldTileKey> lru_; // Most recently visible first
+  std::unordered_map<StarfieldTileKey, std::future<std::vector<sf::Vertex>>,
+                     StarfieldTileKeyHash>
+      pending_;
+
+  std::array<LayerView, LAYER_COUNT> layers_;
+  std::size_t visibleCount_ = 0;
+  std::vector<sf::Vertex> frameVertices_;
+};
+
+} // namespace Graphics
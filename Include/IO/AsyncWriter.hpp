@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace IO {
+
+enum class AsyncWriterBackend { IoUring, ThreadPool };
+
+[[nodiscard]] std::string_view ToString(AsyncWriterBackend backend);
+
+struct AsyncWriterOptions {
+  // Each buffer is written with one request; a multiple of
+  // DIRECT_IO_ALIGNMENT so O_DIRECT offsets stay aligned
+  std::size_t bufferSize = 1 << 20;
+  // Bounds the writes in flight; Append blocks when all are busy
+  std::size_t bufferCount = 8;
+  // Bypass the page cache where the filesystem supports it
+  bool directIO = true;
+  // Skip io_uring even when the kernel offers it
+  bool forceThreadPool = false;
+
+  static constexpr std::size_t DIRECT_IO_ALIGNMENT = 4096;
+};
+
+// Append-only file writer for large sequential output. Data is copied into
+// a small set of reused, page-aligned buffers, and each full buffer is
+// written asynchronously: through io_uring with registered buffers on
+// Linux, or as a pwrite task on the thread pool elsewhere (or when the
+// kernel refuses io_uring). The calling thread only ever copies.
+//
+// Completion callbacks run on the thread pool once every byte up to the end
+// of their Append has reached the file. With the thread-pool backend,
+// Append must not be called from pool tasks: it may wait on them.
+class AsyncWriter {
+public:
+  using Completion = std::function<void(bool success)>;
+
+  explicit AsyncWriter(Core::ThreadPool &threadPool);
+  ~AsyncWriter();
+
+  AsyncWriter(const AsyncWriter &) = delete;
+  AsyncWriter &operator=(const AsyncWriter &) = delete;
+
+  bool Open(const std::filesystem::path &path,
+            const AsyncWriterOptions &options = {});
+  // Copies data into the current buffer, submitting buffers as they fill
+  bool Append(std::span<const std::byte> data, Completion onComplete = {});
+  bool Append(const void *data, std::size_t bytes,
+              Completion onComplete = {}) {
+    return Append({static_cast<const std::byte *>(data), bytes},
+                  std::move(onComplete));
+  }
+  // Writes the partial tail buffer, waits for every write and trims the
+  // file to the bytes appended. Returns false if any write failed.
+  bool Close();
+
+  [[nodiscard]] bool IsOpen() const noexcept { return fd_ >= 0 || stream_; }
+  [[nodiscard]] bool HasFailed() const noexcept { return failed_; }
+  [[nodiscard]] AsyncWriterBackend GetBackend() const noexcept {
+    return backend_;
+  }
+  // Logical file size: everything appended so far
+  [[nodiscard]] std::uint64_t GetSize() const noexcept { return size_; }
+
+private:
+  struct Buffer {
+    std::byte *data = nullptr;
+    std::size_t bytes = 0;   // Bytes submitted (padded for O_DIRECT)
+    std::size_t written = 0; // Bytes confirmed so far
+    std::uint64_t offset = 0;
+    bool done = false;
+  };
+
+  struct PendingCallback {
+    std::uint64_t endOffset = 0;
+    Completion callback;
+  };
+
+  struct Ring;
+
+  bool SetUpRing();
+  void SubmitBuffer(std::size_t index, std::unique_lock<std::mutex> &lock);
+  // On the backend in use; the caller holds mutex_
+  void SubmitWrite(std::size_t index);
+  void SubmitRingWrite(std::size_t index);
+  void SubmitPoolWrite(std::size_t index);
+  void OnWriteComplete(std::size_t index, long result);
+  void CompletionThread();
+  std::size_t AcquireBuffer(std::unique_lock<std::mutex> &lock);
+  void ReleaseStorage();
+
+  Core::ThreadPool &threadPool_;
+  AsyncWriterOptions options_;
+  AsyncWriterBackend backend_ = AsyncWriterBackend::ThreadPool;
+
+  int fd_ = -1;
+  std::unique_ptr<std::fstream> stream_; // Without POSIX pwrite
+  bool direct_ = false;
+
+  std::byte *storage_ = nullptr;
+  std::vector<Buffer> buffers_;
+  std::vector<std::size_t> freeBuffers_;
+  std::size_t current_ = SIZE_MAX; // Buffer being filled by Append
+
+  std::unique_ptr<Ring> ring_;
+  std::thread completionThread_;
+
+  std::mutex mutex_;
+  std::condition_variable writeCompleted_;
+  std::deque<std::size_t> submitted_; // In file order
+  std::deque<PendingCallback> callbacks_;
+  std::size_t poolWrites_ = 0; // Pool tasks that may still use this
+  std::uint64_t size_ = 0;
+  std::atomic<bool> failed_{false};
+};
+
+} // namespace IO
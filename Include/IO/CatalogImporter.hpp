@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Utils/Expected.hpp"
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <string>
+#include <string_view>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Graphics {
+class ParticleSystem;
+}
+
+namespace IO {
+
+enum class CatalogFormat { Auto, Csv, Tsv, Binary };
+
+enum class CatalogError { OpenFailed, EmptyCatalog, TruncatedBinary };
+
+[[nodiscard]] std::string_view ToString(CatalogError error);
+
+struct CatalogImportOptions {
+  CatalogFormat format = CatalogFormat::Auto;
+
+  // Catalog coordinates are mapped as origin + value * scale
+  glm::vec2 origin{0.0f, 0.0f};
+  float positionScale = 1.0f;
+  float velocityScale = 1.0f;
+
+  // Bytes of text handed to each parser task (rounded to line boundaries)
+  std::size_t chunkBytes = 4 * 1024 * 1024;
+};
+
+struct CatalogImportStats {
+  std::size_t particleCount = 0;
+  std::size_t skippedRows = 0;
+  double seconds = 0.0;
+};
+
+// Loads star catalogs as initial conditions. Text catalogs hold one star per
+// row with columns x, y, vx, vy, mass, colour index (B-V); trailing columns
+// may be omitted. Binary dumps are packed little-endian float32 records in
+// the same column order. The file is memory-mapped, split on line boundaries
+// and parsed in parallel; only accepted rows take a slot in the particle
+// pool.
+class CatalogImporter {
+public:
+  explicit CatalogImporter(Core::ThreadPool &threadPool);
+
+  std::expected<CatalogImportStats, CatalogError>
+  Import(const std::string &path, Graphics::ParticleSystem &particleSystem,
+         const CatalogImportOptions &options = {});
+
+  static constexpr std::size_t BINARY_RECORD_FLOATS = 6;
+
+private:
+  Core::ThreadPool &threadPool_;
+};
+
+} // namespace IO
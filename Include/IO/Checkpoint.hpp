@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include "IO/MappedFile.hpp"
+#include "Utils/Expected.hpp"
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace IO {
+
+// Checkpoint files are little-endian and memory-mappable: a 64-byte header,
+// a section table, then one 64-byte aligned array per section. Particles
+// are stored as raw Graphics::Particle records, so a restart maps the file
+// and copies the arrays straight into the pool without parsing.
+inline constexpr std::array<char, 8> CHECKPOINT_MAGIC = {'G', 'L', 'X', 'C',
+                                                         'K', 'P', 'T', '\0'};
+inline constexpr std::uint32_t CHECKPOINT_VERSION = 1;
+inline constexpr std::size_t CHECKPOINT_ALIGNMENT = 64;
+
+enum class CheckpointError {
+  OpenFailed,
+  WriteFailed,
+  BadMagic,
+  UnsupportedVersion,
+  Truncated,
+  LayoutMismatch,
+  MissingSection
+};
+
+[[nodiscard]] std::string_view ToString(CheckpointError error);
+
+enum class CheckpointSectionType : std::uint32_t {
+  Particles = 1,
+  Bodies = 2,
+  Trails = 3,
+  RngState = 4
+};
+
+struct CheckpointHeader {
+  std::array<char, 8> magic = CHECKPOINT_MAGIC;
+  std::uint32_t version = CHECKPOINT_VERSION;
+  std::uint32_t sectionCount = 0;
+  std::uint64_t stepCount = 0;
+  double simulationTime = 0.0;
+  float timeDilation = 1.0f;
+  std::int32_t preset = 0;
+  std::uint32_t seed = 0;
+  std::array<std::uint8_t, 20> reserved{};
+};
+static_assert(sizeof(CheckpointHeader) == CHECKPOINT_ALIGNMENT);
+
+struct CheckpointSection {
+  CheckpointSectionType type = CheckpointSectionType::Particles;
+  std::uint32_t recordSize = 0;
+  std::uint64_t count = 0;
+  std::uint64_t offset = 0; // From the start of the file
+  std::uint64_t bytes = 0;
+};
+static_assert(sizeof(CheckpointSection) == 32);
+
+// Massive body record; its trail points are the next trailCount entries of
+// the Trails section
+struct CheckpointBody {
+  glm::vec2 position{0.0f, 0.0f};
+  glm::vec2 velocity{0.0f, 0.0f};
+  float mass = 0.0f;
+  float radius = 0.0f;
+  std::uint32_t color = 0; // sf::Color::toInteger()
+  std::uint32_t trailCount = 0;
+};
+static_assert(sizeof(CheckpointBody) == 32);
+
+// Everything needed to resume a run, copied out on the frame thread
+struct CheckpointState {
+  CheckpointHeader header;
+  Graphics::ParticleBuffer particles;
+  std::vector<CheckpointBody> bodies;
+  std::vector<glm::vec2> trails;
+  std::string rngState; // std::mt19937 stream representation
+};
+
+[[nodiscard]] std::expected<void, CheckpointError>
+WriteCheckpoint(const CheckpointState &state, const std::filesystem::path &path);
+
+// Read-only mapping of a checkpoint file. The spans point into the mapping
+// and stay valid for the lifetime of this object.
+class Checkpoint {
+public:
+  [[nodiscard]] static std::expected<Checkpoint, CheckpointError>
+  Open(const std::string &path);
+
+  [[nodiscard]] const CheckpointHeader &GetHeader() const noexcept {
+    return header_;
+  }
+  [[nodiscard]] std::span<const Graphics::Particle> GetParticles() const {
+    return particles_;
+  }
+  [[nodiscard]] std::span<const CheckpointBody> GetBodies() const {
+    return bodies_;
+  }
+  [[nodiscard]] std::span<const glm::vec2> GetTrails() const { return trails_; }
+  [[nodiscard]] std::string_view GetRngState() const { return rngState_; }
+
+private:
+  MappedFile file_;
+  CheckpointHeader header_;
+  std::span<const Graphics::Particle> particles_;
+  std::span<const CheckpointBody> bodies_;
+  std::span<const glm::vec2> trails_;
+  std::string_view rngState_;
+};
+
+// Writes checkpoints on a background thread. The state is shared so the
+// caller can reuse its particle buffer for the next checkpoint once the
+// write has finished.
+class CheckpointWriter {
+public:
+  CheckpointWriter() = default;
+  ~CheckpointWriter();
+
+  CheckpointWriter(const CheckpointWriter &) = delete;
+  CheckpointWriter &operator=(const CheckpointWriter &) = delete;
+
+  // Returns false if the previous checkpoint is still being written
+  bool WriteAsync(std::shared_ptr<const CheckpointState> state,
+                  std::filesystem::path path);
+  [[nodiscard]] bool IsBusy() const;
+
+private:
+  std::future<void> pending_;
+};
+
+} // namespace IO
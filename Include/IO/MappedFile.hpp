@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace IO {
+
+// Read-only view of a whole file. Uses mmap on POSIX systems and falls back
+// to reading the file into memory elsewhere.
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  bool Open(const std::string &path);
+  void Close();
+
+  [[nodiscard]] bool IsOpen() const noexcept { return data_ != nullptr; }
+  [[nodiscard]] std::size_t GetSize() const noexcept { return size_; }
+  [[nodiscard]] std::span<const char> GetData() const noexcept {
+    return {data_, size_};
+  }
+
+private:
+  const char *data_ = nullptr;
+  std::size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<char> fallbackBuffer_;
+};
+
+} // namespace IO
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include "IO/AsyncWriter.hpp"
+#include "IO/MappedFile.hpp"
+#include "Utils/Expected.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <glm/glm.hpp>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace IO {
+
+// Trajectory files hold a short header, then one compressed chunk per
+// CHUNK_PARTICLES pool slots of each recorded frame, then a frame table, a
+// chunk table and a fixed-size trailer at the very end. Readers seek to any
+// frame through the tables. Within a chunk the active flags and the selected
+// fields are stored as separate arrays of 32-bit words (x then y for
+// vectors, packed RGBA for colours) and compressed with EncodeWords. Every
+// slot is recorded so that a particle keeps its index across frames, which
+// lets non-key frames be encoded as deltas against the previous frame.
+enum TrajectoryField : std::uint32_t {
+  TRAJECTORY_POSITION = 1u << 0,
+  TRAJECTORY_VELOCITY = 1u << 1,
+  TRAJECTORY_COLOR = 1u << 2
+};
+
+inline constexpr std::array<char, 8> TRAJECTORY_MAGIC = {'G', 'L', 'X', 'T',
+                                                         'R', 'A', 'J', '\0'};
+inline constexpr std::uint32_t TRAJECTORY_VERSION = 1;
+
+struct TrajectoryFileHeader {
+  std::array<char, 8> magic = TRAJECTORY_MAGIC;
+  std::uint32_t version = TRAJECTORY_VERSION;
+  std::uint32_t fields = 0;
+};
+
+struct TrajectoryFrameEntry {
+  std::uint64_t step = 0;
+  double time = 0.0;
+  std::uint32_t particleCount = 0;
+  std::uint32_t firstChunk = 0;
+  std::uint32_t chunkCount = 0;
+  // Index of the key frame the delta chain starts from; equal to the
+  // frame's own index for key frames
+  std::uint32_t keyframe = 0;
+};
+
+struct TrajectoryChunkEntry {
+  std::uint64_t offset = 0;
+  std::uint32_t encodedBytes = 0;
+  std::uint32_t particleCount = 0;
+};
+
+struct TrajectoryTrailer {
+  std::uint64_t frameTableOffset = 0;
+  std::uint64_t frameCount = 0;
+  std::uint64_t chunkTableOffset = 0;
+  std::uint64_t chunkCount = 0;
+  std::array<char, 8> magic = TRAJECTORY_MAGIC;
+};
+
+enum class TrajectoryError {
+  OpenFailed,
+  BadMagic,
+  UnsupportedVersion,
+  Truncated,
+  FrameOutOfRange,
+  CorruptChunk
+};
+
+[[nodiscard]] std::string_view ToString(TrajectoryError error);
+
+struct TrajectoryOptions {
+  std::uint32_t fields = TRAJECTORY_POSITION | TRAJECTORY_VELOCITY;
+  // Frames encoded or queued for writing before SubmitFrame blocks
+  std::size_t maxFramesInFlight = 4;
+  // Every Nth frame is self-contained, bounding the decode work of a seek
+  std::uint32_t keyframeInterval = 32;
+
+  static constexpr std::size_t CHUNK_PARTICLES = 64 * 1024;
+};
+
+// Appends every submitted frame. The frame thread only copies the selected
+// fields; chunks are compressed as thread pool tasks and a writer thread
+// appends them in submission order through an AsyncWriter, so encoding and
+// disk writes overlap with the following simulation steps.
+class TrajectoryWriter {
+public:
+  explicit TrajectoryWriter(Core::ThreadPool &threadPool);
+  ~TrajectoryWriter();
+
+  TrajectoryWriter(const TrajectoryWriter &) = delete;
+  TrajectoryWriter &operator=(const TrajectoryWriter &) = delete;
+
+  bool Open(const std::filesystem::path &path,
+            const TrajectoryOptions &options = {});
+  void SubmitFrame(std::span<const Graphics::Particle> particles,
+                   std::uint64_t step, double time);
+  // Waits for queued frames and writes the index; called by the destructor
+  void Close();
+
+  [[nodiscard]] bool IsOpen() const noexcept { return file_.IsOpen(); }
+  [[nodiscard]] std::uint64_t GetRawBytes() const noexcept { return rawBytes_; }
+  [[nodiscard]] std::uint64_t GetWrittenBytes() const noexcept {
+    return writtenBytes_;
+  }
+
+private:
+  struct PendingFrame {
+    TrajectoryFrameEntry entry;
+    std::vector<std::future<std::vector<std::uint8_t>>> chunks;
+  };
+
+  // Words of one frame, copied on the frame thread in on-disk chunk order
+  struct FrameData {
+    std::size_t particleCount = 0;
+    std::vector<std::uint32_t> words;
+  };
+
+  void WriterThread();
+
+  Core::ThreadPool &threadPool_;
+  TrajectoryOptions options_;
+  AsyncWriter file_;
+
+  std::thread writer_;
+  std::mutex mutex_;
+  std::condition_variable queueChanged_;
+  std::deque<PendingFrame> queue_;
+  bool closing_ = false;
+
+  // Frame thread only: reference for the next delta frame
+  std::shared_ptr<const FrameData> previousFrame_;
+  std::uint32_t submittedFrames_ = 0;
+  std::uint32_t keyframe_ = 0;
+
+  // Owned by the writer thread until Close joins it
+  std::vector<TrajectoryFrameEntry> frames_;
+  std::vector<TrajectoryChunkEntry> chunks_;
+  std::uint64_t offset_ = 0;
+  std::atomic<std::uint64_t> rawBytes_{0};
+  std::atomic<std::uint64_t> writtenBytes_{0};
+};
+
+// One decoded frame, indexed by pool slot. Arrays for fields that were not
+// recorded are empty.
+struct TrajectoryFrame {
+  std::uint64_t step = 0;
+  double time = 0.0;
+  std::vector<std::uint8_t> active;
+  std::vector<glm::vec2> positions;
+  std::vector<glm::vec2> velocities;
+  std::vector<std::uint32_t> colors; // sf::Color::toInteger()
+};
+
+class TrajectoryReader {
+public:
+  [[nodiscard]] static std::expected<TrajectoryReader, TrajectoryError>
+  Open(const std::string &path);
+
+  [[nodiscard]] std::uint32_t GetFields() const noexcept { return fields_; }
+  [[nodiscard]] std::size_t GetFrameCount() const noexcept {
+    return frames_.size();
+  }
+  [[nodiscard]] const TrajectoryFrameEntry &GetFrameEntry(std::size_t index) const {
+    return frames_[index];
+  }
+
+  // Delta frames are decoded forward from their key frame; reading frames
+  // in order reuses the previous result, so playback decodes each frame once
+  [[nodiscard]] std::expected<TrajectoryFrame, TrajectoryError>
+  ReadFrame(std::size_t index);
+
+private:
+  bool DecodeFrameWords(std::size_t index,
+                        std::span<const std::uint32_t> reference,
+                        std::vector<std::uint32_t> &words) const;
+
+  MappedFile file_;
+  std::uint32_t fields_ = 0;
+  std::vector<TrajectoryFrameEntry> frames_;
+  std::vector<TrajectoryChunkEntry> chunks_;
+
+  std::vector<std::uint32_t> lastWords_;
+  std::size_t lastIndex_ = static_cast<std::size_t>(-1);
+};
+
+} // namespace IO
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace IO {
+
+// Lossless codec for arrays of 32-bit words (float bit patterns, packed
+// colours). Given a reference block of the same size (the same particles one
+// recorded frame earlier) each word is replaced by its zigzag-encoded
+// difference from the reference, which leaves the high bytes mostly zero
+// for slowly moving particles. The words are then split into four byte
+// planes and compressed with a small LZ77 coder using the LZ4 sequence
+// layout. Blocks that do not shrink are stored as shuffled bytes instead.
+[[nodiscard]] std::vector<std::uint8_t>
+EncodeWords(std::span<const std::uint32_t> words,
+            std::span<const std::uint32_t> reference = {});
+
+// reference must be the block passed to EncodeWords. Returns false if the
+// block is corrupt or does not decode to exactly words.size() words.
+[[nodiscard]] bool DecodeWords(std::span<const std::uint8_t> encoded,
+                               std::span<std::uint32_t> words,
+                               std::span<const std::uint32_t> reference = {});
+
+} // namespace IO
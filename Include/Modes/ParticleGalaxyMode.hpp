@@ -1,24 +1,33 @@
 #pragma once
 
+#include "Analysis/ClusterFinder.hpp"
+#include "Analysis/ProfileAnalyzer.hpp"
+#include "Audio/AudioAnalyzer.hpp"
+#include "Audio/Sonifier.hpp"
+#include "Core/Camera2D.hpp"
+#include "Core/ExecutionBackend.hpp"
 #include "Core/ThreadPool.hpp"
 #include "Core/VisualMode.hpp"
 #include "Graphics/ParticleSystem.hpp"
+#include "Graphics/Starfield.hpp"
+#include "IO/Checkpoint.hpp"
+#include "IO/Trajectory.hpp"
 #include "Input/InputManager.hpp"
+#include "Physics/DirectSummation.hpp"
+#include "Physics/GravityKernels.hpp"
+#include "Physics/ParticleLOD.hpp"
+#include "Physics/PhysicsEngine.hpp"
+#include "Physics/SpatialHash.hpp"
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace Modes {
 
-struct CelestialBody {
-  glm::vec2 position;
-  glm::vec2 velocity;
-  float mass;
-  float radius;
-  sf::Color color;
-  std::vector<glm::vec2> trail;
-  static constexpr std::size_t MAX_TRAIL_LENGTH = 50;
-};
+using CelestialBody = Physics::CelestialBody;
 
 class ParticleGalaxyMode : public Core::VisualMode {
 public:
@@ -28,7 +37,9 @@ public:
   void Initialize() override;
   void Update(float deltaTime) override;
   void Render(sf::RenderTarget &target) override;
+  void RenderHUD(sf::RenderTarget &target) override;
   void HandleInput(const Core::InputEvent &event) override;
+  void OnResize(unsigned int width, unsigned int height) override;
 
   [[nodiscard]] std::string GetName() const override {
     return "Particle Galaxy";
@@ -39,44 +50,230 @@ public:
 
   void OnActivate() override;
   void OnDeactivate() override;
+
+  [[nodiscard]] Core::TraceContext GetTraceContext() const override;
+
+  // Paused with no background analysis in flight
+  [[nodiscard]] bool IsIdle() const override;
   
   void EnableDemoMode() { demoMode_ = true; }
 
+  // Fixed timestep and periodic state hashes for regression runs. Together
+  // with a fixed seed, runs are bit-identical across thread counts.
+  void EnableDeterministicMode() { deterministic_ = true; }
+
+  // Backend for the particle passes (physics, vertices, state hash)
+  void SetExecutionBackend(Core::ExecutionBackendType type);
+
+  // One pass per chunk for physics, particle update and quad generation
+  // instead of three passes over the particle array
+  void SetFusedPipeline(bool enabled);
+
+  // How stars are drawn; see Graphics::ParticleRenderBackend
+  void SetParticleRenderer(Graphics::ParticleRenderBackendType type);
+  // Times every renderer on the current scene at the window size and keeps
+  // the fastest
+  void SelectFastestParticleRenderer();
+
+  // Scalar precision of the simulation state; see Physics::Precision
+  void SetPrecision(Physics::Precision precision);
+
+  // Star-star force solver on top of the massive bodies; false when the
+  // solver is not available
+  bool SetSolver(Physics::SolverType type);
+
+  // Stars outside the view step only every interval-th frame; 1 turns it
+  // off. See Physics::PhysicsEngine::SetTemporalLOD.
+  void SetTemporalLOD(std::uint32_t interval);
+
+  // Reseeds preset generation and rebuilds the current preset
+  void SetSeed(std::uint32_t seed);
+
+  // Order-independent of the worker count; see Physics/GravityKernels.hpp
+  [[nodiscard]] std::uint64_t ComputeStateHash() const;
+
+  static constexpr std::uint32_t DEFAULT_SEED = 20240601;
+
+  // Replaces the scene with stars from a CSV/TSV/binary catalog, placed
+  // relative to the window centre around a central black hole.
+  bool LoadCatalog(const std::string &path);
+
+  // Streams radial profiles to a CSV file while the simulation runs
+  bool EnableAnalysisCsv(const std::string &path);
+
+  // Copies the full simulation state and writes it on a background thread
+  bool SaveCheckpoint(const std::string &path);
+  // Maps a checkpoint file and resumes the simulation from it
+  bool RestoreCheckpoint(const std::string &path);
+  // File used by the F5 (save) and F9 (restore) keys
+  void SetCheckpointPath(const std::string &path) { checkpointPath_ = path; }
+
+  // Records every interval-th step to a compressed trajectory file
+  bool EnableTrajectoryOutput(const std::string &path, std::uint64_t interval,
+                              bool includeColors);
+
+  // Drives time dilation and gravity from live audio: "mic" captures the
+  // default input device, anything else is played as a music file
+  bool EnableAudio(const std::string &source);
+  // Plays the massive bodies' orbits as tones and their close encounters as
+  // transients; bufferFrames trades latency for robustness
+  void EnableSonification(std::size_t bufferFrames);
+
 private:
   void CreateGalaxyPreset(int preset);
   void AddMassiveObject(const glm::vec2 &position);
+  void UpdateBackgroundAnalysis(float deltaTime);
+  void RenderAnalysisOverlay(sf::RenderTarget &target);
+  void UpdateLevelOfDetail(float deltaTime);
+  void RenderSuperParticles(sf::RenderTarget &target);
+  [[nodiscard]] const CelestialBody *GetDominantBody() const;
   void UpdatePhysics(float deltaTime);
-  void UpdateParticlePhysics(std::size_t start, std::size_t end,
-                             float deltaTime);
+  void UpdateAudioReactivity(float deltaTime);
+  void UpdateSonification();
 
-  glm::vec2 CalculateGravitationalForce(const glm::vec2 &pos1,
-                                        const glm::vec2 &pos2, float mass1,
-                                        float mass2) const;
+  void ResetCamera();
+  // Rebuilds the spatial hash if the pool changed or it is more than maxAge
+  // steps old
+  void EnsureSpatialHash(std::uint64_t maxAge = 0);
+  void InvalidateSpatialHash();
+  [[nodiscard]] std::optional<std::uint32_t>
+  PickStar(const glm::vec2 &screenPosition, std::uint64_t maxAge = 0);
+  [[nodiscard]] std::string DescribeStar(std::uint32_t index) const;
+  void ApplyBrush(float deltaTime);
+
+  [[nodiscard]] std::vector<CelestialBody> &GetBodies() {
+    return physicsEngine_->GetBodies();
+  }
+  [[nodiscard]] const std::vector<CelestialBody> &GetBodies() const {
+    return physicsEngine_->GetBodies();
+  }
 
 private:
-  std::unique_ptr<Graphics::ParticleSystem> particleSystem_;
   std::unique_ptr<Core::ThreadPool> threadPool_;
-
-  std::vector<CelestialBody> massiveObjects_;
+  // Owns the particles and bodies; particleSystem_ points into it
+  std::unique_ptr<Physics::PhysicsEngine> physicsEngine_;
+  Graphics::ParticleSystem *particleSystem_ = nullptr;
+  // Workers kept free for frame-critical tasks on larger machines
+  static constexpr std::size_t RESERVED_FRAME_WORKERS = 1;
+  static constexpr std::size_t MIN_THREADS_TO_RESERVE = 4;
+  std::unique_ptr<Core::ExecutionBackend> executionBackend_;
 
   float timeDilation_ = 1.0f;
-  float gravitationalConstant_ = 100.0f;
+  static constexpr float GRAVITATIONAL_CONSTANT = 100.0f;
   bool paused_ = false;
 
   int currentPreset_ = 0;
   static constexpr int NUM_PRESETS = 5;
 
+  std::string catalogPath_;
+  bool catalogLoaded_ = false;
+  static constexpr float CATALOG_CENTRAL_MASS = 30000.0f;
+
+  // Presets are generated from seed_ + preset, so a seed reproduces them
+  std::uint32_t seed_;
   std::mt19937 rng_;
 
-  // Spatial partitioning for optimization
-  struct QuadTreeNode;
-  std::unique_ptr<QuadTreeNode> quadTree_;
+  bool deterministic_ = false;
+  std::uint64_t stepCount_ = 0;
+  static constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+  static constexpr std::uint64_t HASH_LOG_INTERVAL = 60;
+  static constexpr std::size_t PHYSICS_CHUNK_SIZE = 4096;
+  static constexpr std::size_t MAX_PARTICLES = 30000;
+
+  // Registered with physicsEngine_, which owns it; kept for its statistics
+  Physics::DirectSummation *directSummation_ = nullptr;
 
   // Visual settings
   bool showTrails_ = true;
   bool showGrid_ = false;
+  // Procedural background stars, generated on the pool behind the camera
+  std::unique_ptr<Graphics::Starfield> starfield_;
+  bool showStarfield_ = true;
   float particleSize_ = 1.0f;
+  sf::Font font_;
+  bool fontLoaded_ = false;
   
+  // Friends-of-friends clump detection, refreshed in the background
+  std::unique_ptr<Analysis::ClusterFinder> clusterFinder_;
+  bool showClusters_ = false;
+  float clusterTimer_ = 0.0f;
+  static constexpr float CLUSTER_INTERVAL = 3.0f;
+  static constexpr std::size_t MAX_CLUSTER_LABELS = 32;
+
+  // Radial profiles and rotation curves around the dominant body
+  std::unique_ptr<Analysis::ProfileAnalyzer> profileAnalyzer_;
+  bool showAnalysis_ = false;
+  bool streamAnalysis_ = false;
+  float analysisTimer_ = 0.0f;
+  double simulationTime_ = 0.0;
+  static constexpr float ANALYSIS_INTERVAL = 1.0f;
+
+  // Off-screen particles merged into super-particles
+  std::unique_ptr<Physics::ParticleLOD> particleLOD_;
+  bool lodEnabled_ = false;
+  float lodTimer_ = 0.0f;
+  sf::VertexArray superParticleVertices_{sf::PrimitiveType::Quads};
+
+  // View, star picking and force brushes. The spatial hash is rebuilt
+  // lazily, when a pick or brush needs it after particles moved; hover
+  // tolerates a hash a few steps old so moving the mouse over a running
+  // simulation does not rebuild it every frame.
+  enum class Brush { Off, Attract, Repel, Swirl };
+  Core::Camera2D camera_;
+  std::unique_ptr<Physics::SpatialHash> spatialHash_;
+  bool spatialHashValid_ = false;
+  std::uint64_t spatialHashStep_ = 0; // stepCount_ at the last build
+  std::optional<std::uint32_t> hoveredStar_;
+  std::optional<std::uint32_t> selectedStar_;
+  glm::vec2 cursor_{0.0f, 0.0f}; // Screen pixels
+  bool panning_ = false;
+  Brush brush_ = Brush::Off;
+  bool brushHeld_ = false;
+  std::vector<std::uint32_t> brushHits_;
+  static constexpr float PICK_RADIUS = 8.0f;      // Screen pixels
+  static constexpr std::uint64_t HOVER_HASH_MAX_AGE = 8; // Steps
+  static constexpr float BRUSH_RADIUS = 60.0f;    // Screen pixels
+  static constexpr float BRUSH_STRENGTH = 400.0f; // Acceleration at centre
+  static constexpr float LOD_INTERVAL = 0.25f;
+  static constexpr float LOD_MARGIN = 50.0f;
+  // Temporal LOD interval restored by the V key, and the band around the
+  // view (as a fraction of its size) that still steps every frame
+  std::uint32_t temporalInterval_ = 4;
+  static constexpr float TEMPORAL_LOD_MARGIN = 0.25f;
+
+  // Checkpoints. The state buffer is refilled once the writer is idle, so
+  // repeated checkpoints don't reallocate the particle copy.
+  std::unique_ptr<IO::CheckpointWriter> checkpointWriter_;
+  std::shared_ptr<IO::CheckpointState> checkpointState_;
+  std::string checkpointPath_ = "galaxy.ckpt";
+
+  // Compressed on the thread pool, so declared after it
+  std::unique_ptr<IO::TrajectoryWriter> trajectoryWriter_;
+  std::uint64_t trajectoryInterval_ = 10;
+
+  // Audio reactivity. Bass stretches time, onsets pulse the gravity of the
+  // massive bodies; both relax back to 1 when the audio goes quiet.
+  std::unique_ptr<Audio::AudioAnalyzer> audioAnalyzer_;
+  Audio::AudioFeatures audioFeatures_;
+  float audioPulse_ = 0.0f;
+  float audioTimeScale_ = 1.0f;
+  float audioGravityScale_ = 1.0f;
+  static constexpr float AUDIO_TIME_GAIN = 0.75f;
+  static constexpr float AUDIO_GRAVITY_GAIN = 0.5f;
+  static constexpr float AUDIO_PULSE_DECAY = 4.0f; // Per second
+
+  // Sonification. Orbital angular velocity relative to that of a circular
+  // orbit at SONIFY_REFERENCE_RADIUS around the dominant body sets pitch.
+  std::unique_ptr<Audio::Sonifier> sonifier_;
+  Audio::SonifierParameters sonifierParameters_;
+  bool inEncounter_ = false;
+  static constexpr float SONIFY_DRONE_PITCH = 55.0f;
+  static constexpr float SONIFY_BASE_PITCH = 220.0f;
+  static constexpr float SONIFY_REFERENCE_RADIUS = 200.0f;
+  // Encounter when bodies come within this many times their summed radii
+  static constexpr float ENCOUNTER_RADII = 3.0f;
+  static constexpr float ENCOUNTER_SPEED = 200.0f; // Full-strength transient
+
   // Demo mode
   bool demoMode_ = false;
   float demoTimer_ = 0.0f;
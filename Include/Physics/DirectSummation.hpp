@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include "Physics/ForceSolver.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Physics {
+
+struct DirectSummationStats {
+  std::size_t bodies = 0;
+  double seconds = 0.0;
+  double gflops = 0.0; // Floating-point operations actually executed
+};
+
+// Exact O(N^2) gravity between all active particles, for small systems and
+// as a reference for approximate solvers. Bodies are copied to
+// structure-of-arrays tiles sized so an i tile and a j tile stay in L1.
+// Only tile pairs with i <= j are evaluated; each interaction updates both
+// bodies (Newton's third law), accumulating into one force buffer per work
+// lane that is merged afterwards. Lanes are a fixed count with a fixed
+// share of the tile pairs and sum in a fixed order, so results do not
+// depend on the number of workers.
+class DirectSummation : public ForceSolver {
+public:
+  // Plummer softening length squared, matching the minimum distance the
+  // massive-body kernels clamp to
+  static constexpr float DEFAULT_SOFTENING_SQ = 10.0f;
+  // Counted per pair: 2 sub, 4 for r^2, sqrt, div, 2 for r^-3 and 5 per body
+  static constexpr double FLOPS_PER_PAIR = 20.0;
+  // Active stars above which the engine skips the kick
+  static constexpr std::size_t PARTICLE_LIMIT = 20000;
+
+  explicit DirectSummation(Core::ThreadPool &threadPool,
+                           float softeningSq = DEFAULT_SOFTENING_SQ);
+
+  // Writes the acceleration of every particle (zero when inactive)
+  DirectSummationStats
+  ComputeAccelerations(std::span<const Graphics::Particle> particles,
+                       float gravitationalConstant,
+                       std::span<glm::vec2> accelerations);
+
+  [[nodiscard]] SolverType GetType() const override {
+    return SolverType::Direct;
+  }
+  [[nodiscard]] std::size_t GetParticleLimit() const override {
+    return PARTICLE_LIMIT;
+  }
+
+  // Velocity kick of deltaTime from the mutual attraction of the particles;
+  // timings in GetLastStats
+  void Kick(std::span<Graphics::Particle> particles,
+            float gravitationalConstant, float deltaTime) override;
+  void Kick(std::span<Graphics::Particle> particles,
+            std::span<glm::dvec2> velocities, float gravitationalConstant,
+            float deltaTime) override;
+
+  [[nodiscard]] const DirectSummationStats &GetLastStats() const noexcept {
+    return lastStats_;
+  }
+
+private:
+  // 256 bodies x 5 floats (x, y, mass, two accumulators) is 5 KB per tile
+  static constexpr std::size_t TILE_SIZE = 256;
+  static constexpr std::size_t SIMD_LANES = 8;
+  static constexpr std::size_t WORK_LANES = 16;
+
+  void InteractTiles(std::size_t tileI, std::size_t tileJ, float *forceX,
+                     float *forceY) const;
+
+  Core::ThreadPool &threadPool_;
+  float softeningSq_;
+
+  // Padded to whole tiles with massless bodies
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> mass_;
+  std::vector<std::uint32_t> indices_; // Particle index per packed body
+  std::size_t bodyCount_ = 0;
+  // WORK_LANES force buffers, each x_.size() long
+  std::vector<float> laneForceX_;
+  std::vector<float> laneForceY_;
+  std::vector<glm::vec2> accelerations_;
+
+  DirectSummationStats lastStats_;
+};
+
+} // namespace Physics
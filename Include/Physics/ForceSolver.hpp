@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Physics {
+
+// Star-star gravity model, picked at runtime. MassiveBodies has no
+// star-star term at all: stars only feel the massive bodies, which every
+// solver includes. The others are slots filled by registering a
+// ForceSolver with the PhysicsEngine.
+enum class SolverType { MassiveBodies, Direct, Tree, Grid };
+inline constexpr std::size_t SOLVER_TYPE_COUNT = 4;
+
+[[nodiscard]] std::string ToString(SolverType type);
+[[nodiscard]] std::optional<SolverType> ParseSolver(std::string_view name);
+
+// Mutual attraction of the particles, applied on top of the massive bodies'
+// field as a velocity kick before the particles are advanced
+class ForceSolver {
+public:
+  virtual ~ForceSolver() = default;
+
+  [[nodiscard]] virtual SolverType GetType() const = 0;
+  // Active particle count above which the engine skips the solver (0 for no
+  // limit)
+  [[nodiscard]] virtual std::size_t GetParticleLimit() const { return 0; }
+
+  virtual void Kick(std::span<Graphics::Particle> particles,
+                    float gravitationalConstant, float deltaTime) = 0;
+  // Accurate runs: the kick lands on the double velocities, which run
+  // parallel to particles and are in sync with them, and particles receive
+  // the rounded result
+  virtual void Kick(std::span<Graphics::Particle> particles,
+                    std::span<glm::dvec2> velocities,
+                    float gravitationalConstant, float deltaTime) = 0;
+};
+
+} // namespace Physics
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Physics {
+
+// Scalar type of the simulation state, chosen per run. Fast keeps
+// everything in float. Mixed integrates the massive bodies (few, and the
+// source of every tracer's force) in double and the tracers in float.
+// Accurate keeps the tracers in double as well and mirrors them into the
+// float particles for rendering.
+enum class Precision { Fast, Mixed, Accurate };
+
+[[nodiscard]] std::string ToString(Precision precision);
+[[nodiscard]] std::optional<Precision> ParsePrecision(std::string_view name);
+
+template <typename Scalar> using Vec2 = glm::vec<2, Scalar>;
+
+template <typename Scalar> struct BasicGravitySource {
+  Vec2<Scalar> position;
+  Scalar mass;
+};
+using GravitySource = BasicGravitySource<float>;
+
+template <typename Scalar> struct BodyState {
+  Vec2<Scalar> position;
+  Vec2<Scalar> velocity;
+  Scalar mass;
+};
+
+// Simulation kernels that must give bit-identical results on every machine.
+// This translation unit is compiled with FMA contraction disabled (see
+// DETERMINISTIC_SOURCES in CMakeLists.txt) and every kernel works on one
+// particle at a time, so the result does not depend on how the range is
+// chunked. Templates are instantiated here for float and double.
+
+template <typename Scalar>
+[[nodiscard]] Vec2<Scalar> GravitationalForce(const Vec2<Scalar> &pos1,
+                                              const Vec2<Scalar> &pos2,
+                                              Scalar mass1, Scalar mass2,
+                                              Scalar gravitationalConstant);
+
+// Kick-drift step for the massive bodies under each other's gravity. Bodies
+// are updated in order and later bodies see the earlier ones' new positions.
+template <typename Scalar>
+void AdvanceBodies(std::span<BodyState<Scalar>> bodies,
+                   Scalar gravitationalConstant, Scalar deltaTime);
+
+// Kick-drift step for particles under a set of point masses. Particles that
+// move further than maxDistance from center are deactivated.
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<const GravitySource> sources,
+                      float gravitationalConstant, float deltaTime,
+                      const glm::vec2 &center, float maxDistance);
+
+// The same step on double tracer state. positions and velocities run
+// parallel to particles, which receive the rounded result. A particle whose
+// float state no longer matches its rounded double state was changed
+// elsewhere (spawned, recycled, brushed, restored) and is reloaded from
+// float first.
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<glm::dvec2> positions,
+                      std::span<glm::dvec2> velocities,
+                      std::span<const BasicGravitySource<double>> sources,
+                      double gravitationalConstant, double deltaTime,
+                      const glm::dvec2 &center, double maxDistance);
+
+// Reloads the double state of every active particle changed elsewhere, for
+// passes that work on the double state before the kernel does
+void SyncTracers(std::span<const Graphics::Particle> particles,
+                 std::span<glm::dvec2> positions,
+                 std::span<glm::dvec2> velocities);
+
+// Per-particle variants for deferred updates: particle i advances by
+// stepTimes[i] and is left untouched when that is zero
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<const float> stepTimes,
+                      std::span<const GravitySource> sources,
+                      float gravitationalConstant, const glm::vec2 &center,
+                      float maxDistance);
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<const float> stepTimes,
+                      std::span<glm::dvec2> positions,
+                      std::span<glm::dvec2> velocities,
+                      std::span<const BasicGravitySource<double>> sources,
+                      double gravitationalConstant, const glm::dvec2 &center,
+                      double maxDistance);
+
+// FNV-1a over the bit patterns of active particle state
+[[nodiscard]] std::uint64_t
+HashParticleState(std::span<const Graphics::Particle> particles);
+[[nodiscard]] std::uint64_t HashFloats(std::uint64_t seed,
+                                       std::span<const float> values);
+
+[[nodiscard]] std::uint64_t CombineHashes(std::uint64_t seed,
+                                          std::uint64_t value);
+
+} // namespace Physics
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <glm/glm.hpp>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Physics {
+
+// Compact particle record for out-of-core runs (20 bytes instead of the
+// render-side Graphics::Particle)
+struct StreamedParticle {
+  glm::vec2 position{0.0f, 0.0f};
+  glm::vec2 velocity{0.0f, 0.0f};
+  float mass = 0.0f;
+};
+
+inline constexpr std::array<char, 8> OUT_OF_CORE_MAGIC = {'G', 'L', 'X', 'O',
+                                                          'O', 'C', '\0', '\0'};
+inline constexpr std::uint32_t OUT_OF_CORE_VERSION = 1;
+
+struct OutOfCoreHeader {
+  std::array<char, 8> magic = OUT_OF_CORE_MAGIC;
+  std::uint32_t version = OUT_OF_CORE_VERSION;
+  std::uint32_t blockCount = 0;
+  std::uint64_t particleCount = 0;
+  std::uint64_t step = 0;
+  double time = 0.0;
+  float centralMass = 0.0f;
+  float gravitationalConstant = 0.0f;
+  std::uint64_t dataOffset = 0; // Page aligned
+};
+
+// Resident summary of one block, refreshed on every pass
+struct OutOfCoreBlock {
+  std::uint64_t firstParticle = 0;
+  std::uint64_t particleCount = 0;
+  glm::vec2 centerOfMass{0.0f, 0.0f};
+  float mass = 0.0f;
+  float extent = 0.0f; // RMS distance of members from the centre of mass
+  glm::vec2 boundsMin{0.0f, 0.0f};
+  glm::vec2 boundsMax{0.0f, 0.0f};
+};
+
+struct OutOfCoreSettings {
+  // New files only: exponential disk around a central mass at the origin
+  std::uint64_t particleCount = 10'000'000;
+  std::size_t blockParticles = 1 << 20; // Rounded to whole pages
+  float diskRadius = 10000.0f;
+  float diskMass = 50000.0f;
+  float centralMass = 100000.0f;
+  float gravitationalConstant = 100.0f;
+  std::uint32_t seed = 1;
+
+  float timeStep = 1.0f / 60.0f;
+  // Blocks paged in ahead of the one being integrated
+  std::size_t readAheadBlocks = 2;
+  // Far-field grid resolution per axis
+  std::size_t fieldResolution = 128;
+};
+
+struct OutOfCoreStepStats {
+  double seconds = 0.0;
+  double particlesPerSecond = 0.0;
+};
+
+// Simulation of particle sets larger than RAM. Particles live in a
+// memory-mapped file, split into blocks that are spatially sorted (Morton
+// order of a grid over the disk) when the file is created. Each step
+// streams the blocks through the kernel one at a time: a read-ahead thread
+// faults in the next blocks while the pool integrates the current one, and
+// finished blocks are scheduled for write-back and dropped from the
+// process. The central mass is summed exactly. The disk acts through an
+// acceleration grid computed from the mass each block deposited on the
+// grid during the previous pass, so self-gravity is resolved down to one
+// grid cell and there is no separate near-field term: the disk is treated
+// as collisionless. Blocks are not re-sorted as the disk shears; that only
+// costs read locality, since forces do not depend on block membership.
+class OutOfCoreSimulation {
+public:
+  OutOfCoreSimulation(Core::ThreadPool &threadPool,
+                      const OutOfCoreSettings &settings);
+  ~OutOfCoreSimulation();
+
+  OutOfCoreSimulation(const OutOfCoreSimulation &) = delete;
+  OutOfCoreSimulation &operator=(const OutOfCoreSimulation &) = delete;
+
+  // Generates settings.particleCount particles into a new file
+  bool Create(const std::filesystem::path &path);
+  // Resumes a file written by Create or a previous run
+  bool Open(const std::filesystem::path &path);
+  void Close();
+
+  OutOfCoreStepStats Step();
+  // Runs steps and logs throughput; returns the mean particles per second
+  double Run(std::uint64_t steps);
+
+  [[nodiscard]] std::uint64_t GetParticleCount() const noexcept {
+    return header_ ? header_->particleCount : 0;
+  }
+  [[nodiscard]] std::uint64_t GetStep() const noexcept {
+    return header_ ? header_->step : 0;
+  }
+  [[nodiscard]] std::span<const OutOfCoreBlock> GetBlocks() const noexcept {
+    return blocks_;
+  }
+
+private:
+  bool Map(const std::filesystem::path &path, std::uint64_t bytes,
+           bool create);
+  [[nodiscard]] std::span<StreamedParticle>
+  GetBlockParticles(std::size_t block) const;
+  void GenerateDisk();
+  // Summarizes the block, after a kick-drift step when advance is set, and
+  // adds its mass to the grid unless mass is null
+  OutOfCoreBlock IntegrateBlock(std::size_t block, bool advance,
+                                std::vector<double> *mass);
+  void DepositMass(std::span<const StreamedParticle> particles,
+                   std::vector<double> &mass);
+  // Streams every block through IntegrateBlock, depositing on the current
+  // lattice; returns the new summaries
+  std::vector<OutOfCoreBlock> StreamBlocks(bool advance);
+  // Grid bounds from the block summaries
+  void BuildLattice();
+  void BuildFarField();
+  [[nodiscard]] glm::vec2 FarFieldAt(const glm::vec2 &position) const;
+  [[nodiscard]] glm::vec2 DirectFarField(const glm::vec2 &position) const;
+
+  void RequestReadAhead(std::size_t block);
+  void ReadAheadThread();
+  void ReleaseBlock(std::size_t block);
+
+  Core::ThreadPool &threadPool_;
+  OutOfCoreSettings settings_;
+
+  int fd_ = -1;
+  char *mapping_ = nullptr;
+  std::uint64_t mappingSize_ = 0;
+  OutOfCoreHeader *header_ = nullptr;
+  std::span<OutOfCoreBlock> blocks_;
+
+  // Far-field acceleration at grid nodes over fieldMin_..fieldMax_
+  std::vector<glm::vec2> field_;
+  glm::vec2 fieldMin_{0.0f, 0.0f};
+  glm::vec2 fieldMax_{0.0f, 0.0f};
+  glm::vec2 fieldCell_{1.0f, 1.0f};
+
+  // Disk mass on the nodes of the previous pass's lattice
+  struct MassSource {
+    glm::vec2 position;
+    float mass;
+  };
+  std::vector<double> massGrid_;
+  std::vector<double> nextMassGrid_;
+  std::vector<float> laneMass_;
+  glm::vec2 massMin_{0.0f, 0.0f};
+  glm::vec2 massCell_{1.0f, 1.0f};
+  bool massGridValid_ = false;
+  std::vector<MassSource> sources_;
+  float sourceSofteningSq_ = 1.0f;
+
+  std::thread readAheadThread_;
+  std::mutex readAheadMutex_;
+  std::condition_variable readAheadChanged_;
+  std::deque<std::size_t> readAheadQueue_;
+  bool stopReadAhead_ = false;
+  // Blocks before this one are done for the current pass
+  std::atomic<std::size_t> streamPosition_{0};
+};
+
+} // namespace Physics
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Physics {
+
+// Region where full per-particle detail is wanted: inside the visible
+// rectangle and within focusRadius of the focus point.
+struct InterestRegion {
+  glm::vec2 visibleMin{0.0f, 0.0f};
+  glm::vec2 visibleMax{0.0f, 0.0f};
+  glm::vec2 focus{0.0f, 0.0f};
+  float focusRadius = 0.0f;
+
+  [[nodiscard]] bool Contains(const glm::vec2 &position,
+                              float padding = 0.0f) const {
+    glm::vec2 d = position - focus;
+    float radius = focusRadius + padding;
+    return position.x >= visibleMin.x - padding &&
+           position.y >= visibleMin.y - padding &&
+           position.x <= visibleMax.x + padding &&
+           position.y <= visibleMax.y + padding && glm::dot(d, d) <= radius * radius;
+  }
+};
+
+// A group of particles integrated as one body. Members keep their offsets
+// from the group's centre of mass and mean velocity so they can be restored
+// exactly when the group is split.
+struct SuperParticle {
+  glm::vec2 position{0.0f, 0.0f}; // Centre of mass
+  glm::vec2 velocity{0.0f, 0.0f}; // Mass-weighted mean velocity
+  float mass = 0.0f;
+  float extent = 0.0f;            // RMS member distance from the centre
+  glm::vec2 momentXXYY{0.0f, 0.0f}; // Second moments of member offsets
+  float momentXY = 0.0f;
+  sf::Color color;
+  std::uint32_t firstMember = 0;
+  std::uint32_t memberCount = 0;
+};
+
+struct LODSettings {
+  float cellSize = 40.0f;        // Grouping grid spacing in world units
+  std::size_t minGroupSize = 4;  // Smaller groups stay as particles
+};
+
+// Simulation level of detail. Particles outside the interest region are
+// merged per grid cell into mass-weighted super-particles; super-particles
+// that drift back into the region are split into their members again.
+class ParticleLOD {
+public:
+  explicit ParticleLOD(Core::ThreadPool &threadPool);
+
+  void SetSettings(const LODSettings &settings) { settings_ = settings; }
+
+  // Splits groups that entered the region, then merges particles outside it
+  void Refresh(std::span<Graphics::Particle> particles,
+               const InterestRegion &region);
+
+  // Restores every member, e.g. before the LOD is switched off
+  void SplitAll(std::span<Graphics::Particle> particles);
+
+  // Forgets all groups without touching particles (after a scene reset)
+  void Reset();
+
+  template <typename AccelerationFn>
+  void Integrate(float deltaTime, AccelerationFn &&accelerationAt) {
+    for (auto &group : superParticles_) {
+      group.velocity += accelerationAt(group.position) * deltaTime;
+      group.position += group.velocity * deltaTime;
+    }
+  }
+
+  [[nodiscard]] const std::vector<SuperParticle> &GetSuperParticles() const {
+    return superParticles_;
+  }
+  [[nodiscard]] std::size_t GetMergedParticleCount() const {
+    return members_.size();
+  }
+
+private:
+  struct Member {
+    std::uint32_t particleIndex;
+    glm::vec2 positionOffset;
+    glm::vec2 velocityOffset;
+  };
+
+  void Split(std::span<Graphics::Particle> particles,
+             const SuperParticle &group);
+  void Merge(std::span<Graphics::Particle> particles,
+             const InterestRegion &region);
+
+private:
+  Core::ThreadPool &threadPool_;
+  LODSettings settings_;
+
+  std::vector<SuperParticle> superParticles_;
+  std::vector<Member> members_;
+
+  static constexpr std::size_t CHUNK_SIZE = 16384;
+};
+
+} // namespace Physics
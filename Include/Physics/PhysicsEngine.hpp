@@ -1,13 +1,206 @@
 #pragma once
 
+#include "Graphics/ParticleSystem.hpp"
+#include "Physics/ForceSolver.hpp"
+#include "Physics/GravityKernels.hpp"
+#include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Core {
+class ExecutionBackend;
+class ThreadPool;
+} // namespace Core
 
 namespace Physics {
 
+struct CelestialBody {
+  glm::vec2 position;
+  glm::vec2 velocity;
+  float mass;
+  float radius;
+  sf::Color color;
+  std::vector<glm::vec2> trail;
+  static constexpr std::size_t MAX_TRAIL_LENGTH = 50;
+};
+
+// Wall time of the stages of the last step
+struct PhysicsStepTiming {
+  double bodySeconds = 0.0;     // Massive bodies under each other
+  double solverSeconds = 0.0;   // Star-star forces
+  double particleSeconds = 0.0; // Stars under the bodies, then drift
+  [[nodiscard]] double GetTotalSeconds() const {
+    return bodySeconds + solverSeconds + particleSeconds;
+  }
+};
+
+// Running averages over the steps a solver was active for, so solvers can
+// be compared on the live scene
+struct SolverTiming {
+  double averageStepSeconds = 0.0;
+  double averageSolverSeconds = 0.0;
+  std::uint64_t steps = 0;
+};
+
+// Owns the simulation state (particles and massive bodies), steps it with
+// a kick-drift integrator and delegates star-star forces to the active
+// ForceSolver. Modes keep rendering and interaction; anything that moves
+// stars or bodies goes through here.
 class PhysicsEngine {
 public:
-  PhysicsEngine() = default;
-  ~PhysicsEngine() = default;
+  PhysicsEngine(Core::ThreadPool &threadPool, std::size_t maxParticles);
+  ~PhysicsEngine();
+
+  PhysicsEngine(const PhysicsEngine &) = delete;
+  PhysicsEngine &operator=(const PhysicsEngine &) = delete;
+
+  [[nodiscard]] Graphics::ParticleSystem &GetParticleSystem() noexcept {
+    return *particleSystem_;
+  }
+  [[nodiscard]] const Graphics::ParticleSystem &
+  GetParticleSystem() const noexcept {
+    return *particleSystem_;
+  }
+  [[nodiscard]] std::vector<CelestialBody> &GetBodies() noexcept {
+    return bodies_;
+  }
+  [[nodiscard]] const std::vector<CelestialBody> &GetBodies() const noexcept {
+    return bodies_;
+  }
+
+  // Particle passes run on this backend (also handed to the particle
+  // system); serial when none is set
+  void SetExecutionBackend(Core::ExecutionBackend *backend);
+
+  // Scalar precision of the state; the double copies are rebuilt from the
+  // float view on the next step
+  void SetPrecision(Precision precision);
+  [[nodiscard]] Precision GetPrecision() const noexcept { return precision_; }
+
+  void SetGravitationalConstant(float gravitationalConstant) {
+    gravitationalConstant_ = gravitationalConstant;
+  }
+  [[nodiscard]] float GetGravitationalConstant() const noexcept {
+    return gravitationalConstant_;
+  }
+  // Scales the bodies' pull on the stars, not on each other
+  void SetBodyMassScale(float scale) { bodyMassScale_ = scale; }
+
+  // Stars farther than maxDistance from center are deactivated
+  void SetBounds(const glm::vec2 &center, float maxDistance) {
+    boundsCenter_ = center;
+    maxDistance_ = maxDistance;
+  }
+
+  // Fused pipeline: each chunk of stars is advanced, updated by the
+  // particle system and written out as quads in one go (see
+  // Graphics::ParticleSystem::BeginFusedFrame). Only the quads render
+  // backend can draw fused vertices; with any other the passes stay apart.
+  void SetFusedPipeline(bool enabled) { fusedPipeline_ = enabled; }
+  [[nodiscard]] bool IsFusedPipeline() const noexcept {
+    return fusedPipeline_;
+  }
+
+  // Temporal level of detail: stars outside the view region step only every
+  // interval-th step, in staggered groups, with the time they missed, and
+  // immediately once they are back in view. An interval of 1 steps every
+  // star every step (off).
+  void SetTemporalLOD(std::uint32_t interval);
+  [[nodiscard]] std::uint32_t GetTemporalLOD() const noexcept {
+    return temporalInterval_;
+  }
+  // World rectangle (margin included) whose stars always step
+  void SetViewRegion(const glm::vec2 &min, const glm::vec2 &max) {
+    viewMin_ = min;
+    viewMax_ = max;
+  }
+  // Steps every deferred star by the time it is behind
+  void CatchUp();
+  // Drops the time owed to deferred stars after the particles were replaced
+  void DiscardDeferredTime();
+  // Stars that skipped the last step
+  [[nodiscard]] std::size_t GetDeferredCount() const noexcept {
+    return deferredCount_;
+  }
+
+  // Fills the solver's slot, replacing any earlier solver of that type
+  void RegisterSolver(std::unique_ptr<ForceSolver> solver);
+  [[nodiscard]] bool HasSolver(SolverType type) const;
+  // False (and unchanged) when nothing is registered for the slot
+  bool SetSolver(SolverType type);
+  [[nodiscard]] SolverType GetSolver() const noexcept { return solver_; }
+  // Whether the active solver ran on the last step (it is skipped above its
+  // particle limit)
+  [[nodiscard]] bool IsSolverApplied() const noexcept {
+    return solverApplied_;
+  }
+
+  [[nodiscard]] const PhysicsStepTiming &GetLastStepTiming() const noexcept {
+    return lastTiming_;
+  }
+  [[nodiscard]] const SolverTiming &GetSolverTiming(SolverType type) const {
+    return solverTimings_[static_cast<std::size_t>(type)];
+  }
+
+  // Acceleration the massive bodies cause at a point
+  [[nodiscard]] glm::vec2 BodyAccelerationAt(const glm::vec2 &position) const;
+
+  void Step(float deltaTime);
+
+private:
+  static constexpr std::size_t PHYSICS_CHUNK_SIZE = 4096;
+  // Weight of the newest step in the solver averages
+  static constexpr double TIMING_SMOOTHING = 0.05;
+
+  // Sizes the accurate tracer state and reloads what changed elsewhere
+  void SyncPreciseParticles();
+  void StepBodies(float deltaTime);
+  void StepParticles(float deltaTime);
+  // Fills stepTimes_ for a deferred step; catchUp makes every star due
+  void ScheduleParticles(float deltaTime, bool catchUp);
+  // Advances the stars by deltaTime, or by stepTimes_ when perParticle
+  void AdvanceStars(float deltaTime, bool perParticle);
+  template <typename F> void ForEachChunk(std::size_t count, F &&func);
+
+  Core::ThreadPool &threadPool_;
+  std::unique_ptr<Graphics::ParticleSystem> particleSystem_;
+  std::vector<CelestialBody> bodies_;
+  Core::ExecutionBackend *executionBackend_ = nullptr;
+
+  float gravitationalConstant_ = 100.0f;
+  float bodyMassScale_ = 1.0f;
+  glm::vec2 boundsCenter_{0.0f, 0.0f};
+  float maxDistance_ = 1e9f;
+
+  // Higher-precision copies of the state. The bodies and the particles stay
+  // the float view everything else reads; the copies are reloaded wherever
+  // that view was changed outside the integrator.
+  Precision precision_ = Precision::Fast;
+  std::vector<BodyState<float>> bodyStates_;
+  std::vector<BodyState<double>> preciseBodies_;
+  std::vector<glm::dvec2> precisePositions_;
+  std::vector<glm::dvec2> preciseVelocities_;
+
+  bool fusedPipeline_ = false;
+
+  std::uint32_t temporalInterval_ = 1;
+  std::uint64_t temporalPhase_ = 0;
+  glm::vec2 viewMin_{0.0f, 0.0f};
+  glm::vec2 viewMax_{0.0f, 0.0f};
+  std::vector<float> pendingTimes_; // Time each star is behind
+  std::vector<float> stepTimes_;    // Step of each star this step
+  std::vector<std::size_t> chunkDeferred_;
+  std::size_t deferredCount_ = 0;
+
+  std::array<std::unique_ptr<ForceSolver>, SOLVER_TYPE_COUNT> solvers_;
+  SolverType solver_ = SolverType::MassiveBodies;
+  bool solverApplied_ = false;
+
+  PhysicsStepTiming lastTiming_;
+  std::array<SolverTiming, SOLVER_TYPE_COUNT> solverTimings_{};
 };
 
-} // namespace Physics
\ No newline at end of file
+} // namespace Physics
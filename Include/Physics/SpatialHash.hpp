@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Graphics/ParticleSystem.hpp"
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Core {
+class ThreadPool;
+}
+
+namespace Physics {
+
+// Uniform grid over particle positions, hashed into a power-of-two bucket
+// table so the world needs no bounds. Built in parallel with a counting
+// sort: per-chunk bucket histograms, a prefix sum, then a scatter that
+// copies positions next to the indices so queries read contiguous memory.
+// Rebuilds reuse every buffer and skip the sort when no particle changed
+// cell. Inactive particles are not indexed.
+class SpatialHash {
+public:
+  explicit SpatialHash(Core::ThreadPool &threadPool, float cellSize = 8.0f);
+
+  void SetCellSize(float cellSize);
+  [[nodiscard]] float GetCellSize() const noexcept { return cellSize_; }
+
+  void Build(std::span<const Graphics::Particle> particles);
+
+  // Particle indices within radius of center (appended to result)
+  void QueryRadius(const glm::vec2 &center, float radius,
+                   std::vector<std::uint32_t> &result) const;
+  // Particle indices inside the axis-aligned rectangle (appended to result)
+  void QueryRect(const glm::vec2 &min, const glm::vec2 &max,
+                 std::vector<std::uint32_t> &result) const;
+  // Closest particle within maxDistance, if any
+  [[nodiscard]] std::optional<std::uint32_t>
+  Nearest(const glm::vec2 &position, float maxDistance) const;
+
+  [[nodiscard]] std::size_t GetIndexedCount() const noexcept {
+    return entries_.size();
+  }
+
+private:
+  static constexpr std::uint32_t NO_BUCKET = ~0u;
+  static constexpr std::size_t CHUNK_SIZE = 65536;
+  // Cap on chunk histogram counters (16 MB); at most 4 chunks for the
+  // largest table
+  static constexpr std::size_t MAX_HISTOGRAM_COUNTERS = std::size_t{1} << 22;
+  static constexpr std::size_t BUCKET_CHUNK_SIZE = 16384;
+
+  [[nodiscard]] glm::ivec2 CellOf(const glm::vec2 &position) const {
+    return glm::ivec2(static_cast<int>(std::floor(position.x * inverseCellSize_)),
+                      static_cast<int>(std::floor(position.y * inverseCellSize_)));
+  }
+  [[nodiscard]] std::uint32_t BucketOf(const glm::ivec2 &cell) const {
+    std::uint32_t hash = static_cast<std::uint32_t>(cell.x) * 73856093u ^
+                         static_cast<std::uint32_t>(cell.y) * 19349663u;
+    hash ^= hash >> 16;
+    return hash & bucketMask_;
+  }
+
+  // Calls visit(entry) for every entry in cells min..max (inclusive)
+  template <typename Visitor>
+  void ForEachInCells(const glm::ivec2 &min, const glm::ivec2 &max,
+                      Visitor &&visit) const;
+
+  Core::ThreadPool &threadPool_;
+  float cellSize_;
+  float inverseCellSize_;
+
+  std::uint32_t bucketMask_ = 0;
+  std::vector<std::uint32_t> bucketStart_;    // Bucket count + 1
+  std::vector<std::uint32_t> entries_;        // Particle indices by bucket
+  std::vector<glm::vec2> entryPositions_;     // Same order as entries_
+  std::vector<std::uint32_t> particleBucket_; // NO_BUCKET when inactive
+  std::vector<std::uint32_t> chunkCounts_;    // Chunk-major histograms
+  std::vector<std::uint32_t> bucketCursor_;
+};
+
+} // namespace Physics
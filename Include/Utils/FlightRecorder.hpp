@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Core {
+
+enum class TraceEventType : std::uint8_t {
+  SectionBegin,
+  SectionEnd,
+  TaskBegin,
+  TaskEnd,
+  Allocation
+};
+
+struct TraceEvent {
+  std::int64_t timestamp = 0; // Nanoseconds since the recorder started
+  std::uint64_t value = 0;    // Bytes for allocation events
+  std::array<char, 31> name{};
+  TraceEventType type = TraceEventType::SectionBegin;
+};
+
+struct FlightRecorderSettings {
+  float frameBudget = 1.0f / 60.0f;
+  float slowFrameFactor = 2.0f;      // Dump when a frame exceeds budget * factor
+  std::size_t framesToKeep = 120;    // Frames of history written per dump
+  float dumpCooldown = 5.0f;         // Seconds between dumps
+  std::filesystem::path outputDirectory = "Hitches";
+};
+
+// Key/value pairs describing the scene, written alongside each dump
+using TraceContext = std::vector<std::pair<std::string, std::string>>;
+
+// Always-on recorder for section, task and allocation events. Each thread
+// is the only writer of its own ring buffer, so recording takes no lock;
+// a thread's buffer is reused by later threads once it exits. When a frame runs over budget the last framesToKeep frames are
+// written as a Chrome trace (chrome://tracing, Perfetto) on a background
+// thread.
+class FlightRecorder {
+public:
+  static FlightRecorder &GetInstance();
+
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  void Configure(const FlightRecorderSettings &settings);
+  void SetEnabled(bool enabled) { enabled_ = enabled; }
+  [[nodiscard]] bool IsEnabled() const { return enabled_.load(); }
+
+  // Names the calling thread in dumps
+  void SetThreadName(std::string_view name);
+
+  void Record(TraceEventType type, std::string_view name,
+              std::uint64_t value = 0);
+  void RecordAllocation(std::string_view name, std::size_t bytes) {
+    Record(TraceEventType::Allocation, name, bytes);
+  }
+
+  void BeginFrame();
+
+  // Returns true when the frame was slow enough to warrant a dump
+  bool EndFrame();
+
+  // Writes the retained frames in the background; false if a dump is
+  // still being written or the recorder is disabled
+  bool DumpAsync(TraceContext context);
+
+private:
+  FlightRecorder();
+
+  static constexpr std::size_t EVENTS_PER_THREAD = 8192;
+  static constexpr std::size_t SLOT_WORDS = sizeof(TraceEvent) / 8;
+
+  // An event stored as atomic words, so dumps can copy it while its thread
+  // writes. sequence is the event's index + 1, or 0 during a write.
+  struct Slot {
+    std::atomic<std::uint64_t> sequence{0};
+    std::array<std::atomic<std::uint64_t>, SLOT_WORDS> words{};
+  };
+
+  struct ThreadBuffer {
+    // Owning thread only
+    void Write(const TraceEvent &event);
+    // False when the event was overwritten before or while it was copied
+    bool Read(std::uint64_t index, TraceEvent &event) const;
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<std::uint64_t> written{0};
+    std::uint32_t threadId = 0;
+    std::string threadName; // Guarded by buffersMutex_
+  };
+
+  // Returns the thread's buffer for reuse when the thread exits
+  struct ThreadBufferOwner {
+    ThreadBuffer *buffer = nullptr;
+    ~ThreadBufferOwner();
+  };
+
+  struct FrameRecord {
+    std::uint64_t index = 0;
+    std::int64_t start = 0;
+    std::int64_t end = 0;
+  };
+
+  ThreadBuffer &GetThreadBuffer();
+  [[nodiscard]] std::int64_t Now() const;
+  void WriteTrace(const std::filesystem::path &path,
+                  const std::vector<TraceEvent> &events,
+                  const std::vector<std::uint32_t> &eventThreads,
+                  const std::vector<std::pair<std::uint32_t, std::string>>
+                      &threadNames,
+                  const std::vector<FrameRecord> &frames,
+                  std::uint32_t frameThread, const TraceContext &context,
+                  const FlightRecorderSettings &settings) const;
+
+private:
+  std::atomic<bool> enabled_{true};
+  const std::chrono::steady_clock::time_point epoch_;
+
+  mutable std::mutex buffersMutex_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  std::vector<ThreadBuffer *> freeBuffers_; // Of exited threads
+  std::uint32_t nextThreadId_ = 0;
+
+  // Frame bookkeeping happens on the thread that drives the frame loop
+  FlightRecorderSettings settings_;
+  std::deque<FrameRecord> frames_;
+  std::int64_t frameStart_ = 0;
+  std::uint64_t frameIndex_ = 0;
+  std::uint32_t frameThread_ = 0;
+  std::int64_t lastDump_ = 0;
+  bool hasDumped_ = false;
+
+  std::future<void> pendingDump_;
+};
+
+// Records a section begin/end pair for the enclosing scope
+class ScopedTrace {
+public:
+  explicit ScopedTrace(std::string_view name) : name_(name) {
+    FlightRecorder::GetInstance().Record(TraceEventType::SectionBegin, name_);
+  }
+  ~ScopedTrace() {
+    FlightRecorder::GetInstance().Record(TraceEventType::SectionEnd, name_);
+  }
+
+  ScopedTrace(const ScopedTrace &) = delete;
+  ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+private:
+  std::string_view name_;
+};
+
+// The extra level expands __LINE__ before pasting; pasted directly every
+// trace was named _scoped_trace___LINE__ and nested ones could not share a
+// scope
+#define TRACE_SCOPE_CONCAT_IMPL(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name)                                                      \
+  Core::ScopedTrace TRACE_SCOPE_CONCAT(_scoped_trace_, __LINE__)(name)
+
+} // namespace Core
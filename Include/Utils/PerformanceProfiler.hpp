@@ -9,6 +9,8 @@
 
 namespace Core {
 
+class ThreadPool;
+
 class PerformanceProfiler {
 public:
   struct ProfileData {
@@ -34,6 +36,10 @@ public:
   [[nodiscard]] float GetCurrentFPS() const;
   [[nodiscard]] ProfileData GetSectionData(const std::string &name) const;
 
+  // Pool whose scheduling metrics are included in the report; the owner
+  // detaches it (nullptr) before destroying the pool
+  void SetThreadPool(const ThreadPool *threadPool);
+
   void GenerateReport() const;
   void Reset();
 
@@ -58,6 +64,8 @@ private:
 
   float currentFPS_ = 0.0f;
   float averageFPS_ = 0.0f;
+
+  const ThreadPool *threadPool_ = nullptr;
 };
 
 class ScopedProfiler {
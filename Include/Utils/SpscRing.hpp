@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace Utils {
+
+// Lock-free ring for exactly one producer thread and one consumer thread.
+// Neither side ever waits: TryPush fails when the ring is full and TryPop
+// when it is empty. Capacity must be a power of two.
+template <typename T, std::size_t Capacity> class SpscRing {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscRing capacity must be a power of two");
+
+public:
+  bool TryPush(const T &value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ == Capacity) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if (tail - cachedHead_ == Capacity)
+        return false;
+    }
+    slots_[tail & (Capacity - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool TryPop(T &value) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == cachedTail_) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (head == cachedTail_)
+        return false;
+    }
+    value = slots_[head & (Capacity - 1)];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  static constexpr std::size_t CACHE_LINE = 64;
+
+  // Each side keeps a stale copy of the other's index and only reloads it
+  // when the ring looks full or empty, so the indices' cache lines are not
+  // bounced on every operation
+  alignas(CACHE_LINE) std::atomic<std::size_t> head_{0};
+  std::size_t cachedTail_ = 0; // Consumer side
+  alignas(CACHE_LINE) std::atomic<std::size_t> tail_{0};
+  std::size_t cachedHead_ = 0; // Producer side
+  alignas(CACHE_LINE) std::array<T, Capacity> slots_{};
+};
+
+} // namespace Utils
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace Utils {
+
+// Latest-value mailbox between one writer thread and one reader thread.
+// Both sides are wait-free: the writer fills its private slot and swaps it
+// with the shared middle slot, the reader swaps the middle slot for its own
+// only when something new was published. Intermediate values the reader
+// never saw are overwritten, which is what a stream of parameters wants.
+template <typename T> class TripleBuffer {
+public:
+  TripleBuffer() = default;
+  explicit TripleBuffer(const T &initial) { slots_.fill(initial); }
+
+  // Writer side: fill this slot, then Publish
+  [[nodiscard]] T &GetWriteBuffer() noexcept { return slots_[writeIndex_]; }
+  void Publish() noexcept {
+    const std::uint8_t previous =
+        middle_.exchange(writeIndex_ | FRESH, std::memory_order_acq_rel);
+    writeIndex_ = previous & INDEX_MASK;
+  }
+  void Publish(const T &value) {
+    GetWriteBuffer() = value;
+    Publish();
+  }
+
+  // Reader side: the most recently published value (or the last one read)
+  [[nodiscard]] const T &Read() noexcept {
+    if (middle_.load(std::memory_order_relaxed) & FRESH) {
+      const std::uint8_t previous =
+          middle_.exchange(readIndex_, std::memory_order_acq_rel);
+      readIndex_ = previous & INDEX_MASK;
+    }
+    return slots_[readIndex_];
+  }
+
+private:
+  static constexpr std::uint8_t INDEX_MASK = 0x3;
+  static constexpr std::uint8_t FRESH = 0x4;
+
+  std::array<T, 3> slots_{};
+  std::uint8_t writeIndex_ = 0;         // Writer only
+  std::atomic<std::uint8_t> middle_{1}; // Shared slot index + FRESH flag
+  std::uint8_t readIndex_ = 2;          // Reader only
+};
+
+} // namespace Utils
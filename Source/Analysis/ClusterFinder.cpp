@@ -0,0 +1,322 @@
+#include "Analysis/ClusterFinder.hpp"
+#include "Core/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace Analysis {
+
+namespace {
+
+// Lock-free disjoint-set forest. Roots are always linked under the smaller
+// index, so every component ends up rooted at its lowest member regardless
+// of the order in which threads perform unions.
+class ConcurrentUnionFind {
+public:
+  explicit ConcurrentUnionFind(std::size_t size) : parent_(size) {
+    for (std::size_t i = 0; i < size; ++i) {
+      parent_[i].store(static_cast<std::uint32_t>(i), std::memory_order_relaxed);
+    }
+  }
+
+  std::uint32_t Find(std::uint32_t x) {
+    while (true) {
+      std::uint32_t p = parent_[x].load(std::memory_order_acquire);
+      if (p == x) {
+        return x;
+      }
+      std::uint32_t grandParent = parent_[p].load(std::memory_order_acquire);
+      if (grandParent != p) {
+        // Path halving; losing this race is harmless
+        parent_[x].compare_exchange_weak(p, grandParent,
+                                         std::memory_order_acq_rel);
+      }
+      x = grandParent;
+    }
+  }
+
+  void Unite(std::uint32_t a, std::uint32_t b) {
+    while (true) {
+      a = Find(a);
+      b = Find(b);
+      if (a == b) {
+        return;
+      }
+      if (a < b) {
+        std::swap(a, b);
+      }
+      // Only a root may be relinked; retry if a was linked meanwhile
+      std::uint32_t expected = a;
+      if (parent_[a].compare_exchange_strong(expected, b,
+                                             std::memory_order_acq_rel)) {
+        return;
+      }
+    }
+  }
+
+private:
+  std::vector<std::atomic<std::uint32_t>> parent_;
+};
+
+struct Bounds {
+  glm::vec2 min{std::numeric_limits<float>::max()};
+  glm::vec2 max{std::numeric_limits<float>::lowest()};
+};
+
+} // namespace
+
+ClusterFinder::ClusterFinder(Core::ThreadPool &threadPool)
+    : threadPool_(threadPool) {}
+
+ClusterFinder::~ClusterFinder() {
+  if (pending_.valid()) {
+    pending_.wait();
+  }
+}
+
+ClusterCatalog ClusterFinder::Find(const ParticleSnapshot &snapshot) const {
+  auto startTime = std::chrono::steady_clock::now();
+
+  const float linkingLength = linkingLength_.load();
+  const std::size_t minMembers = minMembers_.load();
+
+  ClusterCatalog catalog;
+  catalog.linkingLength = linkingLength;
+  catalog.particleIndices = snapshot.particleIndices;
+
+  const std::size_t count = snapshot.GetSize();
+  catalog.labels.assign(count, ClusterCatalog::NO_CLUSTER);
+  if (count == 0 || linkingLength <= 0.0f) {
+    return catalog;
+  }
+
+  const auto &positions = snapshot.positions;
+  const std::size_t chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  // Bounding box, reduced per chunk then in chunk order
+  std::vector<Bounds> chunkBounds(chunkCount);
+  threadPool_.ParallelFor(count, CHUNK_SIZE,
+                          [&](std::size_t begin, std::size_t end) {
+                            Bounds bounds;
+                            for (std::size_t i = begin; i < end; ++i) {
+                              bounds.min = glm::min(bounds.min, positions[i]);
+                              bounds.max = glm::max(bounds.max, positions[i]);
+                            }
+                            chunkBounds[begin / CHUNK_SIZE] = bounds;
+                          },
+                          Core::TaskPriority::Background);
+
+  Bounds bounds;
+  for (const auto &chunk : chunkBounds) {
+    bounds.min = glm::min(bounds.min, chunk.min);
+    bounds.max = glm::max(bounds.max, chunk.max);
+  }
+
+  // Cells must be at least one linking length wide so that all friends lie
+  // in adjacent cells. Widen them when sparse data would need too many cells.
+  glm::vec2 extent = glm::max(bounds.max - bounds.min, glm::vec2(1.0f));
+  const double maxCells = static_cast<double>(count * CELLS_PER_PARTICLE + 1);
+  float cellSize = std::max(
+      linkingLength,
+      static_cast<float>(std::sqrt(double(extent.x) * extent.y / maxCells)));
+
+  const auto gridWidth =
+      static_cast<std::uint32_t>(extent.x / cellSize) + 1;
+  const auto gridHeight =
+      static_cast<std::uint32_t>(extent.y / cellSize) + 1;
+  const std::size_t cellCount = std::size_t(gridWidth) * gridHeight;
+  const float inverseCellSize = 1.0f / cellSize;
+
+  auto cellOf = [&](const glm::vec2 &position) {
+    auto cx = std::min(static_cast<std::uint32_t>(
+                           (position.x - bounds.min.x) * inverseCellSize),
+                       gridWidth - 1);
+    auto cy = std::min(static_cast<std::uint32_t>(
+                           (position.y - bounds.min.y) * inverseCellSize),
+                       gridHeight - 1);
+    return cy * gridWidth + cx;
+  };
+
+  // Counting sort of particles into cells
+  std::vector<std::uint32_t> cellKeys(count);
+  std::vector<std::atomic<std::uint32_t>> cellCounts(cellCount);
+  threadPool_.ParallelFor(count, CHUNK_SIZE,
+                          [&](std::size_t begin, std::size_t end) {
+                            for (std::size_t i = begin; i < end; ++i) {
+                              cellKeys[i] = cellOf(positions[i]);
+                              cellCounts[cellKeys[i]].fetch_add(
+                                  1, std::memory_order_relaxed);
+                            }
+                          },
+                          Core::TaskPriority::Background);
+
+  std::vector<std::uint32_t> cellStart(cellCount + 1, 0);
+  for (std::size_t c = 0; c < cellCount; ++c) {
+    cellStart[c + 1] =
+        cellStart[c] + cellCounts[c].load(std::memory_order_relaxed);
+    cellCounts[c].store(cellStart[c], std::memory_order_relaxed);
+  }
+
+  std::vector<std::uint32_t> sorted(count);
+  threadPool_.ParallelFor(
+      count, CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+          sorted[cellCounts[cellKeys[i]].fetch_add(
+              1, std::memory_order_relaxed)] = static_cast<std::uint32_t>(i);
+        }
+      },
+      Core::TaskPriority::Background);
+
+  // Link friends. Each cell checks itself and a half stencil of neighbours
+  // so every cell pair is visited exactly once.
+  ConcurrentUnionFind unionFind(count);
+  const float linkingLengthSq = linkingLength * linkingLength;
+  constexpr int STENCIL[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+  const std::size_t cellChunk =
+      std::max<std::size_t>(cellCount / (threadPool_.GetNumThreads() * 8), 64);
+
+  threadPool_.ParallelFor(
+      cellCount, cellChunk, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t cell = begin; cell < end; ++cell) {
+          const std::uint32_t first = cellStart[cell];
+          const std::uint32_t last = cellStart[cell + 1];
+          if (first == last)
+            continue;
+
+          const auto cx = static_cast<int>(cell % gridWidth);
+          const auto cy = static_cast<int>(cell / gridWidth);
+
+          for (std::uint32_t a = first; a < last; ++a) {
+            const std::uint32_t i = sorted[a];
+            const glm::vec2 pi = positions[i];
+
+            for (std::uint32_t b = a + 1; b < last; ++b) {
+              glm::vec2 d = positions[sorted[b]] - pi;
+              if (glm::dot(d, d) <= linkingLengthSq) {
+                unionFind.Unite(i, sorted[b]);
+              }
+            }
+
+            for (const auto &offset : STENCIL) {
+              int nx = cx + offset[0];
+              int ny = cy + offset[1];
+              if (nx < 0 || ny < 0 || nx >= static_cast<int>(gridWidth) ||
+                  ny >= static_cast<int>(gridHeight))
+                continue;
+
+              const std::size_t neighbour = std::size_t(ny) * gridWidth + nx;
+              for (std::uint32_t b = cellStart[neighbour];
+                   b < cellStart[neighbour + 1]; ++b) {
+                glm::vec2 d = positions[sorted[b]] - pi;
+                if (glm::dot(d, d) <= linkingLengthSq) {
+                  unionFind.Unite(i, sorted[b]);
+                }
+              }
+            }
+          }
+        }
+      },
+      Core::TaskPriority::Background);
+
+  std::vector<std::uint32_t> roots(count);
+  threadPool_.ParallelFor(count, CHUNK_SIZE,
+                          [&](std::size_t begin, std::size_t end) {
+                            for (std::size_t i = begin; i < end; ++i) {
+                              roots[i] = unionFind.Find(
+                                  static_cast<std::uint32_t>(i));
+                            }
+                          },
+                          Core::TaskPriority::Background);
+
+  // Group statistics, accumulated on each component's root entry
+  std::vector<std::uint32_t> memberCounts(count, 0);
+  std::vector<double> groupMass(count, 0.0);
+  std::vector<glm::dvec2> weightedPosition(count, glm::dvec2(0.0));
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint32_t root = roots[i];
+    const double mass = snapshot.masses[i];
+    ++memberCounts[root];
+    groupMass[root] += mass;
+    weightedPosition[root] += glm::dvec2(positions[i]) * mass;
+  }
+
+  std::vector<std::uint32_t> groupRoots;
+  for (std::size_t i = 0; i < count; ++i) {
+    if (roots[i] == i && memberCounts[i] >= minMembers) {
+      groupRoots.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+  std::ranges::sort(groupRoots, [&](std::uint32_t a, std::uint32_t b) {
+    return groupMass[a] != groupMass[b] ? groupMass[a] > groupMass[b] : a < b;
+  });
+
+  std::vector<std::int32_t> clusterOfRoot(count, ClusterCatalog::NO_CLUSTER);
+  catalog.clusters.reserve(groupRoots.size());
+  for (std::size_t c = 0; c < groupRoots.size(); ++c) {
+    const std::uint32_t root = groupRoots[c];
+    clusterOfRoot[root] = static_cast<std::int32_t>(c);
+
+    Cluster cluster;
+    cluster.id = static_cast<std::uint32_t>(c);
+    cluster.memberCount = memberCounts[root];
+    cluster.mass = static_cast<float>(groupMass[root]);
+    cluster.center = glm::vec2(weightedPosition[root] / groupMass[root]);
+    catalog.clusters.push_back(cluster);
+  }
+
+  std::vector<double> radiusSq(catalog.clusters.size(), 0.0);
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::int32_t id = clusterOfRoot[roots[i]];
+    catalog.labels[i] = id;
+    if (id != ClusterCatalog::NO_CLUSTER) {
+      glm::vec2 d = positions[i] - catalog.clusters[id].center;
+      radiusSq[id] += glm::dot(d, d);
+    }
+  }
+  for (auto &cluster : catalog.clusters) {
+    cluster.radius = static_cast<float>(
+        std::sqrt(radiusSq[cluster.id] / cluster.memberCount));
+  }
+
+  catalog.findSeconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - startTime)
+                            .count();
+  return catalog;
+}
+
+bool ClusterFinder::FindAsync(ParticleSnapshot snapshot) {
+  if (IsBusy()) {
+    return false;
+  }
+
+  // The search itself fans out onto the pool, so it is driven from its own
+  // thread rather than from a pool worker that would wait on its siblings.
+  pending_ = std::async(std::launch::async,
+                        [this, snapshot = std::move(snapshot)]() {
+                          auto catalog = std::make_shared<const ClusterCatalog>(
+                              Find(snapshot));
+                          spdlog::debug("FoF found {} clusters among {} "
+                                        "particles in {:.1f}ms",
+                                        catalog->clusters.size(),
+                                        snapshot.GetSize(),
+                                        catalog->findSeconds * 1000.0);
+
+                          std::lock_guard<std::mutex> lock(resultMutex_);
+                          latest_ = std::move(catalog);
+                        });
+  return true;
+}
+
+bool ClusterFinder::IsBusy() const {
+  return pending_.valid() && pending_.wait_for(std::chrono::seconds(0)) !=
+                                 std::future_status::ready;
+}
+
+std::shared_ptr<const ClusterCatalog> ClusterFinder::GetLatest() const {
+  std::lock_guard<std::mutex> lock(resultMutex_);
+  return latest_;
+}
+
+} // namespace Analysis
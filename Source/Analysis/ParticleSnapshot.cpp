@@ -0,0 +1,60 @@
+#include "Analysis/ParticleSnapshot.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Utils/FlightRecorder.hpp"
+
+namespace Analysis {
+
+ParticleSnapshot
+ParticleSnapshot::Capture(std::span<const Graphics::Particle> particles,
+                          Core::ThreadPool &threadPool) {
+  const std::size_t chunkCount =
+      (particles.size() + CAPTURE_CHUNK_SIZE - 1) / CAPTURE_CHUNK_SIZE;
+  std::vector<std::size_t> offsets(chunkCount + 1, 0);
+
+  // Count active particles per chunk, then prefix-sum into output offsets
+  threadPool.ParallelFor(
+      particles.size(), CAPTURE_CHUNK_SIZE,
+      [&](std::size_t begin, std::size_t end) {
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+          count += particles[i].active ? 1 : 0;
+        }
+        offsets[begin / CAPTURE_CHUNK_SIZE + 1] = count;
+      },
+      Core::TaskPriority::Critical);
+
+  for (std::size_t c = 0; c < chunkCount; ++c) {
+    offsets[c + 1] += offsets[c];
+  }
+
+  ParticleSnapshot snapshot;
+  snapshot.positions.resize(offsets.back());
+  snapshot.velocities.resize(offsets.back());
+  snapshot.masses.resize(offsets.back());
+  snapshot.particleIndices.resize(offsets.back());
+  Core::FlightRecorder::GetInstance().RecordAllocation(
+      "ParticleSnapshot::Capture",
+      offsets.back() * (2 * sizeof(glm::vec2) + sizeof(float) +
+                        sizeof(std::uint32_t)));
+
+  threadPool.ParallelFor(
+      particles.size(), CAPTURE_CHUNK_SIZE,
+      [&](std::size_t begin, std::size_t end) {
+        std::size_t out = offsets[begin / CAPTURE_CHUNK_SIZE];
+        for (std::size_t i = begin; i < end; ++i) {
+          if (!particles[i].active)
+            continue;
+
+          snapshot.positions[out] = particles[i].position;
+          snapshot.velocities[out] = particles[i].velocity;
+          snapshot.masses[out] = particles[i].mass;
+          snapshot.particleIndices[out] = static_cast<std::uint32_t>(i);
+          ++out;
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  return snapshot;
+}
+
+} // namespace Analysis
@@ -0,0 +1,241 @@
+#include "Analysis/ProfileAnalyzer.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Utils/Math.hpp"
+#include <chrono>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace Analysis {
+
+namespace {
+
+// Running sums for one radial bin; everything is mass-weighted
+struct BinAccumulator {
+  std::uint32_t count = 0;
+  double mass = 0.0;
+  double tangential = 0.0;
+  double tangentialSq = 0.0;
+  double radial = 0.0;
+  double radialSq = 0.0;
+  std::array<double, MAX_FOURIER_MODE> cosSum{};
+  std::array<double, MAX_FOURIER_MODE> sinSum{};
+
+  void Merge(const BinAccumulator &other) {
+    count += other.count;
+    mass += other.mass;
+    tangential += other.tangential;
+    tangentialSq += other.tangentialSq;
+    radial += other.radial;
+    radialSq += other.radialSq;
+    for (std::size_t m = 0; m < MAX_FOURIER_MODE; ++m) {
+      cosSum[m] += other.cosSum[m];
+      sinSum[m] += other.sinSum[m];
+    }
+  }
+};
+
+float FourierAmplitude(double cosSum, double sinSum, double mass) {
+  return mass > 0.0 ? static_cast<float>(std::hypot(cosSum, sinSum) / mass)
+                    : 0.0f;
+}
+
+} // namespace
+
+ProfileAnalyzer::ProfileAnalyzer(Core::ThreadPool &threadPool)
+    : threadPool_(threadPool) {}
+
+ProfileAnalyzer::~ProfileAnalyzer() {
+  if (pending_.valid()) {
+    pending_.wait();
+  }
+}
+
+bool ProfileAnalyzer::OpenCsvStream(const std::string &path) {
+  csv_.open(path, std::ios::out | std::ios::trunc);
+  if (!csv_) {
+    spdlog::error("Failed to open analysis CSV '{}'", path);
+    return false;
+  }
+
+  csv_ << "time,bin,r_inner,r_outer,count,mass,surface_density,v_rot,v_rad,"
+          "sigma_r,sigma_t,A1,A2,A3,A4\n";
+  spdlog::info("Streaming radial profiles to '{}'", path);
+  return true;
+}
+
+RadialProfile ProfileAnalyzer::Analyze(const ParticleSnapshot &snapshot,
+                                       const glm::vec2 &center,
+                                       const glm::vec2 &centerVelocity,
+                                       double simulationTime) const {
+  return Analyze(snapshot, settings_, center, centerVelocity, simulationTime);
+}
+
+RadialProfile ProfileAnalyzer::Analyze(const ParticleSnapshot &snapshot,
+                                       const ProfileSettings &settings,
+                                       const glm::vec2 &center,
+                                       const glm::vec2 &centerVelocity,
+                                       double simulationTime) const {
+  auto startTime = std::chrono::steady_clock::now();
+
+  const std::size_t binCount = std::max<std::size_t>(settings.binCount, 1);
+  const float binWidth = settings.maxRadius / static_cast<float>(binCount);
+  const std::size_t count = snapshot.GetSize();
+  const std::size_t chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+  // One private histogram per chunk, so workers never share a bin
+  std::vector<BinAccumulator> histograms(chunkCount * binCount);
+
+  threadPool_.ParallelFor(
+      count, CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        BinAccumulator *histogram =
+            histograms.data() + (begin / CHUNK_SIZE) * binCount;
+
+        for (std::size_t i = begin; i < end; ++i) {
+          glm::vec2 offset = snapshot.positions[i] - center;
+          float radius = glm::length(offset);
+          if (radius >= settings.maxRadius || radius <= 0.0f)
+            continue;
+
+          glm::vec2 radialDir = offset / radius;
+          glm::vec2 tangentialDir(-radialDir.y, radialDir.x);
+          glm::vec2 velocity = snapshot.velocities[i] - centerVelocity;
+          double vRadial = glm::dot(velocity, radialDir);
+          double vTangential = glm::dot(velocity, tangentialDir);
+          double mass = snapshot.masses[i];
+
+          // binWidth is rounded, so radii just under maxRadius can land on
+          // binCount
+          auto &bin = histogram[std::min(
+              static_cast<std::size_t>(radius / binWidth), binCount - 1)];
+          ++bin.count;
+          bin.mass += mass;
+          bin.tangential += mass * vTangential;
+          bin.tangentialSq += mass * vTangential * vTangential;
+          bin.radial += mass * vRadial;
+          bin.radialSq += mass * vRadial * vRadial;
+
+          // e^{i m theta} by repeated complex multiplication, no trig needed
+          double c = radialDir.x;
+          double s = radialDir.y;
+          double cm = c;
+          double sm = s;
+          for (std::size_t m = 0; m < MAX_FOURIER_MODE; ++m) {
+            bin.cosSum[m] += mass * cm;
+            bin.sinSum[m] += mass * sm;
+            double nextCos = cm * c - sm * s;
+            sm = sm * c + cm * s;
+            cm = nextCos;
+          }
+        }
+      },
+      Core::TaskPriority::Background);
+
+  // Merge in chunk order
+  std::vector<BinAccumulator> totals(binCount);
+  for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+    for (std::size_t b = 0; b < binCount; ++b) {
+      totals[b].Merge(histograms[chunk * binCount + b]);
+    }
+  }
+
+  RadialProfile profile;
+  profile.simulationTime = simulationTime;
+  profile.center = center;
+  profile.bins.resize(binCount);
+
+  BinAccumulator global;
+  for (std::size_t b = 0; b < binCount; ++b) {
+    const auto &sums = totals[b];
+    auto &bin = profile.bins[b];
+    global.Merge(sums);
+
+    bin.innerRadius = binWidth * static_cast<float>(b);
+    bin.outerRadius = bin.innerRadius + binWidth;
+    bin.count = sums.count;
+    bin.mass = static_cast<float>(sums.mass);
+
+    float area = Utils::PI * (bin.outerRadius * bin.outerRadius -
+                              bin.innerRadius * bin.innerRadius);
+    bin.surfaceDensity = bin.mass / area;
+
+    if (sums.mass > 0.0) {
+      double meanT = sums.tangential / sums.mass;
+      double meanR = sums.radial / sums.mass;
+      bin.rotationVelocity = static_cast<float>(meanT);
+      bin.radialVelocity = static_cast<float>(meanR);
+      bin.tangentialDispersion = static_cast<float>(
+          std::sqrt(std::max(sums.tangentialSq / sums.mass - meanT * meanT, 0.0)));
+      bin.radialDispersion = static_cast<float>(
+          std::sqrt(std::max(sums.radialSq / sums.mass - meanR * meanR, 0.0)));
+    }
+
+    for (std::size_t m = 0; m < MAX_FOURIER_MODE; ++m) {
+      bin.fourierAmplitudes[m] =
+          FourierAmplitude(sums.cosSum[m], sums.sinSum[m], sums.mass);
+    }
+  }
+
+  for (std::size_t m = 0; m < MAX_FOURIER_MODE; ++m) {
+    profile.globalFourierAmplitudes[m] =
+        FourierAmplitude(global.cosSum[m], global.sinSum[m], global.mass);
+  }
+
+  profile.analysisSeconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - startTime)
+                                .count();
+  return profile;
+}
+
+bool ProfileAnalyzer::AnalyzeAsync(ParticleSnapshot snapshot,
+                                   const glm::vec2 &center,
+                                   const glm::vec2 &centerVelocity,
+                                   double simulationTime) {
+  if (IsBusy()) {
+    return false;
+  }
+
+  // Driven from its own thread because the analysis fans out onto the pool
+  pending_ = std::async(
+      std::launch::async, [this, snapshot = std::move(snapshot),
+                           settings = settings_, center, centerVelocity,
+                           simulationTime]() {
+        auto profile = std::make_shared<const RadialProfile>(Analyze(
+            snapshot, settings, center, centerVelocity, simulationTime));
+
+        if (csv_.is_open()) {
+          WriteCsv(*profile);
+        }
+
+        std::lock_guard<std::mutex> lock(resultMutex_);
+        latest_ = std::move(profile);
+      });
+  return true;
+}
+
+bool ProfileAnalyzer::IsBusy() const {
+  return pending_.valid() && pending_.wait_for(std::chrono::seconds(0)) !=
+                                 std::future_status::ready;
+}
+
+std::shared_ptr<const RadialProfile> ProfileAnalyzer::GetLatest() const {
+  std::lock_guard<std::mutex> lock(resultMutex_);
+  return latest_;
+}
+
+void ProfileAnalyzer::WriteCsv(const RadialProfile &profile) {
+  for (std::size_t b = 0; b < profile.bins.size(); ++b) {
+    const auto &bin = profile.bins[b];
+    csv_ << profile.simulationTime << ',' << b << ',' << bin.innerRadius << ','
+         << bin.outerRadius << ',' << bin.count << ',' << bin.mass << ','
+         << bin.surfaceDensity << ',' << bin.rotationVelocity << ','
+         << bin.radialVelocity << ',' << bin.radialDispersion << ','
+         << bin.tangentialDispersion;
+    for (float amplitude : bin.fourierAmplitudes) {
+      csv_ << ',' << amplitude;
+    }
+    csv_ << '\n';
+  }
+  csv_.flush();
+}
+
+} // namespace Analysis
@@ -1,7 +1,311 @@
 #include "Audio/AudioAnalyzer.hpp"
+#include "Utils/Math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <spdlog/spdlog.h>
 
 namespace Audio {
 
-// AudioAnalyzer implementation will go here
+namespace {
 
-} // namespace Audio
\ No newline at end of file
+constexpr float MIN_BAND_FREQUENCY = 40.0f;
+constexpr float MAX_BAND_FREQUENCY = 16000.0f;
+constexpr float BAND_PEAK_DECAY = 0.995f;  // Per hop, ~1.5 s half-life
+constexpr float ONSET_THRESHOLD_SCALE = 1.5f;
+constexpr float ONSET_THRESHOLD_FLOOR = 0.01f;
+constexpr std::size_t MIN_ONSET_GAP = 8; // Hops, ~90 ms at 44.1 kHz
+
+} // namespace
+
+RealFFT::RealFFT(std::size_t size)
+    : size_(size), half_(size / 2), bitReverse_(half_), twiddleRe_(half_),
+      twiddleIm_(half_), splitRe_(half_ + 1), splitIm_(half_ + 1), re_(half_),
+      im_(half_) {
+  int bits = 0;
+  while ((std::size_t{1} << bits) < half_) {
+    ++bits;
+  }
+  for (std::size_t i = 0; i < half_; ++i) {
+    std::uint32_t reversed = 0;
+    for (int b = 0; b < bits; ++b) {
+      reversed |= ((i >> b) & 1u) << (bits - 1 - b);
+    }
+    bitReverse_[i] = reversed;
+  }
+
+  for (std::size_t h = 1; h < half_; h *= 2) {
+    for (std::size_t j = 0; j < h; ++j) {
+      const double angle = -std::numbers::pi * j / h;
+      twiddleRe_[h - 1 + j] = static_cast<float>(std::cos(angle));
+      twiddleIm_[h - 1 + j] = static_cast<float>(std::sin(angle));
+    }
+  }
+  for (std::size_t k = 0; k <= half_; ++k) {
+    const double angle = -2.0 * std::numbers::pi * k / size_;
+    splitRe_[k] = static_cast<float>(std::cos(angle));
+    splitIm_[k] = static_cast<float>(std::sin(angle));
+  }
+}
+
+void RealFFT::Forward(std::span<const float> input, std::span<float> magnitudes) {
+  // Even samples become the real part, odd samples the imaginary part
+  for (std::size_t i = 0; i < half_; ++i) {
+    const std::uint32_t target = bitReverse_[i];
+    re_[target] = input[2 * i];
+    im_[target] = input[2 * i + 1];
+  }
+
+  for (std::size_t h = 1; h < half_; h *= 2) {
+    const float *wr = &twiddleRe_[h - 1];
+    const float *wi = &twiddleIm_[h - 1];
+    for (std::size_t start = 0; start < half_; start += 2 * h) {
+      float *ar = &re_[start];
+      float *ai = &im_[start];
+      float *br = &re_[start + h];
+      float *bi = &im_[start + h];
+      for (std::size_t j = 0; j < h; ++j) {
+        const float tr = br[j] * wr[j] - bi[j] * wi[j];
+        const float ti = br[j] * wi[j] + bi[j] * wr[j];
+        br[j] = ar[j] - tr;
+        bi[j] = ai[j] - ti;
+        ar[j] += tr;
+        ai[j] += ti;
+      }
+    }
+  }
+
+  // Separate the spectra of the even and odd samples and recombine
+  for (std::size_t k = 0; k <= half_; ++k) {
+    const std::size_t a = k % half_;
+    const std::size_t b = (half_ - k) % half_;
+    const float evenRe = 0.5f * (re_[a] + re_[b]);
+    const float evenIm = 0.5f * (im_[a] - im_[b]);
+    const float oddRe = 0.5f * (re_[a] - re_[b]);
+    const float oddIm = 0.5f * (im_[a] + im_[b]);
+    const float xr = evenRe + splitRe_[k] * oddIm + splitIm_[k] * oddRe;
+    const float xi = evenIm - splitRe_[k] * oddRe + splitIm_[k] * oddIm;
+    magnitudes[k] = std::sqrt(xr * xr + xi * xi);
+  }
+}
+
+class AudioAnalyzer::CaptureSource : public sf::SoundRecorder {
+public:
+  explicit CaptureSource(AudioAnalyzer &owner) : owner_(owner) {
+    setProcessingInterval(sf::milliseconds(10));
+  }
+  ~CaptureSource() override { stop(); }
+
+protected:
+  bool onProcessSamples(const sf::Int16 *samples,
+                        std::size_t sampleCount) override {
+    owner_.Process(samples, sampleCount, getChannelCount());
+    return true;
+  }
+
+private:
+  AudioAnalyzer &owner_;
+};
+
+class AudioAnalyzer::MusicSource : public sf::Music {
+public:
+  explicit MusicSource(AudioAnalyzer &owner) : owner_(owner) {}
+  ~MusicSource() override { stop(); }
+
+protected:
+  // Analyzes each chunk as it is handed to the audio device
+  bool onGetData(Chunk &data) override {
+    const bool more = sf::Music::onGetData(data);
+    owner_.Process(data.samples, data.sampleCount, getChannelCount());
+    return more;
+  }
+
+private:
+  AudioAnalyzer &owner_;
+};
+
+AudioAnalyzer::AudioAnalyzer() {
+  for (std::size_t i = 0; i < FFT_SIZE; ++i) {
+    window_[i] = 0.5f - 0.5f * std::cos(Utils::TWO_PI * i / FFT_SIZE);
+  }
+}
+
+AudioAnalyzer::~AudioAnalyzer() { Stop(); }
+
+void AudioAnalyzer::Prepare(unsigned sampleRate) {
+  sampleRate_ = std::max(sampleRate, 1u);
+
+  // Log-spaced bands, each at least one bin wide
+  const std::size_t lastBin = FFT_SIZE / 2;
+  const float maxFrequency =
+      std::min(MAX_BAND_FREQUENCY, 0.5f * static_cast<float>(sampleRate_));
+  const float binWidth = static_cast<float>(sampleRate_) / FFT_SIZE;
+  for (std::size_t b = 0; b <= AudioFeatures::BAND_COUNT; ++b) {
+    const float frequency =
+        MIN_BAND_FREQUENCY *
+        std::pow(maxFrequency / MIN_BAND_FREQUENCY,
+                 static_cast<float>(b) / AudioFeatures::BAND_COUNT);
+    std::size_t bin = static_cast<std::size_t>(frequency / binWidth);
+    if (b > 0) {
+      bin = std::max(bin, bandEdges_[b - 1] + 1);
+    }
+    bandEdges_[b] = std::min(bin, lastBin);
+  }
+
+  history_.fill(0.0f);
+  previousSpectrum_.fill(0.0f);
+  bandPeaks_.fill(1e-4f);
+  fluxHistory_.fill(0.0f);
+  fluxIndex_ = historyIndex_ = samplesSinceHop_ = 0;
+  framesSinceOnset_ = MIN_ONSET_GAP;
+  previousFlux_ = 0.0f;
+  samplesAnalyzed_ = 0;
+}
+
+bool AudioAnalyzer::StartCapture(unsigned sampleRate) {
+  Stop();
+  if (!sf::SoundRecorder::isAvailable()) {
+    spdlog::warn("No audio capture device available");
+    return false;
+  }
+
+  Prepare(sampleRate);
+  capture_ = std::make_unique<CaptureSource>(*this);
+  if (!capture_->start(sampleRate)) {
+    capture_.reset();
+    spdlog::warn("Failed to start audio capture");
+    return false;
+  }
+
+  spdlog::info("Analyzing microphone input at {} Hz", sampleRate);
+  return true;
+}
+
+bool AudioAnalyzer::PlayFile(const std::string &path) {
+  Stop();
+
+  music_ = std::make_unique<MusicSource>(*this);
+  if (!music_->openFromFile(path)) {
+    music_.reset();
+    spdlog::warn("Failed to open audio file '{}'", path);
+    return false;
+  }
+
+  Prepare(music_->getSampleRate());
+  music_->setLoop(true);
+  music_->play();
+
+  spdlog::info("Analyzing '{}' ({} Hz, {} channels)", path,
+               music_->getSampleRate(), music_->getChannelCount());
+  return true;
+}
+
+void AudioAnalyzer::Stop() {
+  // The sources stop their audio threads before they go away
+  capture_.reset();
+  music_.reset();
+}
+
+bool AudioAnalyzer::IsRunning() const {
+  return capture_ != nullptr ||
+         (music_ && music_->getStatus() == sf::SoundSource::Playing);
+}
+
+bool AudioAnalyzer::Poll(AudioFeatures &features) {
+  AudioFeatures next;
+  bool received = false;
+  bool onset = false;
+  float onsetStrength = 0.0f;
+
+  while (ring_.TryPop(next)) {
+    received = true;
+    onset = onset || next.onset;
+    onsetStrength = std::max(onsetStrength, next.onsetStrength);
+    features = next;
+  }
+
+  if (received) {
+    features.onset = onset;
+    features.onsetStrength = onsetStrength;
+  }
+  return received;
+}
+
+void AudioAnalyzer::Process(const sf::Int16 *samples, std::size_t sampleCount,
+                            unsigned channelCount) {
+  channelCount = std::max(channelCount, 1u);
+  const float scale = 1.0f / (32768.0f * channelCount);
+
+  for (std::size_t i = 0; i + channelCount <= sampleCount; i += channelCount) {
+    int mixed = 0;
+    for (unsigned c = 0; c < channelCount; ++c) {
+      mixed += samples[i + c];
+    }
+    history_[historyIndex_] = mixed * scale;
+    historyIndex_ = (historyIndex_ + 1) % FFT_SIZE;
+
+    if (++samplesSinceHop_ == HOP_SIZE) {
+      samplesSinceHop_ = 0;
+      AnalyzeFrame();
+    }
+  }
+}
+
+void AudioAnalyzer::AnalyzeFrame() {
+  // Oldest sample first
+  float sumSquares = 0.0f;
+  for (std::size_t i = 0; i < FFT_SIZE; ++i) {
+    const float sample = history_[(historyIndex_ + i) % FFT_SIZE];
+    sumSquares += sample * sample;
+    frame_[i] = sample * window_[i];
+  }
+  fft_.Forward(frame_, spectrum_);
+  samplesAnalyzed_ += HOP_SIZE;
+
+  AudioFeatures features;
+  features.level = std::sqrt(sumSquares / FFT_SIZE);
+  features.time = static_cast<double>(samplesAnalyzed_) / sampleRate_;
+
+  // Amplitudes relative to a full-scale sine under the Hann window
+  constexpr float amplitudeScale = 4.0f / FFT_SIZE;
+  float flux = 0.0f;
+  for (std::size_t k = 0; k < spectrum_.size(); ++k) {
+    const float compressed = std::log1p(100.0f * amplitudeScale * spectrum_[k]);
+    flux += std::max(0.0f, compressed - previousSpectrum_[k]);
+    previousSpectrum_[k] = compressed;
+  }
+  flux /= static_cast<float>(spectrum_.size());
+
+  for (std::size_t b = 0; b < AudioFeatures::BAND_COUNT; ++b) {
+    float energy = 0.0f;
+    for (std::size_t k = bandEdges_[b]; k < bandEdges_[b + 1]; ++k) {
+      energy += spectrum_[k] * spectrum_[k];
+    }
+    const std::size_t bins = std::max<std::size_t>(bandEdges_[b + 1] - bandEdges_[b], 1);
+    const float value = std::sqrt(energy / bins) * amplitudeScale;
+    bandPeaks_[b] = std::max(value, bandPeaks_[b] * BAND_PEAK_DECAY);
+    features.bands[b] = value / std::max(bandPeaks_[b], 1e-4f);
+  }
+
+  // Onsets: rising spectral flux well above its recent average
+  const float meanFlux =
+      std::accumulate(fluxHistory_.begin(), fluxHistory_.end(), 0.0f) /
+      fluxHistory_.size();
+  const float threshold = meanFlux * ONSET_THRESHOLD_SCALE + ONSET_THRESHOLD_FLOOR;
+  ++framesSinceOnset_;
+  if (flux > threshold && flux >= previousFlux_ &&
+      framesSinceOnset_ >= MIN_ONSET_GAP) {
+    features.onset = true;
+    features.onsetStrength = flux / threshold - 1.0f;
+    framesSinceOnset_ = 0;
+  }
+  fluxHistory_[fluxIndex_] = flux;
+  fluxIndex_ = (fluxIndex_ + 1) % fluxHistory_.size();
+  previousFlux_ = flux;
+
+  // Never wait for the frame loop: a full ring drops this frame
+  ring_.TryPush(features);
+}
+
+} // namespace Audio
@@ -0,0 +1,185 @@
+#include "Audio/Sonifier.hpp"
+#include "Utils/Math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Audio {
+
+namespace {
+
+constexpr float TRANSIENT_SECONDS = 0.12f; // Time to fall by 1/e
+constexpr float TRANSIENT_PITCH = 1320.0f;
+constexpr float SILENCE = 1e-4f;
+
+// Equal-power pan gains
+void PanGains(float pan, float &left, float &right) {
+  const float angle = (std::clamp(pan, -1.0f, 1.0f) + 1.0f) * Utils::PI * 0.25f;
+  left = std::cos(angle);
+  right = std::sin(angle);
+}
+
+// Smooth saturation instead of hard clipping when voices pile up
+float SoftClip(float x) {
+  if (x <= -3.0f)
+    return -1.0f;
+  if (x >= 3.0f)
+    return 1.0f;
+  const float x2 = x * x;
+  return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+}
+
+} // namespace
+
+Sonifier::Sonifier(const SonifierOptions &options)
+    : options_(options), wavetable_(WAVETABLE_SIZE + 1), noise_(NOISE_SIZE) {
+  options_.sampleRate = std::max(options_.sampleRate, 8000u);
+  options_.bufferFrames = std::max<std::size_t>(options_.bufferFrames, 64);
+
+  // Fundamental with two soft overtones, normalized to a peak of 1
+  float peak = 0.0f;
+  for (std::size_t i = 0; i < WAVETABLE_SIZE; ++i) {
+    const float t = Utils::TWO_PI * i / WAVETABLE_SIZE;
+    wavetable_[i] =
+        std::sin(t) + 0.35f * std::sin(2.0f * t) + 0.15f * std::sin(3.0f * t);
+    peak = std::max(peak, std::abs(wavetable_[i]));
+  }
+  for (std::size_t i = 0; i < WAVETABLE_SIZE; ++i) {
+    wavetable_[i] /= peak;
+  }
+  wavetable_[WAVETABLE_SIZE] = wavetable_[0];
+
+  std::mt19937 rng(0x5eed);
+  std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+  for (float &sample : noise_) {
+    sample = noise(rng);
+  }
+
+  transientDecay_ =
+      std::exp(-1.0f / (TRANSIENT_SECONDS * options_.sampleRate));
+  mix_.resize(options_.bufferFrames * 2);
+  samples_.resize(options_.bufferFrames * 2);
+
+  initialize(2, options_.sampleRate);
+  // Refill well before the queued buffers run dry
+  const float bufferMs =
+      1000.0f * options_.bufferFrames / options_.sampleRate;
+  setProcessingInterval(sf::milliseconds(
+      static_cast<sf::Int32>(std::clamp(bufferMs * 0.25f, 1.0f, 10.0f))));
+}
+
+Sonifier::~Sonifier() {
+  // The stream thread calls onGetData, which needs this object intact
+  stop();
+}
+
+float Sonifier::Oscillate(float &phase, float increment) const {
+  const auto index = static_cast<std::size_t>(phase);
+  const float fraction = phase - static_cast<float>(index);
+  const float value =
+      wavetable_[index] + fraction * (wavetable_[index + 1] - wavetable_[index]);
+  phase += increment;
+  if (phase >= static_cast<float>(WAVETABLE_SIZE)) {
+    phase -= static_cast<float>(WAVETABLE_SIZE);
+  }
+  return value;
+}
+
+bool Sonifier::onGetData(Chunk &data) {
+  const SonifierParameters &target = parameters_.Read();
+  const std::size_t frames = options_.bufferFrames;
+  const float rampStep = 1.0f / static_cast<float>(frames);
+  const float tableScale =
+      static_cast<float>(WAVETABLE_SIZE) / options_.sampleRate;
+  std::fill(mix_.begin(), mix_.end(), 0.0f);
+
+  // Voices ramp from their last state to the published one over the buffer
+  for (std::size_t v = 0; v < voices_.size(); ++v) {
+    VoiceState &voice = voices_[v];
+    const bool active = v < target.voiceCount;
+    const float targetAmplitude =
+        active ? std::clamp(target.voices[v].amplitude, 0.0f, 1.0f) : 0.0f;
+    if (voice.amplitude < SILENCE && targetAmplitude < SILENCE) {
+      voice.amplitude = 0.0f;
+      continue;
+    }
+
+    float targetFrequency = voice.frequency;
+    float targetPan = voice.pan;
+    if (active) {
+      targetFrequency = std::clamp(target.voices[v].frequency, 20.0f,
+                                   0.45f * options_.sampleRate);
+      targetPan = target.voices[v].pan;
+      // A voice fading in starts at its pitch rather than gliding to it
+      if (voice.amplitude < SILENCE) {
+        voice.frequency = targetFrequency;
+        voice.pan = targetPan;
+      }
+    }
+
+    float startLeft, startRight, endLeft, endRight;
+    PanGains(voice.pan, startLeft, startRight);
+    PanGains(targetPan, endLeft, endRight);
+    const float frequencyStep = (targetFrequency - voice.frequency) * rampStep;
+    const float amplitudeStep = (targetAmplitude - voice.amplitude) * rampStep;
+    const float leftStep = (endLeft - startLeft) * rampStep;
+    const float rightStep = (endRight - startRight) * rampStep;
+
+    float frequency = voice.frequency;
+    float amplitude = voice.amplitude;
+    float left = startLeft;
+    float right = startRight;
+    for (std::size_t i = 0; i < frames; ++i) {
+      const float sample =
+          Oscillate(voice.phase, frequency * tableScale) * amplitude;
+      mix_[2 * i] += sample * left;
+      mix_[2 * i + 1] += sample * right;
+      frequency += frequencyStep;
+      amplitude += amplitudeStep;
+      left += leftStep;
+      right += rightStep;
+    }
+
+    voice.frequency = targetFrequency;
+    voice.amplitude = targetAmplitude;
+    voice.pan = targetPan;
+  }
+
+  // Close encounters: a decaying burst of noise over a high ping
+  if (target.transientSerial != transientSerial_) {
+    transientSerial_ = target.transientSerial;
+    transientEnvelope_ = std::max(
+        transientEnvelope_, std::clamp(target.transientAmplitude, 0.0f, 1.0f));
+    transientPan_ = target.transientPan;
+  }
+  if (transientEnvelope_ > SILENCE) {
+    float left, right;
+    PanGains(transientPan_, left, right);
+    const float increment = TRANSIENT_PITCH * tableScale;
+    for (std::size_t i = 0; i < frames; ++i) {
+      const float sample =
+          (0.6f * noise_[noisePosition_] +
+           0.4f * Oscillate(transientPhase_, increment)) *
+          transientEnvelope_;
+      noisePosition_ = (noisePosition_ + 1) % NOISE_SIZE;
+      mix_[2 * i] += sample * left;
+      mix_[2 * i + 1] += sample * right;
+      transientEnvelope_ *= transientDecay_;
+    }
+  }
+
+  for (std::size_t i = 0; i < mix_.size(); ++i) {
+    samples_[i] = static_cast<sf::Int16>(
+        SoftClip(mix_[i] * options_.masterGain) * 32767.0f);
+  }
+
+  data.samples = samples_.data();
+  data.sampleCount = samples_.size();
+  return true;
+}
+
+void Sonifier::onSeek(sf::Time) {
+  // Live synthesis has no position to seek to
+}
+
+} // namespace Audio
@@ -1,4 +1,5 @@
 #include "Core/Camera2D.hpp"
+#include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Core {
@@ -60,14 +61,37 @@ void Camera2D::SetSize(const glm::vec2 &size) {
   needsUpdate_ = true;
 }
 
+// Screen positions are pixels in a window of GetSize(); the view shows
+// size_ / zoom_ world units around position_, rotated by rotation_
 glm::vec2 Camera2D::ScreenToWorld(const glm::vec2 &screenPos) const {
-  // TODO: Implement proper screen to world transformation
-  return screenPos;
+  const glm::vec2 offset = (screenPos - size_ * 0.5f) / zoom_;
+  const float angle = glm::radians(rotation_);
+  const float c = std::cos(angle);
+  const float s = std::sin(angle);
+  return position_ + glm::vec2(c * offset.x - s * offset.y,
+                               s * offset.x + c * offset.y);
 }
 
 glm::vec2 Camera2D::WorldToScreen(const glm::vec2 &worldPos) const {
-  // TODO: Implement proper world to screen transformation
-  return worldPos;
+  const glm::vec2 offset = worldPos - position_;
+  const float angle = glm::radians(rotation_);
+  const float c = std::cos(angle);
+  const float s = std::sin(angle);
+  return glm::vec2(c * offset.x + s * offset.y, -s * offset.x + c * offset.y) *
+             zoom_ +
+         size_ * 0.5f;
+}
+
+void Camera2D::GetWorldBounds(glm::vec2 &min, glm::vec2 &max) const {
+  const glm::vec2 corners[] = {ScreenToWorld({0.0f, 0.0f}),
+                               ScreenToWorld({size_.x, 0.0f}),
+                               ScreenToWorld({0.0f, size_.y}),
+                               ScreenToWorld(size_)};
+  min = max = corners[0];
+  for (const auto &corner : corners) {
+    min = glm::min(min, corner);
+    max = glm::max(max, corner);
+  }
 }
 
 void Camera2D::Update() {
@@ -2,6 +2,7 @@
 #include "Core/Renderer.hpp"
 #include "Core/VisualMode.hpp"
 #include "Input/InputManager.hpp"
+#include "Utils/FlightRecorder.hpp"
 #include "Utils/PerformanceProfiler.hpp"
 #include <algorithm>
 
@@ -44,6 +45,18 @@ bool DisplaySystem::Initialize(const DisplayConfig &config) {
   // Initialize renderer
   renderer_ = std::make_unique<Renderer>(window_);
 
+  // Slow frames are judged against the configured frame rate
+  FlightRecorderSettings recorderSettings;
+  if (config.framerate_limit > 0 && !config.vsync) {
+    recorderSettings.frameBudget = 1.0f / config.framerate_limit;
+  }
+  recorderSettings.outputDirectory = config.hitch_directory;
+
+  auto &recorder = FlightRecorder::GetInstance();
+  recorder.Configure(recorderSettings);
+  recorder.SetEnabled(config.flight_recorder);
+  recorder.SetThreadName("Main");
+
   // Setup input event handlers
   inputManager_->RegisterEventHandler(
       InputEvent::Type::KeyPressed, [this](const InputEvent &event) {
@@ -56,6 +69,7 @@ bool DisplaySystem::Initialize(const DisplayConfig &config) {
             currentModeIndex_ = modeIndex;
             if (visualModes_[currentModeIndex_]) {
               visualModes_[currentModeIndex_]->OnActivate();
+              visualModes_[currentModeIndex_]->MarkSceneDirty();
             }
           }
         }
@@ -82,14 +96,26 @@ void DisplaySystem::Run() {
     visualModes_[currentModeIndex_]->OnActivate();
   }
 
+  auto &recorder = FlightRecorder::GetInstance();
+
   while (isRunning_ && window_.isOpen()) {
+    // Nothing changes until input arrives; don't count the wait as a frame
+    if (CanSleep()) {
+      WaitForEvents();
+      continue;
+    }
+
     profiler_->BeginFrame();
+    recorder.BeginFrame();
 
     ProcessEvents();
     Update(deltaTime_);
     Render();
 
     profiler_->EndFrame();
+    if (recorder.EndFrame()) {
+      recorder.DumpAsync(GetTraceContext());
+    }
     UpdatePerformanceMetrics();
   }
 }
@@ -104,6 +130,9 @@ void DisplaySystem::Shutdown() {
       visualModes_[currentModeIndex_]->OnDeactivate();
     }
 
+    // While the modes, and any pool they attached, are still alive
+    profiler_->GenerateReport();
+
     // Clean up modes
     visualModes_.clear();
     modeIndices_.clear();
@@ -154,6 +183,7 @@ bool DisplaySystem::SwitchMode(const std::string &modeName) {
   // Activate new mode
   if (visualModes_[currentModeIndex_]) {
     visualModes_[currentModeIndex_]->OnActivate();
+    visualModes_[currentModeIndex_]->MarkSceneDirty();
     spdlog::info("Switched to mode: {}", modeName);
   }
 
@@ -163,62 +193,101 @@ bool DisplaySystem::SwitchMode(const std::string &modeName) {
 void DisplaySystem::ProcessEvents() {
   sf::Event event;
   while (window_.pollEvent(event)) {
-    if (event.type == sf::Event::Closed) {
-      isRunning_ = false;
-    }
+    HandleEvent(event);
+  }
+}
 
-    inputManager_->ProcessEvent(event);
+bool DisplaySystem::CanSleep() const {
+  if (currentModeIndex_ >= visualModes_.size() ||
+      !visualModes_[currentModeIndex_])
+    return false;
 
-    // Pass input to current visual mode
-    if (currentModeIndex_ < visualModes_.size() &&
-        visualModes_[currentModeIndex_]) {
-      InputEvent inputEvent;
-
-      switch (event.type) {
-      case sf::Event::KeyPressed:
-        inputEvent.type = InputEvent::Type::KeyPressed;
-        inputEvent.key.code = event.key.code;
-        inputEvent.key.alt = event.key.alt;
-        inputEvent.key.control = event.key.control;
-        inputEvent.key.shift = event.key.shift;
-        inputEvent.key.system = event.key.system;
-        visualModes_[currentModeIndex_]->HandleInput(inputEvent);
-        break;
-
-      case sf::Event::MouseButtonPressed:
-        inputEvent.type = InputEvent::Type::MouseButtonPressed;
-        inputEvent.mouseButton.button = event.mouseButton.button;
-        inputEvent.mouseButton.position =
-            glm::vec2(event.mouseButton.x, event.mouseButton.y);
-        visualModes_[currentModeIndex_]->HandleInput(inputEvent);
-        break;
-
-      case sf::Event::MouseMoved:
-        inputEvent.type = InputEvent::Type::MouseMoved;
-        inputEvent.mouseMove.position =
-            glm::vec2(event.mouseMove.x, event.mouseMove.y);
-        visualModes_[currentModeIndex_]->HandleInput(inputEvent);
-        break;
-
-      case sf::Event::MouseWheelScrolled:
-        inputEvent.type = InputEvent::Type::MouseWheelScrolled;
-        inputEvent.mouseWheel.delta = event.mouseWheelScroll.delta;
-        inputEvent.mouseWheel.position =
-            glm::vec2(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
-        visualModes_[currentModeIndex_]->HandleInput(inputEvent);
-        break;
-
-      case sf::Event::Resized:
-        inputEvent.type = InputEvent::Type::WindowResized;
-        inputEvent.size.width = event.size.width;
-        inputEvent.size.height = event.size.height;
-        visualModes_[currentModeIndex_]->OnResize(event.size.width,
-                                                  event.size.height);
-        break;
-
-      default:
-        break;
-      }
+  const auto &mode = *visualModes_[currentModeIndex_];
+  return mode.IsIdle() && renderer_->HasCachedScene() &&
+         !mode.IsSceneDirty() && !mode.IsHUDDirty();
+}
+
+void DisplaySystem::WaitForEvents() {
+  sf::Event event;
+  if (window_.waitEvent(event)) {
+    HandleEvent(event);
+  }
+  ProcessEvents();
+
+  // The time spent waiting is not simulation time
+  lastFrameTime_ = std::chrono::steady_clock::now();
+}
+
+void DisplaySystem::HandleEvent(const sf::Event &event) {
+  if (event.type == sf::Event::Closed) {
+    isRunning_ = false;
+  }
+
+  inputManager_->ProcessEvent(event);
+
+  // Pass input to current visual mode
+  if (currentModeIndex_ < visualModes_.size() &&
+      visualModes_[currentModeIndex_]) {
+    InputEvent inputEvent;
+
+    switch (event.type) {
+    case sf::Event::KeyPressed:
+      inputEvent.type = InputEvent::Type::KeyPressed;
+      inputEvent.key.code = event.key.code;
+      inputEvent.key.alt = event.key.alt;
+      inputEvent.key.control = event.key.control;
+      inputEvent.key.shift = event.key.shift;
+      inputEvent.key.system = event.key.system;
+      visualModes_[currentModeIndex_]->HandleInput(inputEvent);
+      break;
+
+    case sf::Event::MouseButtonPressed:
+      inputEvent.type = InputEvent::Type::MouseButtonPressed;
+      inputEvent.mouseButton.button = event.mouseButton.button;
+      inputEvent.mouseButton.position =
+          glm::vec2(event.mouseButton.x, event.mouseButton.y);
+      visualModes_[currentModeIndex_]->HandleInput(inputEvent);
+      break;
+
+    case sf::Event::MouseButtonReleased:
+      inputEvent.type = InputEvent::Type::MouseButtonReleased;
+      inputEvent.mouseButton.button = event.mouseButton.button;
+      inputEvent.mouseButton.position =
+          glm::vec2(event.mouseButton.x, event.mouseButton.y);
+      visualModes_[currentModeIndex_]->HandleInput(inputEvent);
+      break;
+
+    case sf::Event::MouseMoved:
+      inputEvent.type = InputEvent::Type::MouseMoved;
+      inputEvent.mouseMove.position =
+          glm::vec2(event.mouseMove.x, event.mouseMove.y);
+      visualModes_[currentModeIndex_]->HandleInput(inputEvent);
+      break;
+
+    case sf::Event::MouseWheelScrolled:
+      inputEvent.type = InputEvent::Type::MouseWheelScrolled;
+      inputEvent.mouseWheel.delta = event.mouseWheelScroll.delta;
+      inputEvent.mouseWheel.position =
+          glm::vec2(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+      visualModes_[currentModeIndex_]->HandleInput(inputEvent);
+      break;
+
+    case sf::Event::Resized:
+      inputEvent.type = InputEvent::Type::WindowResized;
+      inputEvent.size.width = event.size.width;
+      inputEvent.size.height = event.size.height;
+      visualModes_[currentModeIndex_]->OnResize(event.size.width,
+                                                event.size.height);
+      visualModes_[currentModeIndex_]->MarkSceneDirty();
+      break;
+
+    case sf::Event::GainedFocus:
+      // Some compositors drop the contents of uncovered windows
+      visualModes_[currentModeIndex_]->MarkHUDDirty();
+      break;
+
+    default:
+      break;
     }
   }
 }
@@ -242,10 +311,22 @@ void DisplaySystem::Render() {
 
   renderer_->BeginFrame();
 
-  // Render current visual mode
+  // Render current visual mode. Idle modes draw their scene once and then
+  // redraw only the HUD over the cached copy.
   if (currentModeIndex_ < visualModes_.size() &&
       visualModes_[currentModeIndex_]) {
-    visualModes_[currentModeIndex_]->Render(window_);
+    auto &mode = *visualModes_[currentModeIndex_];
+    if (!mode.IsIdle()) {
+      renderer_->InvalidateCachedScene();
+      mode.Render(window_);
+    } else if (mode.IsSceneDirty() || !renderer_->HasCachedScene()) {
+      mode.Render(window_);
+      renderer_->CaptureScene();
+    } else {
+      renderer_->DrawCachedScene();
+    }
+    mode.RenderHUD(window_);
+    mode.ClearDamage();
   }
 
   renderer_->EndFrame();
@@ -253,6 +334,21 @@ void DisplaySystem::Render() {
   profiler_->EndSection("Render");
 }
 
+TraceContext DisplaySystem::GetTraceContext() const {
+  TraceContext context;
+  context.emplace_back("averageFps", std::to_string(profiler_->GetAverageFPS()));
+
+  if (currentModeIndex_ < visualModes_.size() &&
+      visualModes_[currentModeIndex_]) {
+    const auto &mode = *visualModes_[currentModeIndex_];
+    context.emplace_back("mode", mode.GetName());
+
+    auto modeContext = mode.GetTraceContext();
+    context.insert(context.end(), modeContext.begin(), modeContext.end());
+  }
+  return context;
+}
+
 void DisplaySystem::UpdatePerformanceMetrics() {
   auto currentTime = std::chrono::steady_clock::now();
   auto elapsed = std::chrono::duration_cast<std::chrono::duration<float>>(
@@ -0,0 +1,196 @@
+#include "Core/ExecutionBackend.hpp"
+#include "Core/ThreadPool.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <spdlog/spdlog.h>
+
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#if defined(__cpp_lib_parallel_algorithm)
+#define CORE_HAS_STD_PARALLEL 1
+#else
+#define CORE_HAS_STD_PARALLEL 0
+#endif
+
+namespace Core {
+
+namespace {
+
+std::size_t ChunkCount(std::size_t count, std::size_t chunkSize) {
+  return (count + chunkSize - 1) / chunkSize;
+}
+
+class ThreadPoolBackend : public ExecutionBackend {
+public:
+  explicit ThreadPoolBackend(ThreadPool &threadPool)
+      : threadPool_(threadPool) {}
+
+  void ForEachChunk(std::size_t count, std::size_t chunkSize,
+                    const ChunkFunction &func) override {
+    // Every pass behind this interface is on the frame's critical path
+    threadPool_.ParallelFor(count, chunkSize, func, TaskPriority::Critical);
+  }
+
+  ExecutionBackendType GetType() const override {
+    return ExecutionBackendType::ThreadPool;
+  }
+
+private:
+  ThreadPool &threadPool_;
+};
+
+#if CORE_HAS_STD_PARALLEL
+// par rather than par_unseq: chunk bodies trace, which can lock, and may
+// allocate; neither is allowed in unsequenced element accesses. Chunks are
+// large, so interleaving them would gain nothing. With libstdc++ this runs on
+// TBB when it is linked and serially otherwise.
+class StdParallelBackend : public ExecutionBackend {
+public:
+  void ForEachChunk(std::size_t count, std::size_t chunkSize,
+                    const ChunkFunction &func) override {
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    // Per call, since passes may share the backend across threads. A
+    // std::views::iota range would avoid the allocation, but its iterators
+    // are only input iterators, which parallel algorithms do not accept.
+    std::vector<std::size_t> chunks(ChunkCount(count, chunkSize));
+    std::iota(chunks.begin(), chunks.end(), std::size_t{0});
+
+    std::for_each(std::execution::par, chunks.begin(), chunks.end(),
+                  [&](std::size_t chunk) {
+                    std::size_t begin = chunk * chunkSize;
+                    func(begin, std::min(begin + chunkSize, count));
+                  });
+  }
+
+  ExecutionBackendType GetType() const override {
+    return ExecutionBackendType::StdParallel;
+  }
+};
+#endif
+
+#if defined(_OPENMP)
+class OpenMPBackend : public ExecutionBackend {
+public:
+  void ForEachChunk(std::size_t count, std::size_t chunkSize,
+                    const ChunkFunction &func) override {
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    const auto chunkCount = static_cast<std::int64_t>(ChunkCount(count, chunkSize));
+
+#pragma omp parallel for schedule(dynamic)
+    for (std::int64_t chunk = 0; chunk < chunkCount; ++chunk) {
+      std::size_t begin = static_cast<std::size_t>(chunk) * chunkSize;
+      func(begin, std::min(begin + chunkSize, count));
+    }
+  }
+
+  ExecutionBackendType GetType() const override {
+    return ExecutionBackendType::OpenMP;
+  }
+};
+#endif
+
+class SerialBackend : public ExecutionBackend {
+public:
+  void ForEachChunk(std::size_t count, std::size_t chunkSize,
+                    const ChunkFunction &func) override {
+    chunkSize = std::max<std::size_t>(chunkSize, 1);
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+      func(begin, std::min(begin + chunkSize, count));
+    }
+  }
+
+  ExecutionBackendType GetType() const override {
+    return ExecutionBackendType::Serial;
+  }
+};
+
+} // namespace
+
+std::string ToString(ExecutionBackendType type) {
+  switch (type) {
+  case ExecutionBackendType::ThreadPool:
+    return "pool";
+  case ExecutionBackendType::StdParallel:
+#if defined(VISUALIZER_HAS_TBB)
+    return "std::execution (TBB)";
+#else
+    return "std::execution";
+#endif
+  case ExecutionBackendType::OpenMP:
+    return "openmp";
+  case ExecutionBackendType::Serial:
+    return "serial";
+  }
+  return "unknown";
+}
+
+std::optional<ExecutionBackendType> ParseExecutionBackend(std::string_view name) {
+  if (name == "pool")
+    return ExecutionBackendType::ThreadPool;
+  if (name == "std")
+    return ExecutionBackendType::StdParallel;
+  if (name == "openmp")
+    return ExecutionBackendType::OpenMP;
+  if (name == "serial")
+    return ExecutionBackendType::Serial;
+  return std::nullopt;
+}
+
+bool IsExecutionBackendAvailable(ExecutionBackendType type) {
+  switch (type) {
+  case ExecutionBackendType::StdParallel:
+    return CORE_HAS_STD_PARALLEL;
+  case ExecutionBackendType::OpenMP:
+#if defined(_OPENMP)
+    return true;
+#else
+    return false;
+#endif
+  default:
+    return true;
+  }
+}
+
+std::vector<ExecutionBackendType> GetAvailableExecutionBackends() {
+  std::vector<ExecutionBackendType> backends;
+  for (auto type :
+       {ExecutionBackendType::ThreadPool, ExecutionBackendType::StdParallel,
+        ExecutionBackendType::OpenMP, ExecutionBackendType::Serial}) {
+    if (IsExecutionBackendAvailable(type)) {
+      backends.push_back(type);
+    }
+  }
+  return backends;
+}
+
+std::unique_ptr<ExecutionBackend>
+CreateExecutionBackend(ExecutionBackendType type, ThreadPool &threadPool) {
+  switch (type) {
+#if CORE_HAS_STD_PARALLEL
+  case ExecutionBackendType::StdParallel:
+    return std::make_unique<StdParallelBackend>();
+#endif
+#if defined(_OPENMP)
+  case ExecutionBackendType::OpenMP:
+    return std::make_unique<OpenMPBackend>();
+#endif
+  case ExecutionBackendType::Serial:
+    return std::make_unique<SerialBackend>();
+  case ExecutionBackendType::ThreadPool:
+    return std::make_unique<ThreadPoolBackend>(threadPool);
+  default:
+    spdlog::warn("Execution backend '{}' is not available in this build; "
+                 "using the thread pool",
+                 ToString(type));
+    return std::make_unique<ThreadPoolBackend>(threadPool);
+  }
+}
+
+} // namespace Core
@@ -0,0 +1,180 @@
+#include "Core/LargeBufferAllocator.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Utils/FlightRecorder.hpp"
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define CORE_HAS_LARGE_PAGES 1
+#else
+#define CORE_HAS_LARGE_PAGES 0
+#endif
+
+namespace Core {
+
+namespace {
+
+constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+std::atomic<PagePolicy> requestedPolicy{PagePolicy::TransparentHugePages};
+std::atomic<PagePolicy> effectivePolicy{PagePolicy::Default};
+std::atomic<ThreadPool *> firstTouchPool{nullptr};
+std::atomic<int> reportedPolicy{-1};
+std::atomic<bool> reportedHugeTlbFailure{false};
+
+#if CORE_HAS_LARGE_PAGES
+std::size_t RoundUpToHugePage(std::size_t bytes) {
+  return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+// The kernel lists the modes with the active one in brackets, e.g.
+// "always [madvise] never"
+bool TransparentHugePagesAvailable() {
+  static const bool available = [] {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string modes;
+    std::getline(file, modes);
+    return !modes.empty() && modes.find("[never]") == std::string::npos;
+  }();
+  return available;
+}
+
+// Writes one byte per page so each page is faulted in by the thread that
+// touches it. Chunks are one huge page, the unit the kernel places on a
+// NUMA node when huge pages are in use.
+void FirstTouch(char *data, std::size_t bytes) {
+  const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  auto touch = [data, pageSize](std::size_t beginChunk, std::size_t endChunk) {
+    for (std::size_t chunk = beginChunk; chunk < endChunk; ++chunk) {
+      char *chunkStart = data + chunk * HUGE_PAGE_SIZE;
+      for (std::size_t offset = 0; offset < HUGE_PAGE_SIZE; offset += pageSize) {
+        chunkStart[offset] = 0;
+      }
+    }
+  };
+
+  const std::size_t chunkCount = bytes / HUGE_PAGE_SIZE;
+  // A pool task waiting on its own pool could wait forever
+  ThreadPool *pool = firstTouchPool.load();
+  if (pool && !ThreadPool::IsWorkerThread()) {
+    pool->ParallelFor(chunkCount, 1, touch);
+  } else {
+    touch(0, chunkCount);
+  }
+}
+
+void *MapAligned(std::size_t bytes) {
+  // Over-map by one huge page so the buffer can start on a 2 MB boundary
+  const std::size_t span = bytes + HUGE_PAGE_SIZE;
+  void *raw = mmap(nullptr, span, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) {
+    return nullptr;
+  }
+
+  auto address = reinterpret_cast<std::uintptr_t>(raw);
+  auto aligned = (address + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+  const std::size_t head = aligned - address;
+  const std::size_t tail = span - head - bytes;
+  if (head > 0) {
+    munmap(raw, head);
+  }
+  if (tail > 0) {
+    munmap(reinterpret_cast<char *>(aligned) + bytes, tail);
+  }
+  return reinterpret_cast<void *>(aligned);
+}
+#endif
+
+void ReportPolicy(PagePolicy policy) {
+  if (reportedPolicy.exchange(static_cast<int>(policy)) ==
+      static_cast<int>(policy))
+    return;
+
+  ThreadPool *pool = firstTouchPool.load();
+  spdlog::info("Large particle buffers use {}, first-touched by {}",
+               ToString(policy),
+               pool ? std::to_string(pool->GetNumThreads()) + " pool workers"
+                    : std::string("the allocating thread"));
+}
+
+} // namespace
+
+std::string ToString(PagePolicy policy) {
+  switch (policy) {
+  case PagePolicy::Default:
+    return "regular pages";
+  case PagePolicy::TransparentHugePages:
+    return "transparent huge pages";
+  case PagePolicy::HugeTLB:
+    return "HugeTLB pages";
+  }
+  return "unknown";
+}
+
+void ConfigureLargeBuffers(PagePolicy policy) {
+  requestedPolicy = policy;
+}
+
+void SetFirstTouchPool(ThreadPool *threadPool) { firstTouchPool = threadPool; }
+
+PagePolicy GetEffectivePagePolicy() { return effectivePolicy.load(); }
+
+void *AllocateLargeBuffer(std::size_t bytes) {
+#if CORE_HAS_LARGE_PAGES
+  const std::size_t mapped = RoundUpToHugePage(bytes);
+  PagePolicy policy = requestedPolicy.load();
+  void *data = nullptr;
+
+  if (policy == PagePolicy::HugeTLB) {
+    data = mmap(nullptr, mapped, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data == MAP_FAILED) {
+      data = nullptr;
+      policy = PagePolicy::TransparentHugePages;
+      if (!reportedHugeTlbFailure.exchange(true)) {
+        spdlog::warn("MAP_HUGETLB failed (is vm.nr_hugepages set?); falling "
+                     "back to transparent huge pages");
+      }
+    }
+  }
+
+  if (!data) {
+    data = MapAligned(mapped);
+    if (!data) {
+      throw std::bad_alloc();
+    }
+    if (policy == PagePolicy::TransparentHugePages &&
+        (!TransparentHugePagesAvailable() ||
+         madvise(data, mapped, MADV_HUGEPAGE) != 0)) {
+      policy = PagePolicy::Default;
+    }
+  }
+
+  FirstTouch(static_cast<char *>(data), mapped);
+#else
+  PagePolicy policy = PagePolicy::Default;
+  void *data = ::operator new(bytes, std::align_val_t{HUGE_PAGE_SIZE});
+#endif
+
+  effectivePolicy = policy;
+  ReportPolicy(policy);
+  FlightRecorder::GetInstance().RecordAllocation("LargeBuffer", bytes);
+  return data;
+}
+
+void DeallocateLargeBuffer(void *pointer, std::size_t bytes) noexcept {
+  if (!pointer)
+    return;
+#if CORE_HAS_LARGE_PAGES
+  munmap(pointer, RoundUpToHugePage(bytes));
+#else
+  ::operator delete(pointer, std::align_val_t{HUGE_PAGE_SIZE});
+#endif
+}
+
+} // namespace Core
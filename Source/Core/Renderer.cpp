@@ -1,16 +1,14 @@
 #include "Core/Renderer.hpp"
 #include "Core/Camera2D.hpp"
-#include "Graphics/ParticleSystem.hpp"
 #include <spdlog/spdlog.h>
 
 namespace Core {
 
 Renderer::Renderer(sf::RenderWindow &window)
     : window_(window), camera_(std::make_unique<Camera2D>()),
-      vertexArray_(sf::PrimitiveType::Quads), vertices_(), renderTexture_(),
-      renderSprite_(), currentBlendMode_(sf::BlendAlpha) {
-
-  vertices_.reserve(MAX_BATCH_SIZE * 4);
+      particleBackend_(Graphics::CreateParticleRenderBackend(
+          Graphics::ParticleRenderBackendType::Quads)),
+      renderTexture_(), renderSprite_(), currentBlendMode_(sf::BlendAlpha) {
 
   // Create render texture for post-processing
   auto size = window_.getSize();
@@ -24,41 +22,37 @@ Renderer::~Renderer() = default;
 
 void Renderer::BeginFrame() {
   window_.clear(sf::Color::Black);
-  vertices_.clear();
-}
-
-void Renderer::EndFrame() {
-  FlushBatch();
-  window_.display();
 }
 
-void Renderer::DrawParticles(std::span<const Graphics::Particle> particles) {
-  for (const auto &particle : particles) {
-    if (!particle.active)
-      continue;
+void Renderer::EndFrame() { window_.display(); }
 
-    sf::Vector2f pos(particle.position.x, particle.position.y);
-    float halfSize = particle.size * 0.5f;
-
-    // Create quad for particle
-    sf::Vertex v1, v2, v3, v4;
-
-    v1.position = pos + sf::Vector2f(-halfSize, -halfSize);
-    v2.position = pos + sf::Vector2f(halfSize, -halfSize);
-    v3.position = pos + sf::Vector2f(halfSize, halfSize);
-    v4.position = pos + sf::Vector2f(-halfSize, halfSize);
+void Renderer::CaptureScene() {
+  auto size = window_.getSize();
+  if (sceneCache_.getSize() != size && !sceneCache_.create(size.x, size.y)) {
+    spdlog::error("Failed to create scene cache texture");
+    hasCachedScene_ = false;
+    return;
+  }
+  sceneCache_.update(window_);
+  hasCachedScene_ = true;
+}
 
-    v1.color = v2.color = v3.color = v4.color = particle.color;
+void Renderer::DrawCachedScene() {
+  sf::View view = window_.getView();
+  window_.setView(window_.getDefaultView());
+  window_.draw(sf::Sprite(sceneCache_));
+  window_.setView(view);
+}
 
-    vertices_.push_back(v1);
-    vertices_.push_back(v2);
-    vertices_.push_back(v3);
-    vertices_.push_back(v4);
+void Renderer::DrawParticles(std::span<const Graphics::Particle> particles) {
+  sf::RenderStates states;
+  states.blendMode = currentBlendMode_;
+  particleBackend_->Draw(particles, window_, states);
+}
 
-    if (vertices_.size() >= MAX_BATCH_SIZE * 4) {
-      FlushBatch();
-    }
-  }
+void Renderer::SetParticleRenderBackend(
+    Graphics::ParticleRenderBackendType type) {
+  particleBackend_ = Graphics::CreateParticleRenderBackend(type);
 }
 
 void Renderer::DrawText(const std::string &text, const glm::vec2 &position,
@@ -128,22 +122,6 @@ void Renderer::SetBlendMode(sf::BlendMode mode) { currentBlendMode_ = mode; }
 
 void Renderer::ResetBlendMode() { currentBlendMode_ = sf::BlendAlpha; }
 
-void Renderer::FlushBatch() {
-  if (vertices_.empty())
-    return;
-
-  vertexArray_.clear();
-  for (const auto &vertex : vertices_) {
-    vertexArray_.append(vertex);
-  }
-
-  sf::RenderStates states;
-  states.blendMode = currentBlendMode_;
-
-  window_.draw(vertexArray_, states);
-  vertices_.clear();
-}
-
 void Renderer::DrawMesh(const Graphics::Mesh &mesh,
                         const Transform &transform) {
   // TODO: Implement mesh rendering
@@ -1,16 +1,84 @@
 #include "Core/ThreadPool.hpp"
+#include "Utils/FlightRecorder.hpp"
+#include <bit>
+#include <cmath>
 #include <spdlog/spdlog.h>
 
 namespace Core {
 
+namespace {
+
+using Nanoseconds = std::chrono::nanoseconds;
+
+thread_local bool isWorkerThread = false;
+
+std::uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point from,
+                                 std::chrono::steady_clock::time_point to) {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<Nanoseconds>(to - from).count());
+}
+
+// Counters with a single writer need no read-modify-write
+void Add(std::atomic<std::uint64_t> &counter, std::uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+std::size_t LatencyBucket(std::uint64_t nanoseconds) {
+  const std::uint64_t microseconds = nanoseconds / 1000;
+  return std::min<std::size_t>(std::bit_width(microseconds),
+                               ThreadPoolMetrics::LATENCY_BUCKETS - 1);
+}
+
+} // namespace
+
+double ThreadPoolMetrics::GetUtilization() const {
+  double busy = 0.0;
+  for (const auto &worker : workers) {
+    busy += worker.busySeconds;
+  }
+  const double capacity = wallSeconds * static_cast<double>(workers.size());
+  return capacity > 0.0 ? busy / capacity : 0.0;
+}
+
+double ThreadPoolMetrics::GetLatencyPercentile(double fraction) const {
+  std::uint64_t total = 0;
+  for (auto count : startLatency) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0.0;
+  }
+
+  const auto target = static_cast<std::uint64_t>(
+      std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total)));
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < LATENCY_BUCKETS; ++bucket) {
+    seen += startLatency[bucket];
+    if (seen >= std::max<std::uint64_t>(target, 1)) {
+      return static_cast<double>(std::uint64_t{1} << bucket);
+    }
+  }
+  return static_cast<double>(std::uint64_t{1} << (LATENCY_BUCKETS - 1));
+}
+
+double ThreadPoolMetrics::GetLockWaitSeconds() const {
+  double seconds = submitLockWaitSeconds;
+  for (const auto &worker : workers) {
+    seconds += worker.lockWaitSeconds;
+  }
+  return seconds;
+}
+
 ThreadPool::ThreadPool(std::size_t numThreads)
     : workers_(), tasks_(), queueMutex_(), condition_(), finished_(),
-      stopping_(false), activeTasks_(0) {
+      stopping_(false),
+      workerCounters_(std::make_unique<WorkerCounters[]>(numThreads)) {
 
   workers_.reserve(numThreads);
 
   for (std::size_t i = 0; i < numThreads; ++i) {
-    workers_.emplace_back([this] { WorkerThread(); });
+    workers_.emplace_back([this, i] { WorkerThread(i); });
   }
 
   spdlog::info("ThreadPool created with {} threads", numThreads);
@@ -23,6 +91,7 @@ ThreadPool::~ThreadPool() {
   }
 
   condition_.notify_all();
+  criticalCondition_.notify_all();
 
   for (auto &worker : workers_) {
     if (worker.joinable()) {
@@ -33,45 +102,170 @@ ThreadPool::~ThreadPool() {
   spdlog::info("ThreadPool destroyed");
 }
 
-void ThreadPool::WorkerThread() {
+std::unique_lock<std::mutex>
+ThreadPool::LockQueue(std::atomic<std::uint64_t> &waitNanoseconds) {
+  // Uncontended locks are not timed
+  std::unique_lock<std::mutex> lock(queueMutex_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    const auto start = Clock::now();
+    lock.lock();
+    waitNanoseconds.fetch_add(ElapsedNanoseconds(start, Clock::now()),
+                              std::memory_order_relaxed);
+  }
+  return lock;
+}
+
+void ThreadPool::OnEnqueued() {
+  const std::size_t depth = queuedTasks_.load(std::memory_order_relaxed) + 1;
+  queuedTasks_.store(depth, std::memory_order_relaxed);
+  pendingTasks_.store(pendingTasks_.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+  tasksSubmitted_.store(tasksSubmitted_.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+  if (depth > queueDepthHighWater_.load(std::memory_order_relaxed)) {
+    queueDepthHighWater_.store(depth, std::memory_order_relaxed);
+  }
+}
+
+std::queue<ThreadPool::QueuedTask> *
+ThreadPool::NextQueue(bool criticalOnly) {
+  const std::size_t lanes = criticalOnly ? 1 : TASK_PRIORITY_COUNT;
+  for (std::size_t lane = 0; lane < lanes; ++lane) {
+    if (!tasks_[lane].empty()) {
+      return &tasks_[lane];
+    }
+  }
+  return nullptr;
+}
+
+void ThreadPool::WorkerThread(std::size_t index) {
+  isWorkerThread = true;
+  auto &recorder = FlightRecorder::GetInstance();
+  recorder.SetThreadName("ThreadPool worker");
+  auto &counters = workerCounters_[index];
+
   while (true) {
     std::function<void()> task;
+    Clock::time_point started;
 
     {
-      std::unique_lock<std::mutex> lock(queueMutex_);
+      auto lock = LockQueue(counters.lockWaitNanoseconds);
 
-      condition_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
-
-      if (stopping_ && tasks_.empty()) {
-        return;
+      // Re-evaluated on every wake, as the reservation can change
+      while (true) {
+        const bool reserved = index < reservedWorkers_;
+        if (auto *queue = NextQueue(reserved)) {
+          started = Clock::now();
+          Add(counters.startLatency[LatencyBucket(
+                  ElapsedNanoseconds(queue->front().submitted, started))],
+              1);
+          task = std::move(queue->front().func);
+          queue->pop();
+          queuedTasks_.store(queuedTasks_.load(std::memory_order_relaxed) - 1,
+                             std::memory_order_relaxed);
+          break;
+        }
+        if (stopping_) {
+          return;
+        }
+        const auto idleStart = Clock::now();
+        (reserved ? criticalCondition_ : condition_).wait(lock);
+        Add(counters.idleNanoseconds,
+            ElapsedNanoseconds(idleStart, Clock::now()));
       }
-
-      task = std::move(tasks_.front());
-      tasks_.pop();
-      ++activeTasks_;
     }
 
+    recorder.Record(TraceEventType::TaskBegin, "ThreadPool task");
     task();
+    recorder.Record(TraceEventType::TaskEnd, "ThreadPool task");
+    Add(counters.busyNanoseconds, ElapsedNanoseconds(started, Clock::now()));
+    Add(counters.tasks, 1);
 
     {
-      std::unique_lock<std::mutex> lock(queueMutex_);
-      --activeTasks_;
-
-      if (tasks_.empty() && activeTasks_ == 0) {
+      auto lock = LockQueue(counters.lockWaitNanoseconds);
+      const std::size_t pending =
+          pendingTasks_.load(std::memory_order_relaxed) - 1;
+      pendingTasks_.store(pending, std::memory_order_relaxed);
+      if (pending == 0) {
         finished_.notify_all();
       }
     }
   }
 }
 
+bool ThreadPool::IsWorkerThread() noexcept { return isWorkerThread; }
+
+void ThreadPool::SetReservedWorkers(std::size_t count) {
+  {
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    reservedWorkers_ =
+        std::min(count, workers_.empty() ? 0 : workers_.size() - 1);
+  }
+  condition_.notify_all();
+  criticalCondition_.notify_all();
+  spdlog::info("ThreadPool reserves {} of {} workers for critical tasks",
+               reservedWorkers_.load(), workers_.size());
+}
+
 void ThreadPool::WaitForAll() {
   std::unique_lock<std::mutex> lock(queueMutex_);
-  finished_.wait(lock, [this] { return tasks_.empty() && activeTasks_ == 0; });
+  finished_.wait(lock, [this] { return pendingTasks_ == 0; });
 }
 
-std::size_t ThreadPool::GetNumPendingTasks() const {
-  std::unique_lock<std::mutex> lock(queueMutex_);
-  return tasks_.size() + activeTasks_;
+ThreadPoolMetrics ThreadPool::ReadCounters() const {
+  constexpr double NANOSECONDS = 1e-9;
+  ThreadPoolMetrics metrics;
+  metrics.workers.resize(workers_.size());
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    const auto &counters = workerCounters_[i];
+    auto &worker = metrics.workers[i];
+    worker.busySeconds =
+        static_cast<double>(counters.busyNanoseconds.load()) * NANOSECONDS;
+    worker.idleSeconds =
+        static_cast<double>(counters.idleNanoseconds.load()) * NANOSECONDS;
+    worker.lockWaitSeconds =
+        static_cast<double>(counters.lockWaitNanoseconds.load()) *
+        NANOSECONDS;
+    worker.tasks = counters.tasks.load();
+    for (std::size_t b = 0; b < ThreadPoolMetrics::LATENCY_BUCKETS; ++b) {
+      metrics.startLatency[b] += counters.startLatency[b].load();
+    }
+  }
+  metrics.tasksSubmitted = tasksSubmitted_.load();
+  metrics.submitLockWaitSeconds =
+      static_cast<double>(submitLockWait_.load()) * NANOSECONDS;
+  metrics.queueDepth = queuedTasks_.load();
+  metrics.queueDepthHighWater = queueDepthHighWater_.load();
+  return metrics;
+}
+
+ThreadPoolMetrics ThreadPool::GetMetrics() const {
+  ThreadPoolMetrics metrics = ReadCounters();
+
+  std::lock_guard<std::mutex> lock(metricsMutex_);
+  const auto &base = metricsBaseline_;
+  metrics.wallSeconds =
+      std::chrono::duration<double>(Clock::now() - metricsEpoch_).count();
+  for (std::size_t i = 0; i < base.workers.size(); ++i) {
+    auto &worker = metrics.workers[i];
+    worker.busySeconds -= base.workers[i].busySeconds;
+    worker.idleSeconds -= base.workers[i].idleSeconds;
+    worker.lockWaitSeconds -= base.workers[i].lockWaitSeconds;
+    worker.tasks -= base.workers[i].tasks;
+  }
+  for (std::size_t b = 0; b < ThreadPoolMetrics::LATENCY_BUCKETS; ++b) {
+    metrics.startLatency[b] -= base.startLatency[b];
+  }
+  metrics.tasksSubmitted -= base.tasksSubmitted;
+  metrics.submitLockWaitSeconds -= base.submitLockWaitSeconds;
+  return metrics;
+}
+
+void ThreadPool::ResetMetrics() {
+  std::lock_guard<std::mutex> lock(metricsMutex_);
+  queueDepthHighWater_ = queuedTasks_.load();
+  metricsBaseline_ = ReadCounters();
+  metricsEpoch_ = Clock::now();
 }
 
-} // namespace Core
\ No newline at end of file
+} // namespace Core
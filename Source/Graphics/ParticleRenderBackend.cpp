@@ -0,0 +1,367 @@
+#include "Graphics/ParticleRenderBackend.hpp"
+#include "Core/ExecutionBackend.hpp"
+#include "Core/LargeBufferAllocator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <spdlog/spdlog.h>
+
+namespace Graphics {
+
+namespace {
+
+using Vertices =
+    std::vector<sf::Vertex, Core::LargeBufferAllocator<sf::Vertex>>;
+
+// Builds VERTICES vertices per active particle in two chunked passes: count
+// the active particles of every chunk, then write each chunk at its prefix
+// offset, so chunks never share output
+template <std::size_t VERTICES, typename Write, typename ForEach>
+void BuildVertices(std::span<const Particle> particles,
+                   std::vector<std::size_t> &chunkOffsets, Vertices &vertices,
+                   std::size_t chunkSize, const Write &write,
+                   const ForEach &forEachChunk) {
+  chunkOffsets.assign((particles.size() + chunkSize - 1) / chunkSize + 1, 0);
+  forEachChunk(particles.size(), [&](std::size_t begin, std::size_t end) {
+    std::size_t activeCount = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      activeCount += particles[i].active ? 1 : 0;
+    }
+    chunkOffsets[begin / chunkSize + 1] = activeCount;
+  });
+  std::partial_sum(chunkOffsets.begin(), chunkOffsets.end(),
+                   chunkOffsets.begin());
+
+  vertices.resize(chunkOffsets.back() * VERTICES);
+  forEachChunk(particles.size(), [&](std::size_t begin, std::size_t end) {
+    std::size_t vertexIndex = chunkOffsets[begin / chunkSize] * VERTICES;
+    for (std::size_t i = begin; i < end; ++i) {
+      if (particles[i].active) {
+        write(particles[i], &vertices[vertexIndex]);
+        vertexIndex += VERTICES;
+      }
+    }
+  });
+}
+
+// Quads in client memory, handed to the driver on every draw
+class QuadBackend : public ParticleRenderBackend {
+public:
+  ParticleRenderBackendType GetType() const override {
+    return ParticleRenderBackendType::Quads;
+  }
+
+  void Prepare(std::span<const Particle> particles, const sf::View &,
+               sf::Vector2u) override {
+    BuildVertices<4>(particles, chunkOffsets_, vertices_, CHUNK_SIZE,
+                     WriteParticleQuad,
+                     [this](std::size_t count, auto &&func) {
+                       ForEachChunk(count, func);
+                     });
+  }
+
+  void Submit(sf::RenderTarget &target,
+              const sf::RenderStates &states) override {
+    if (!vertices_.empty()) {
+      target.draw(vertices_.data(), vertices_.size(),
+                  sf::PrimitiveType::Quads, states);
+    }
+  }
+
+  std::span<const sf::Vertex> GetVertices() const override {
+    return vertices_;
+  }
+
+protected:
+  Vertices vertices_;
+  std::vector<std::size_t> chunkOffsets_;
+};
+
+// The same quads streamed into a vertex buffer object. The buffer only
+// grows, so steady frames upload without reallocating.
+class StreamedQuadBackend : public QuadBackend {
+public:
+  ParticleRenderBackendType GetType() const override {
+    return ParticleRenderBackendType::StreamedQuads;
+  }
+
+  void Submit(sf::RenderTarget &target,
+              const sf::RenderStates &states) override {
+    if (vertices_.empty()) {
+      return;
+    }
+    if (buffer_.getVertexCount() < vertices_.size() &&
+        !buffer_.create(vertices_.size() + vertices_.size() / 4)) {
+      spdlog::error("Failed to create particle vertex buffer");
+      return;
+    }
+    buffer_.update(vertices_.data(), vertices_.size(), 0);
+    target.draw(buffer_, 0, vertices_.size(), states);
+  }
+
+private:
+  sf::VertexBuffer buffer_{sf::PrimitiveType::Quads, sf::VertexBuffer::Stream};
+};
+
+// One pixel per particle, whatever its size: a quarter of the vertices
+class PointBackend : public ParticleRenderBackend {
+public:
+  ParticleRenderBackendType GetType() const override {
+    return ParticleRenderBackendType::Points;
+  }
+
+  void Prepare(std::span<const Particle> particles, const sf::View &,
+               sf::Vector2u) override {
+    BuildVertices<1>(
+        particles, chunkOffsets_, vertices_, CHUNK_SIZE,
+        [](const Particle &particle, sf::Vertex *vertex) {
+          vertex->position = {particle.position.x, particle.position.y};
+          vertex->color = particle.color;
+        },
+        [this](std::size_t count, auto &&func) { ForEachChunk(count, func); });
+  }
+
+  void Submit(sf::RenderTarget &target,
+              const sf::RenderStates &states) override {
+    if (!vertices_.empty()) {
+      target.draw(vertices_.data(), vertices_.size(),
+                  sf::PrimitiveType::Points, states);
+    }
+  }
+
+  std::span<const sf::Vertex> GetVertices() const override {
+    return vertices_;
+  }
+
+private:
+  Vertices vertices_;
+  std::vector<std::size_t> chunkOffsets_;
+};
+
+std::uint8_t AddSaturated(std::uint8_t value, std::uint32_t add) {
+  return static_cast<std::uint8_t>(std::min<std::uint32_t>(value + add, 255));
+}
+
+} // namespace
+
+std::string ToString(ParticleRenderBackendType type) {
+  switch (type) {
+  case ParticleRenderBackendType::Quads:
+    return "quads";
+  case ParticleRenderBackendType::StreamedQuads:
+    return "vbo";
+  case ParticleRenderBackendType::Points:
+    return "points";
+  case ParticleRenderBackendType::CpuSplat:
+    return "splat";
+  }
+  return "unknown";
+}
+
+std::optional<ParticleRenderBackendType>
+ParseParticleRenderBackend(std::string_view name) {
+  if (name == "quads")
+    return ParticleRenderBackendType::Quads;
+  if (name == "vbo")
+    return ParticleRenderBackendType::StreamedQuads;
+  if (name == "points")
+    return ParticleRenderBackendType::Points;
+  if (name == "splat")
+    return ParticleRenderBackendType::CpuSplat;
+  return std::nullopt;
+}
+
+bool IsParticleRenderBackendAvailable(ParticleRenderBackendType type) {
+  if (type == ParticleRenderBackendType::StreamedQuads) {
+    return sf::VertexBuffer::isAvailable();
+  }
+  return true;
+}
+
+std::vector<ParticleRenderBackendType> GetAvailableParticleRenderBackends() {
+  std::vector<ParticleRenderBackendType> backends;
+  for (auto type : {ParticleRenderBackendType::Quads,
+                    ParticleRenderBackendType::StreamedQuads,
+                    ParticleRenderBackendType::Points,
+                    ParticleRenderBackendType::CpuSplat}) {
+    if (IsParticleRenderBackendAvailable(type)) {
+      backends.push_back(type);
+    }
+  }
+  return backends;
+}
+
+void ParticleRenderBackend::ForEachChunk(
+    std::size_t count,
+    const std::function<void(std::size_t, std::size_t)> &func) {
+  if (executionBackend_) {
+    executionBackend_->ForEachChunk(count, CHUNK_SIZE, func);
+    return;
+  }
+
+  for (std::size_t begin = 0; begin < count; begin += CHUNK_SIZE) {
+    func(begin, std::min(begin + CHUNK_SIZE, count));
+  }
+}
+
+void CpuSplatRenderBackend::Prepare(std::span<const Particle> particles,
+                                    const sf::View &view,
+                                    sf::Vector2u targetSize) {
+  size_ = targetSize;
+  pixels_.assign(static_cast<std::size_t>(size_.x) * size_.y * 4, 0);
+  if (size_.x == 0 || size_.y == 0) {
+    return;
+  }
+
+  // World to pixels, as the view maps them without rotation
+  const sf::FloatRect &viewport = view.getViewport();
+  const sf::Vector2f viewSize = view.getSize();
+  const sf::Vector2f topLeft = view.getCenter() - viewSize * 0.5f;
+  const float scaleX =
+      viewport.width * static_cast<float>(size_.x) / viewSize.x;
+  const float scaleY =
+      viewport.height * static_cast<float>(size_.y) / viewSize.y;
+  const float offsetX = viewport.left * static_cast<float>(size_.x);
+  const float offsetY = viewport.top * static_cast<float>(size_.y);
+  const auto width = static_cast<long>(size_.x);
+  const auto height = static_cast<long>(size_.y);
+
+  for (const auto &particle : particles) {
+    if (!particle.active) {
+      continue;
+    }
+    const float halfX = std::max(particle.size * scaleX, 1.0f) * 0.5f;
+    const float halfY = std::max(particle.size * scaleY, 1.0f) * 0.5f;
+    const float x = (particle.position.x - topLeft.x) * scaleX + offsetX;
+    const float y = (particle.position.y - topLeft.y) * scaleY + offsetY;
+    // Pixels whose centers the square covers, at least the one it is in
+    const long x0 = std::max(0L, std::lround(x - halfX));
+    const long x1 = std::min(width, std::max(std::lround(x + halfX), x0 + 1));
+    const long y0 = std::max(0L, std::lround(y - halfY));
+    const long y1 = std::min(height, std::max(std::lround(y + halfY), y0 + 1));
+    if (x0 >= x1 || y0 >= y1) {
+      continue;
+    }
+
+    const std::uint32_t alpha = particle.color.a;
+    const std::uint32_t r = particle.color.r * alpha / 255;
+    const std::uint32_t g = particle.color.g * alpha / 255;
+    const std::uint32_t b = particle.color.b * alpha / 255;
+    for (long py = y0; py < y1; ++py) {
+      std::uint8_t *pixel = &pixels_[(static_cast<std::size_t>(py) * size_.x +
+                                      static_cast<std::size_t>(x0)) *
+                                     4];
+      for (long px = x0; px < x1; ++px, pixel += 4) {
+        pixel[0] = AddSaturated(pixel[0], r);
+        pixel[1] = AddSaturated(pixel[1], g);
+        pixel[2] = AddSaturated(pixel[2], b);
+        pixel[3] = 255;
+      }
+    }
+  }
+}
+
+void CpuSplatRenderBackend::Submit(sf::RenderTarget &target,
+                                   const sf::RenderStates &states) {
+  if (pixels_.empty()) {
+    return;
+  }
+  if (texture_.getSize() != size_ && !texture_.create(size_.x, size_.y)) {
+    spdlog::error("Failed to create particle splat texture");
+    return;
+  }
+  texture_.update(pixels_.data());
+
+  // The pixels already carry the view
+  const sf::View view = target.getView();
+  target.setView(target.getDefaultView());
+  target.draw(sf::Sprite(texture_), states);
+  target.setView(view);
+}
+
+std::unique_ptr<ParticleRenderBackend>
+CreateParticleRenderBackend(ParticleRenderBackendType type) {
+  if (!IsParticleRenderBackendAvailable(type)) {
+    spdlog::warn("Particle renderer '{}' is not available; using quads",
+                 ToString(type));
+    type = ParticleRenderBackendType::Quads;
+  }
+
+  switch (type) {
+  case ParticleRenderBackendType::StreamedQuads:
+    return std::make_unique<StreamedQuadBackend>();
+  case ParticleRenderBackendType::Points:
+    return std::make_unique<PointBackend>();
+  case ParticleRenderBackendType::CpuSplat:
+    return std::make_unique<CpuSplatRenderBackend>();
+  case ParticleRenderBackendType::Quads:
+    break;
+  }
+  return std::make_unique<QuadBackend>();
+}
+
+double BenchmarkParticleRenderBackend(ParticleRenderBackend &backend,
+                                      std::span<const Particle> particles,
+                                      sf::RenderTexture &target, int frames) {
+  sf::RenderStates states;
+  states.blendMode = sf::BlendAdd;
+  auto drawFrame = [&] {
+    target.clear();
+    backend.Draw(particles, target, states);
+    target.display();
+  };
+
+  // The first frame allocates buffers and textures
+  drawFrame();
+  static_cast<void>(target.getTexture().copyToImage());
+
+  frames = std::max(frames, 1);
+  const auto start = std::chrono::steady_clock::now();
+  for (int frame = 0; frame < frames; ++frame) {
+    drawFrame();
+  }
+  // Waits for the GPU to finish the queued frames
+  static_cast<void>(target.getTexture().copyToImage());
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / frames;
+}
+
+ParticleRenderBackendType
+SelectFastestParticleRenderBackend(std::span<const Particle> particles,
+                                   sf::Vector2u targetSize,
+                                   Core::ExecutionBackend *executionBackend) {
+  constexpr int FRAMES = 8;
+
+  sf::RenderTexture target;
+  if (!target.create(targetSize.x, targetSize.y)) {
+    spdlog::warn("Particle renderer calibration needs a render texture; "
+                 "using quads");
+    return ParticleRenderBackendType::Quads;
+  }
+
+  auto fastest = ParticleRenderBackendType::Quads;
+  double fastestMs = std::numeric_limits<double>::max();
+  for (auto type : GetAvailableParticleRenderBackends()) {
+    // Points do not draw the same image, so they are only chosen by hand
+    if (type == ParticleRenderBackendType::Points) {
+      continue;
+    }
+    auto backend = CreateParticleRenderBackend(type);
+    backend->SetExecutionBackend(executionBackend);
+    const double ms =
+        BenchmarkParticleRenderBackend(*backend, particles, target, FRAMES);
+    spdlog::info("Particle renderer '{}': {:.2f} ms/frame for {} particles",
+                 ToString(type), ms, particles.size());
+    if (ms < fastestMs) {
+      fastestMs = ms;
+      fastest = type;
+    }
+  }
+  spdlog::info("Using particle renderer '{}'", ToString(fastest));
+  return fastest;
+}
+
+} // namespace Graphics
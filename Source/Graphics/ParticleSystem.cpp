@@ -1,21 +1,20 @@
 #include "Graphics/ParticleSystem.hpp"
+#include "Utils/FlightRecorder.hpp"
 #include <algorithm>
 
 namespace Graphics {
 
 ParticleSystem::ParticleSystem(std::size_t maxParticles)
     : particles_(maxParticles), maxParticles_(maxParticles),
-      vertices_(sf::PrimitiveType::Triangles), blendMode_(sf::BlendAdd),
-      gravity_(0.0f, 0.0f), damping_(0.99f) {
-
-  // Reserve space for triangles (6 segments per particle, 3 vertices per
-  // triangle)
-  vertices_.resize(maxParticles * 6 * 3);
-}
+      vertices_(), renderBackend_(CreateParticleRenderBackend(
+                       ParticleRenderBackendType::Quads)),
+      blendMode_(sf::BlendAdd), gravity_(0.0f, 0.0f), damping_(0.99f) {}
 
 ParticleSystem::~ParticleSystem() = default;
 
 void ParticleSystem::Update(float deltaTime) {
+  fusedVerticesValid_ = false;
+
   // Update emission
   if (emitter_) {
     // TODO: Handle emitter updates
@@ -35,59 +34,104 @@ void ParticleSystem::Update(float deltaTime) {
   }
 }
 
+void ParticleSystem::Update(std::span<const float> stepTimes) {
+  fusedVerticesValid_ = false;
+  UpdateRange(0, particles_.size(), stepTimes);
+}
+
 void ParticleSystem::Render(sf::RenderTarget &target) {
-  // Clear and prepare vertex array
-  vertices_.clear();
-  vertices_.setPrimitiveType(sf::PrimitiveType::Quads);
-
-  // Count active particles for optimization
-  std::size_t activeCount = 0;
-  for (const auto &particle : particles_) {
-    if (particle.active)
-      activeCount++;
+  sf::RenderStates states;
+  states.blendMode = blendMode_;
+  if (fusedVerticesValid_) {
+    DrawFusedVertices(target, states);
+    return;
   }
 
-  // Pre-allocate vertices
-  vertices_.resize(activeCount * 4);
-  std::size_t vertexIndex = 0;
+  renderBackend_->Draw(particles_, target, states);
+}
 
-  // Render particles as quads (much faster than circles)
-  for (const auto &particle : particles_) {
-    if (!particle.active)
-      continue;
+void ParticleSystem::SetRenderBackend(
+    std::unique_ptr<ParticleRenderBackend> backend) {
+  renderBackend_ = std::move(backend);
+  renderBackend_->SetExecutionBackend(executionBackend_);
+  fusedVerticesValid_ = false;
+}
 
-    float halfSize = particle.size * 0.5f;
-    sf::Vector2f pos(particle.position.x, particle.position.y);
+bool ParticleSystem::CanFuseVertices() const {
+  return renderBackend_->GetType() == ParticleRenderBackendType::Quads;
+}
 
-    // Top-left
-    vertices_[vertexIndex].position = pos + sf::Vector2f(-halfSize, -halfSize);
-    vertices_[vertexIndex].color = particle.color;
-    vertexIndex++;
+void ParticleSystem::BeginFusedFrame(std::size_t chunkSize) {
+  fusedVerticesValid_ = false;
+  fusedChunkSize_ = std::max<std::size_t>(chunkSize, 1);
+  fusedVertexCounts_.assign(
+      (particles_.size() + fusedChunkSize_ - 1) / fusedChunkSize_, 0);
+  // Room for every slot, so chunk ranges never move
+  vertices_.resize(particles_.size() * 4);
+}
 
-    // Top-right
-    vertices_[vertexIndex].position = pos + sf::Vector2f(halfSize, -halfSize);
-    vertices_[vertexIndex].color = particle.color;
-    vertexIndex++;
+void ParticleSystem::UpdateRange(std::size_t begin, std::size_t end,
+                                 float deltaTime) {
+  for (std::size_t i = begin; i < end; ++i) {
+    if (particles_[i].active) {
+      UpdateParticle(particles_[i], deltaTime);
+    }
+  }
+}
 
-    // Bottom-right
-    vertices_[vertexIndex].position = pos + sf::Vector2f(halfSize, halfSize);
-    vertices_[vertexIndex].color = particle.color;
-    vertexIndex++;
+void ParticleSystem::UpdateRange(std::size_t begin, std::size_t end,
+                                 std::span<const float> stepTimes) {
+  for (std::size_t i = begin; i < end; ++i) {
+    if (particles_[i].active && stepTimes[i] != 0.0f) {
+      UpdateParticle(particles_[i], stepTimes[i]);
+    }
+  }
+}
 
-    // Bottom-left
-    vertices_[vertexIndex].position = pos + sf::Vector2f(-halfSize, halfSize);
-    vertices_[vertexIndex].color = particle.color;
-    vertexIndex++;
+void ParticleSystem::UpdateRange(std::size_t begin, std::size_t end,
+                                 float deltaTime,
+                                 std::span<glm::dvec2> positions,
+                                 std::span<glm::dvec2> velocities) {
+  for (std::size_t i = begin; i < end; ++i) {
+    if (particles_[i].active) {
+      UpdateParticle(particles_[i], positions[i], velocities[i], deltaTime);
+    }
   }
+}
 
-  // Draw all particles in one draw call
-  sf::RenderStates states;
-  states.blendMode = blendMode_;
-  target.draw(vertices_, states);
+void ParticleSystem::UpdateRange(std::size_t begin, std::size_t end,
+                                 std::span<const float> stepTimes,
+                                 std::span<glm::dvec2> positions,
+                                 std::span<glm::dvec2> velocities) {
+  for (std::size_t i = begin; i < end; ++i) {
+    if (particles_[i].active && stepTimes[i] != 0.0f) {
+      UpdateParticle(particles_[i], positions[i], velocities[i],
+                     stepTimes[i]);
+    }
+  }
+}
+
+void ParticleSystem::WriteVertices(std::size_t begin, std::size_t end) {
+  std::size_t vertexIndex = begin * 4;
+  for (std::size_t i = begin; i < end; ++i) {
+    if (particles_[i].active) {
+      WriteParticleQuad(particles_[i], &vertices_[vertexIndex]);
+      vertexIndex += 4;
+    }
+  }
+  fusedVertexCounts_[begin / fusedChunkSize_] = vertexIndex - begin * 4;
+}
+
+void ParticleSystem::DrawFusedVertices(sf::RenderTarget &target,
+                                       const sf::RenderStates &states) {
+  ForEachFusedRange([&](const sf::Vertex *vertices, std::size_t count) {
+    target.draw(vertices, count, sf::PrimitiveType::Quads, states);
+  });
 }
 
 void ParticleSystem::EmitParticle(const Particle &particleTemplate) {
   Particle *particle = GetInactiveParticle();
+  fusedVerticesValid_ = false;
   if (particle) {
     *particle = particleTemplate;
     particle->active = true;
@@ -103,11 +147,25 @@ void ParticleSystem::EmitBurst(std::size_t count,
 }
 
 void ParticleSystem::Clear() {
+  fusedVerticesValid_ = false;
   for (auto &particle : particles_) {
     particle.active = false;
   }
 }
 
+void ParticleSystem::Resize(std::size_t maxParticles) {
+  Particle inactive;
+  inactive.active = false;
+
+  ParticleBuffer(maxParticles, inactive).swap(particles_);
+  maxParticles_ = maxParticles;
+  Core::FlightRecorder::GetInstance().RecordAllocation(
+      "ParticleSystem::Resize", maxParticles * sizeof(Particle));
+
+  VertexBuffer().swap(vertices_);
+  fusedVerticesValid_ = false;
+}
+
 std::size_t ParticleSystem::GetActiveParticleCount() const {
   return std::count_if(particles_.begin(), particles_.end(),
                        [](const Particle &p) { return p.active; });
@@ -131,6 +189,26 @@ void ParticleSystem::UpdateParticle(Particle &particle, float deltaTime) {
   particle.color.a = static_cast<sf::Uint8>(255 * (1.0f - lifeRatio));
 }
 
+void ParticleSystem::UpdateParticle(Particle &particle, glm::dvec2 &position,
+                                    glm::dvec2 &velocity, float deltaTime) {
+  particle.age += deltaTime;
+
+  if (particle.age >= particle.lifetime) {
+    particle.active = false;
+    return;
+  }
+
+  const double step = deltaTime;
+  velocity += glm::dvec2(particle.acceleration + gravity_) * step;
+  velocity *= static_cast<double>(damping_);
+  position += velocity * step;
+  particle.position = glm::vec2(position);
+  particle.velocity = glm::vec2(velocity);
+
+  float lifeRatio = particle.age / particle.lifetime;
+  particle.color.a = static_cast<sf::Uint8>(255 * (1.0f - lifeRatio));
+}
+
 Particle *ParticleSystem::GetInactiveParticle() {
   auto it = std::find_if(particles_.begin(), particles_.end(),
                          [](const Particle &p) { return !p.active; });
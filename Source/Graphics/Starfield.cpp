@@ -0,0 +1,219 @@
+#include "Graphics/Starfield.hpp"
+#include "Core/ThreadPool.hpp"
+#include <chrono>
+#include <cmath>
+
+namespace Graphics {
+
+namespace {
+
+// SplitMix64 finalizer: every input bit affects every output bit
+std::uint64_t Mix(std::uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xbf58476d1ce4e5b9ull;
+  value ^= value >> 27;
+  value *= 0x94d049bb133111ebull;
+  return value ^ (value >> 31);
+}
+
+std::uint64_t TileHash(const StarfieldTileKey &key, std::uint64_t seed) {
+  std::uint64_t hash = Mix(seed);
+  for (std::uint64_t part :
+       {static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.x)),
+        static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.y)),
+        static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.level)),
+        static_cast<std::uint64_t>(key.layer)}) {
+    hash = Mix(hash ^ part);
+  }
+  return hash;
+}
+
+// Blue-white to orange, weighted towards white
+constexpr std::array<sf::Color, 4> STAR_TINTS{{
+    {255, 255, 255},
+    {180, 200, 255},
+    {255, 235, 200},
+    {255, 200, 160},
+}};
+
+} // namespace
+
+std::size_t
+StarfieldTileKeyHash::operator()(const StarfieldTileKey &key) const noexcept {
+  return static_cast<std::size_t>(TileHash(key, 0));
+}
+
+Starfield::Starfield(Core::ThreadPool &threadPool, std::uint64_t seed,
+                     std::size_t maxTiles)
+    : threadPool_(threadPool), seed_(seed), maxTiles_(maxTiles) {}
+
+Starfield::~Starfield() {
+  // Tasks hold nothing of ours, but the pool may be destroyed right after
+  for (auto &[key, tile] : pending_) {
+    tile.wait();
+  }
+}
+
+void Starfield::Update(const glm::vec2 &position, const glm::vec2 &screenSize,
+                       float zoom, float rotation) {
+  ++frame_;
+  CollectFinishedTiles();
+
+  visibleCount_ = 0;
+  const float radians = glm::radians(rotation);
+  const float cosine = std::abs(std::cos(radians));
+  const float sine = std::abs(std::sin(radians));
+
+  for (std::size_t index = 0; index < LAYER_COUNT; ++index) {
+    const Layer &layer = LAYERS[index];
+    LayerView &view = layers_[index];
+
+    // Distant layers follow a fraction of the pan and of the zoom
+    const float layerZoom = std::pow(std::max(zoom, 1e-3f), layer.parallax);
+    view.center = position * layer.parallax;
+    view.size = screenSize / layerZoom;
+    view.rotation = rotation;
+    view.visible.clear();
+
+    const auto level =
+        static_cast<std::int32_t>(std::floor(std::log2(layerZoom)));
+    const float tileSize =
+        BASE_TILE_SIZE / std::exp2(static_cast<float>(level));
+    const glm::vec2 half =
+        0.5f * glm::vec2(cosine * view.size.x + sine * view.size.y,
+                         sine * view.size.x + cosine * view.size.y);
+    const glm::ivec2 first(glm::floor((view.center - half) / tileSize));
+    const glm::ivec2 last(glm::floor((view.center + half) / tileSize));
+
+    for (std::int32_t y = first.y; y <= last.y; ++y) {
+      for (std::int32_t x = first.x; x <= last.x; ++x) {
+        const StarfieldTileKey key{x, y, level,
+                                   static_cast<std::uint32_t>(index)};
+        view.visible.push_back(key);
+
+        auto cached = tiles_.find(key);
+        if (cached != tiles_.end()) {
+          cached->second.lastVisibleFrame = frame_;
+          lru_.splice(lru_.begin(), lru_, cached->second.lru);
+          ++visibleCount_;
+        } else if (!pending_.contains(key) &&
+                   pending_.size() < MAX_PENDING_TILES) {
+          pending_.emplace(key, threadPool_.Submit(
+                                    Core::TaskPriority::Background,
+                                    [key, seed = seed_] {
+                                      return GenerateTile(key, seed);
+                                    }));
+        }
+      }
+    }
+  }
+
+  Evict();
+}
+
+void Starfield::Render(sf::RenderTarget &target) {
+  const sf::View saved = target.getView();
+  sf::RenderStates states;
+  states.blendMode = sf::BlendAdd;
+
+  for (const auto &layer : layers_) {
+    frameVertices_.clear();
+    for (const auto &key : layer.visible) {
+      auto cached = tiles_.find(key);
+      if (cached != tiles_.end()) {
+        frameVertices_.insert(frameVertices_.end(),
+                              cached->second.vertices.begin(),
+                              cached->second.vertices.end());
+      }
+    }
+    if (frameVertices_.empty()) {
+      continue;
+    }
+
+    sf::View view({layer.center.x, layer.center.y},
+                  {layer.size.x, layer.size.y});
+    view.setViewport(saved.getViewport());
+    view.setRotation(layer.rotation);
+    target.setView(view);
+    target.draw(frameVertices_.data(), frameVertices_.size(),
+                sf::PrimitiveType::Quads, states);
+  }
+  target.setView(saved);
+}
+
+std::vector<sf::Vertex> Starfield::GenerateTile(const StarfieldTileKey &key,
+                                                std::uint64_t seed) {
+  const Layer &layer = LAYERS[key.layer % LAYER_COUNT];
+  const float tileSize =
+      BASE_TILE_SIZE / std::exp2(static_cast<float>(key.level));
+  // World units per screen pixel at the zoom the level was chosen for
+  const float pixel = tileSize / BASE_TILE_SIZE;
+
+  std::uint64_t state = TileHash(key, seed);
+  auto next = [&state] {
+    state += 0x9e3779b97f4a7c15ull;
+    return Mix(state);
+  };
+  auto uniform = [&next] {
+    return static_cast<float>(next() >> 40) * 0x1p-24f;
+  };
+
+  // Between half and one and a half times the layer's density
+  const std::uint32_t count =
+      layer.starsPerTile / 2 +
+      static_cast<std::uint32_t>(next() % (layer.starsPerTile + 1));
+  std::vector<sf::Vertex> vertices(count * 4);
+
+  for (std::uint32_t star = 0; star < count; ++star) {
+    const sf::Vector2f center(
+        (static_cast<float>(key.x) + uniform()) * tileSize,
+        (static_cast<float>(key.y) + uniform()) * tileSize);
+    // Half a pixel to two pixels wide, mostly small
+    const float size = uniform();
+    const float half = (0.5f + 1.5f * size * size * size) * 0.5f * pixel;
+    const float tintRoll = uniform();
+    sf::Color color =
+        STAR_TINTS[tintRoll < 0.55f ? 0 : 1 + static_cast<std::size_t>(
+                                                  (tintRoll - 0.55f) * 6.6f)];
+    color.a = static_cast<sf::Uint8>(
+        255.0f * layer.brightness * (0.25f + 0.75f * uniform()));
+
+    sf::Vertex *quad = &vertices[star * 4];
+    quad[0].position = center + sf::Vector2f(-half, -half);
+    quad[1].position = center + sf::Vector2f(half, -half);
+    quad[2].position = center + sf::Vector2f(half, half);
+    quad[3].position = center + sf::Vector2f(-half, half);
+    for (int corner = 0; corner < 4; ++corner) {
+      quad[corner].color = color;
+    }
+  }
+  return vertices;
+}
+
+void Starfield::CollectFinishedTiles() {
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    if (it->second.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    lru_.push_front(it->first);
+    tiles_.emplace(it->first, CachedTile{it->second.get(), lru_.begin()});
+    it = pending_.erase(it);
+  }
+}
+
+void Starfield::Evict() {
+  // Least recently visible first; tiles on screen this frame stay even
+  // when they alone exceed the budget
+  while (tiles_.size() > maxTiles_) {
+    auto oldest = tiles_.find(lru_.back());
+    if (oldest->second.lastVisibleFrame == frame_) {
+      break;
+    }
+    tiles_.erase(oldest);
+    lru_.pop_back();
+  }
+}
+
+} // namespace Graphics
@@ -0,0 +1,537 @@
+#include "IO/AsyncWriter.hpp"
+#include "Core/ThreadPool.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IO_HAS_PWRITE 1
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define IO_HAS_IO_URING 1
+#endif
+
+namespace IO {
+
+namespace {
+
+std::size_t AlignUp(std::size_t value) {
+  constexpr std::size_t alignment = AsyncWriterOptions::DIRECT_IO_ALIGNMENT;
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef IO_HAS_IO_URING
+// Marks the no-op that wakes the completion thread on Close
+constexpr std::uint64_t WAKE_USER_DATA = ~std::uint64_t{0};
+
+// The rings are shared with the kernel: our indices are published with
+// release stores and the kernel's read with acquire loads
+unsigned LoadAcquire(unsigned *value) {
+  return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+}
+
+void StoreRelease(unsigned *value, unsigned newValue) {
+  std::atomic_ref<unsigned>(*value).store(newValue, std::memory_order_release);
+}
+#endif
+
+} // namespace
+
+#ifdef IO_HAS_IO_URING
+// Raw io_uring without liburing: one submission and one completion ring
+// mapped from the kernel, plus the registered write buffers
+struct AsyncWriter::Ring {
+  int fd = -1;
+  void *sqMap = MAP_FAILED;
+  void *cqMap = MAP_FAILED;
+  void *sqeMap = MAP_FAILED;
+  std::size_t sqMapSize = 0;
+  std::size_t cqMapSize = 0;
+  std::size_t sqeMapSize = 0;
+
+  unsigned *sqTail = nullptr;
+  unsigned *sqMask = nullptr;
+  unsigned *sqArray = nullptr;
+  io_uring_sqe *sqes = nullptr;
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  unsigned *cqMask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+  bool fixedBuffers = false;
+
+  ~Ring() {
+    if (sqeMap != MAP_FAILED)
+      ::munmap(sqeMap, sqeMapSize);
+    if (cqMap != MAP_FAILED && cqMap != sqMap)
+      ::munmap(cqMap, cqMapSize);
+    if (sqMap != MAP_FAILED)
+      ::munmap(sqMap, sqMapSize);
+    if (fd >= 0)
+      ::close(fd);
+  }
+
+  // Caller holds the writer mutex; in-flight requests never exceed the
+  // ring size, so a slot is always free
+  io_uring_sqe &NextEntry() {
+    const unsigned tail = *sqTail;
+    const unsigned index = tail & *sqMask;
+    io_uring_sqe &entry = sqes[index];
+    std::memset(&entry, 0, sizeof(entry));
+    sqArray[index] = index;
+    return entry;
+  }
+
+  bool Submit() {
+    StoreRelease(sqTail, *sqTail + 1);
+    for (;;) {
+      long result = ::syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+      if (result >= 0)
+        return true;
+      if (errno != EINTR && errno != EAGAIN)
+        return false;
+    }
+  }
+};
+#else
+struct AsyncWriter::Ring {};
+#endif
+
+std::string_view ToString(AsyncWriterBackend backend) {
+  switch (backend) {
+  case AsyncWriterBackend::IoUring:
+    return "io_uring";
+  case AsyncWriterBackend::ThreadPool:
+    return "thread pool";
+  }
+  return "unknown";
+}
+
+AsyncWriter::AsyncWriter(Core::ThreadPool &threadPool)
+    : threadPool_(threadPool) {}
+
+AsyncWriter::~AsyncWriter() { Close(); }
+
+bool AsyncWriter::Open(const std::filesystem::path &path,
+                       const AsyncWriterOptions &options) {
+  Close();
+
+  options_ = options;
+  options_.bufferSize = AlignUp(std::max<std::size_t>(options_.bufferSize, 1));
+  options_.bufferCount = std::max<std::size_t>(options_.bufferCount, 1);
+
+#ifdef IO_HAS_PWRITE
+  const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  direct_ = false;
+#ifdef O_DIRECT
+  if (options_.directIO) {
+    fd_ = ::open(path.c_str(), flags | O_DIRECT, 0644);
+    direct_ = fd_ >= 0;
+  }
+#endif
+  // tmpfs and some network filesystems reject O_DIRECT
+  if (fd_ < 0) {
+    fd_ = ::open(path.c_str(), flags, 0644);
+  }
+  if (fd_ < 0) {
+    spdlog::error("Failed to open '{}' for writing: {}", path.string(),
+                  std::strerror(errno));
+    return false;
+  }
+#else
+  stream_ = std::make_unique<std::fstream>(
+      path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!*stream_) {
+    stream_.reset();
+    spdlog::error("Failed to open '{}' for writing", path.string());
+    return false;
+  }
+#endif
+
+  storage_ = static_cast<std::byte *>(
+      std::aligned_alloc(AsyncWriterOptions::DIRECT_IO_ALIGNMENT,
+                         options_.bufferSize * options_.bufferCount));
+  if (!storage_) {
+    spdlog::error("Failed to allocate write buffers");
+    Close();
+    return false;
+  }
+
+  buffers_.assign(options_.bufferCount, {});
+  freeBuffers_.clear();
+  for (std::size_t i = 0; i < buffers_.size(); ++i) {
+    buffers_[i].data = storage_ + i * options_.bufferSize;
+    freeBuffers_.push_back(buffers_.size() - 1 - i);
+  }
+  current_ = SIZE_MAX;
+  size_ = 0;
+  failed_ = false;
+
+  backend_ = AsyncWriterBackend::ThreadPool;
+  if (!options_.forceThreadPool && fd_ >= 0 && SetUpRing()) {
+    backend_ = AsyncWriterBackend::IoUring;
+    completionThread_ = std::thread(&AsyncWriter::CompletionThread, this);
+  }
+
+  spdlog::info("Writing {} through {} ({} x {} KB buffers{})", path.string(),
+               ToString(backend_), options_.bufferCount,
+               options_.bufferSize / 1024, direct_ ? ", O_DIRECT" : "");
+  return true;
+}
+
+bool AsyncWriter::SetUpRing() {
+#ifdef IO_HAS_IO_URING
+  io_uring_params params{};
+  const auto entries = static_cast<unsigned>(options_.bufferCount + 1);
+  const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+  if (fd < 0) {
+    spdlog::debug("io_uring unavailable ({}), using thread pool writes",
+                  std::strerror(errno));
+    return false;
+  }
+
+  auto ring = std::make_unique<Ring>();
+  ring->fd = fd;
+  ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  ring->cqMapSize =
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  ring->sqeMapSize = params.sq_entries * sizeof(io_uring_sqe);
+
+  const bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (singleMap) {
+    ring->sqMapSize = ring->cqMapSize =
+        std::max(ring->sqMapSize, ring->cqMapSize);
+  }
+
+  auto map = [fd](std::size_t bytes, off_t offset) {
+    return ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, offset);
+  };
+  ring->sqMap = map(ring->sqMapSize, IORING_OFF_SQ_RING);
+  if (ring->sqMap == MAP_FAILED)
+    return false;
+  ring->cqMap = singleMap ? ring->sqMap : map(ring->cqMapSize, IORING_OFF_CQ_RING);
+  ring->sqeMap = map(ring->sqeMapSize, IORING_OFF_SQES);
+  if (ring->cqMap == MAP_FAILED || ring->sqeMap == MAP_FAILED)
+    return false;
+
+  auto *sq = static_cast<char *>(ring->sqMap);
+  auto *cq = static_cast<char *>(ring->cqMap);
+  ring->sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  ring->sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  ring->sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  ring->sqes = static_cast<io_uring_sqe *>(ring->sqeMap);
+  ring->cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  ring->cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  ring->cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+  // Registered buffers skip the per-request page pinning; they count
+  // against RLIMIT_MEMLOCK, so plain writes remain the fallback
+  std::vector<iovec> iovecs(buffers_.size());
+  for (std::size_t i = 0; i < buffers_.size(); ++i) {
+    iovecs[i] = {buffers_[i].data, options_.bufferSize};
+  }
+  ring->fixedBuffers =
+      ::syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS,
+                iovecs.data(), static_cast<unsigned>(iovecs.size())) == 0;
+  if (!ring->fixedBuffers) {
+    spdlog::debug("io_uring buffer registration failed ({}), using plain "
+                  "writes",
+                  std::strerror(errno));
+  }
+
+  ring_ = std::move(ring);
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::size_t AsyncWriter::AcquireBuffer(std::unique_lock<std::mutex> &lock) {
+  writeCompleted_.wait(lock, [this] { return !freeBuffers_.empty(); });
+
+  const std::size_t index = freeBuffers_.back();
+  freeBuffers_.pop_back();
+  Buffer &buffer = buffers_[index];
+  buffer.bytes = 0;
+  buffer.written = 0;
+  buffer.offset = size_;
+  buffer.done = false;
+  return index;
+}
+
+bool AsyncWriter::Append(std::span<const std::byte> data,
+                         Completion onComplete) {
+  if (!IsOpen())
+    return false;
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!data.empty()) {
+    if (current_ == SIZE_MAX) {
+      current_ = AcquireBuffer(lock);
+    }
+
+    Buffer &buffer = buffers_[current_];
+    const std::size_t count =
+        std::min(data.size(), options_.bufferSize - buffer.bytes);
+    std::memcpy(buffer.data + buffer.bytes, data.data(), count);
+    buffer.bytes += count;
+    size_ += count;
+    data = data.subspan(count);
+
+    if (buffer.bytes == options_.bufferSize) {
+      SubmitBuffer(std::exchange(current_, SIZE_MAX), lock);
+    }
+  }
+
+  if (onComplete) {
+    callbacks_.push_back({size_, std::move(onComplete)});
+  }
+  return !failed_;
+}
+
+void AsyncWriter::SubmitBuffer(std::size_t index,
+                               std::unique_lock<std::mutex> & /*lock*/) {
+  submitted_.push_back(index);
+  SubmitWrite(index);
+}
+
+void AsyncWriter::SubmitWrite(std::size_t index) {
+  if (backend_ == AsyncWriterBackend::IoUring) {
+    SubmitRingWrite(index);
+  } else {
+    SubmitPoolWrite(index);
+  }
+}
+
+void AsyncWriter::SubmitRingWrite(std::size_t index) {
+#ifdef IO_HAS_IO_URING
+  const Buffer &buffer = buffers_[index];
+  io_uring_sqe &entry = ring_->NextEntry();
+  entry.opcode = ring_->fixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+  entry.fd = fd_;
+  entry.addr = reinterpret_cast<std::uint64_t>(buffer.data + buffer.written);
+  entry.len = static_cast<std::uint32_t>(buffer.bytes - buffer.written);
+  entry.off = buffer.offset + buffer.written;
+  entry.buf_index = static_cast<std::uint16_t>(index);
+  entry.user_data = index;
+
+  if (!ring_->Submit()) {
+    spdlog::warn("io_uring submission failed ({}), writing on the pool",
+                 std::strerror(errno));
+    SubmitPoolWrite(index);
+  }
+#else
+  SubmitPoolWrite(index);
+#endif
+}
+
+void AsyncWriter::SubmitPoolWrite(std::size_t index) {
+  // Buffer fields are not touched by anyone else while the write is in flight
+  ++poolWrites_;
+  threadPool_.Submit(Core::TaskPriority::Background, [this, index] {
+    const Buffer &buffer = buffers_[index];
+    const std::byte *data = buffer.data + buffer.written;
+    std::size_t remaining = buffer.bytes - buffer.written;
+    std::uint64_t offset = buffer.offset + buffer.written;
+    long result = 0;
+
+#ifdef IO_HAS_PWRITE
+    while (remaining > 0) {
+      const ssize_t written =
+          ::pwrite(fd_, data, remaining, static_cast<off_t>(offset));
+      if (written < 0 && errno == EINTR)
+        continue;
+      if (written <= 0) {
+        result = written < 0 ? -errno : -EIO;
+        break;
+      }
+      data += written;
+      remaining -= static_cast<std::size_t>(written);
+      offset += static_cast<std::uint64_t>(written);
+      result += written;
+    }
+#else
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stream_->seekp(static_cast<std::streamoff>(offset));
+      stream_->write(reinterpret_cast<const char *>(data),
+                     static_cast<std::streamsize>(remaining));
+      result = *stream_ ? static_cast<long>(remaining) : -1;
+    }
+#endif
+
+    OnWriteComplete(index, result);
+
+    // Last use of this: Close waits for the count, as it joins the
+    // completion thread of the ring
+    std::lock_guard<std::mutex> lock(mutex_);
+    --poolWrites_;
+    writeCompleted_.notify_all();
+  });
+}
+
+void AsyncWriter::OnWriteComplete(std::size_t index, long result) {
+  std::vector<Completion> ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Buffer &buffer = buffers_[index];
+
+    if (result <= 0) {
+      if (!failed_.exchange(true)) {
+        spdlog::error("Async write at offset {} failed: {}", buffer.offset,
+                      std::strerror(result < 0 ? static_cast<int>(-result)
+                                               : EIO));
+      }
+      buffer.done = true;
+    } else {
+      buffer.written += static_cast<std::size_t>(result);
+      if (buffer.written < buffer.bytes) {
+        SubmitWrite(index); // Short write: queue the rest
+        return;
+      }
+      buffer.done = true;
+    }
+
+    // Buffers are recycled in file order, so everything before the oldest
+    // unfinished buffer is on disk
+    while (!submitted_.empty() && buffers_[submitted_.front()].done) {
+      freeBuffers_.push_back(submitted_.front());
+      submitted_.pop_front();
+    }
+    const std::uint64_t durable =
+        !submitted_.empty()     ? buffers_[submitted_.front()].offset
+        : current_ != SIZE_MAX ? buffers_[current_].offset
+                                : size_;
+    while (!callbacks_.empty() && callbacks_.front().endOffset <= durable) {
+      ready.push_back(std::move(callbacks_.front().callback));
+      callbacks_.pop_front();
+    }
+  }
+  writeCompleted_.notify_all();
+
+  const bool success = !failed_;
+  for (auto &callback : ready) {
+    threadPool_.Submit(Core::TaskPriority::Background, std::move(callback),
+                       success);
+  }
+}
+
+void AsyncWriter::CompletionThread() {
+#ifdef IO_HAS_IO_URING
+  Ring &ring = *ring_;
+  for (;;) {
+    unsigned head = *ring.cqHead;
+    const unsigned tail = LoadAcquire(ring.cqTail);
+    if (head == tail) {
+      ::syscall(__NR_io_uring_enter, ring.fd, 0, 1, IORING_ENTER_GETEVENTS,
+                nullptr, 0);
+      continue;
+    }
+
+    bool stop = false;
+    for (; head != tail; ++head) {
+      const io_uring_cqe &completion = ring.cqes[head & *ring.cqMask];
+      if (completion.user_data == WAKE_USER_DATA) {
+        stop = true;
+      } else {
+        OnWriteComplete(static_cast<std::size_t>(completion.user_data),
+                        completion.res);
+      }
+    }
+    StoreRelease(ring.cqHead, head);
+    if (stop)
+      return;
+  }
+#endif
+}
+
+bool AsyncWriter::Close() {
+  if (!IsOpen())
+    return true;
+
+  bool padded = false;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (current_ != SIZE_MAX) {
+      Buffer &buffer = buffers_[current_];
+      // O_DIRECT needs whole blocks; the file is trimmed afterwards
+      if (direct_ && buffer.bytes % AsyncWriterOptions::DIRECT_IO_ALIGNMENT) {
+        const std::size_t aligned = AlignUp(buffer.bytes);
+        std::memset(buffer.data + buffer.bytes, 0, aligned - buffer.bytes);
+        buffer.bytes = aligned;
+        padded = true;
+      }
+      if (buffer.bytes > 0) {
+        SubmitBuffer(current_, lock);
+      } else {
+        freeBuffers_.push_back(current_);
+      }
+      current_ = SIZE_MAX;
+    }
+    writeCompleted_.wait(
+        lock, [this] { return submitted_.empty() && poolWrites_ == 0; });
+  }
+
+  // Appends with nothing left to wait for
+  for (auto &pending : callbacks_) {
+    threadPool_.Submit(Core::TaskPriority::Background,
+                       std::move(pending.callback), !failed_);
+  }
+  callbacks_.clear();
+
+#ifdef IO_HAS_IO_URING
+  if (completionThread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      io_uring_sqe &entry = ring_->NextEntry();
+      entry.opcode = IORING_OP_NOP;
+      entry.user_data = WAKE_USER_DATA;
+      ring_->Submit();
+    }
+    completionThread_.join();
+  }
+#endif
+  ring_.reset();
+
+#ifdef IO_HAS_PWRITE
+  if (fd_ >= 0) {
+    if (padded && ::ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+      failed_ = true;
+    }
+    if (::close(fd_) != 0) {
+      failed_ = true;
+    }
+    fd_ = -1;
+  }
+#endif
+  if (stream_) {
+    stream_->close();
+    failed_ = failed_ || stream_->fail();
+    stream_.reset();
+  }
+
+  ReleaseStorage();
+  return !failed_;
+}
+
+void AsyncWriter::ReleaseStorage() {
+  std::free(storage_);
+  storage_ = nullptr;
+  buffers_.clear();
+  freeBuffers_.clear();
+  submitted_.clear();
+}
+
+} // namespace IO
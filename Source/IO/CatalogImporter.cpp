@@ -0,0 +1,350 @@
+#include "IO/CatalogImporter.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Graphics/ParticleSystem.hpp"
+#include "IO/MappedFile.hpp"
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace IO {
+
+namespace {
+
+// A slice of the catalog (bytes for text, records for binary) and the stars
+// parsed from it. Only accepted rows get a slot in the particle pool.
+struct CatalogChunk {
+  std::size_t begin = 0;
+  std::size_t end = 0;
+  std::vector<Graphics::Particle> stars;
+  std::size_t firstParticle = 0;
+  std::size_t skippedRows = 0;
+};
+
+constexpr std::size_t MAX_COLUMNS = CatalogImporter::BINARY_RECORD_FLOATS;
+constexpr std::size_t BINARY_CHUNK_RECORDS = 64 * 1024;
+
+CatalogFormat DetectFormat(const std::string &path,
+                           std::span<const char> data) {
+  auto dot = path.find_last_of('.');
+  std::string extension = dot == std::string::npos ? "" : path.substr(dot);
+  std::ranges::transform(extension, extension.begin(),
+                         [](char c) { return static_cast<char>(std::tolower(c)); });
+
+  if (extension == ".bin" || extension == ".dat" || extension == ".raw") {
+    return CatalogFormat::Binary;
+  }
+  if (extension == ".tsv") {
+    return CatalogFormat::Tsv;
+  }
+  if (extension == ".csv") {
+    return CatalogFormat::Csv;
+  }
+
+  // Unknown extension: sniff the first line for tabs
+  auto lineEnd = std::find(data.begin(), data.end(), '\n');
+  return std::find(data.begin(), lineEnd, '\t') != lineEnd ? CatalogFormat::Tsv
+                                                           : CatalogFormat::Csv;
+}
+
+bool IsSpace(char c, char delimiter) {
+  return (c == ' ' || c == '\t' || c == '\r') && c != delimiter;
+}
+
+bool IsHeaderLine(std::string_view line) {
+  auto first = line.find_first_not_of(" \t");
+  if (first == std::string_view::npos) {
+    return false;
+  }
+  char c = line[first];
+  return !(std::isdigit(static_cast<unsigned char>(c)) || c == '-' ||
+           c == '+' || c == '.');
+}
+
+// Parses up to MAX_COLUMNS numeric fields. Returns the number of fields read,
+// 0 for blank/comment lines and -1 for malformed rows.
+int ParseRow(const char *p, const char *end, char delimiter,
+             float (&values)[MAX_COLUMNS]) {
+  int fields = 0;
+
+  while (p < end && IsSpace(*p, delimiter)) {
+    ++p;
+  }
+  if (p == end || *p == '#') {
+    return 0;
+  }
+
+  while (p < end) {
+    if (fields == static_cast<int>(MAX_COLUMNS)) {
+      break; // Extra columns are ignored
+    }
+    if (*p == '+') {
+      ++p;
+    }
+
+    auto [next, ec] = std::from_chars(p, end, values[fields]);
+    if (ec != std::errc()) {
+      return -1;
+    }
+    ++fields;
+    p = next;
+
+    while (p < end && IsSpace(*p, delimiter)) {
+      ++p;
+    }
+    if (p == end) {
+      break;
+    }
+    if (*p != delimiter) {
+      return -1;
+    }
+    ++p;
+    while (p < end && IsSpace(*p, delimiter)) {
+      ++p;
+    }
+  }
+
+  return fields;
+}
+
+// B-V colour index -> RGB via Ballesteros' temperature estimate and a
+// blackbody curve fit.
+sf::Color ColorFromColorIndex(float colorIndex) {
+  double bv = std::clamp(static_cast<double>(colorIndex), -0.4, 2.0);
+  double temperature =
+      4600.0 * (1.0 / (0.92 * bv + 1.7) + 1.0 / (0.92 * bv + 0.62));
+  double t = temperature / 100.0;
+
+  double r = t <= 66.0 ? 255.0 : 329.698727446 * std::pow(t - 60.0, -0.1332047592);
+  double g = t <= 66.0 ? 99.4708025861 * std::log(t) - 161.1195681661
+                       : 288.1221695283 * std::pow(t - 60.0, -0.0755148492);
+  double b = t >= 66.0   ? 255.0
+             : t <= 19.0 ? 0.0
+                         : 138.5177312231 * std::log(t - 10.0) - 305.0447927307;
+
+  auto channel = [](double v) {
+    return static_cast<sf::Uint8>(std::clamp(v, 0.0, 255.0));
+  };
+  return sf::Color(channel(r), channel(g), channel(b), 255);
+}
+
+bool FillParticle(Graphics::Particle &particle, const float *values,
+                  int fields, const CatalogImportOptions &options) {
+  float mass = fields > 4 ? values[4] : 1.0f;
+  float colorIndex = fields > 5 ? values[5] : 0.65f; // Sun-like default
+
+  if (!std::isfinite(values[0]) || !std::isfinite(values[1]) ||
+      !std::isfinite(mass) || mass <= 0.0f) {
+    return false;
+  }
+
+  particle.position =
+      options.origin + glm::vec2(values[0], values[1]) * options.positionScale;
+  particle.velocity =
+      fields > 3 ? glm::vec2(values[2], values[3]) * options.velocityScale
+                 : glm::vec2(0.0f, 0.0f);
+  particle.acceleration = glm::vec2(0.0f, 0.0f);
+  particle.mass = mass;
+  particle.color = ColorFromColorIndex(colorIndex);
+  particle.size = std::clamp(std::cbrt(mass), 0.2f, 3.0f);
+  particle.lifetime = 1000000.0f;
+  particle.age = 0.0f;
+  particle.active = true;
+  return true;
+}
+
+float ReadLittleEndianFloat(const char *bytes) {
+  std::uint32_t bits;
+  std::memcpy(&bits, bytes, sizeof(bits));
+  if constexpr (std::endian::native == std::endian::big) {
+    bits = std::byteswap(bits);
+  }
+  return std::bit_cast<float>(bits);
+}
+
+// Sizes the pool to exactly the accepted stars and copies each chunk into its
+// slice. Returns the number of stars copied.
+std::size_t CopyAcceptedStars(Core::ThreadPool &threadPool,
+                              Graphics::ParticleSystem &particleSystem,
+                              std::vector<CatalogChunk> &chunks) {
+  std::size_t starCount = 0;
+  for (auto &chunk : chunks) {
+    chunk.firstParticle = starCount;
+    starCount += chunk.stars.size();
+  }
+  if (starCount == 0) {
+    return 0;
+  }
+
+  particleSystem.Resize(starCount);
+  auto &particles = particleSystem.GetParticles();
+  threadPool.ParallelFor(chunks.size(), 1, [&](std::size_t c, std::size_t) {
+    std::ranges::copy(chunks[c].stars,
+                      particles.begin() +
+                          static_cast<std::ptrdiff_t>(chunks[c].firstParticle));
+  });
+  return starCount;
+}
+
+} // namespace
+
+std::string_view ToString(CatalogError error) {
+  switch (error) {
+  case CatalogError::OpenFailed:
+    return "could not open catalog";
+  case CatalogError::EmptyCatalog:
+    return "catalog contains no usable rows";
+  case CatalogError::TruncatedBinary:
+    return "binary catalog is smaller than one record";
+  }
+  return "unknown catalog error";
+}
+
+CatalogImporter::CatalogImporter(Core::ThreadPool &threadPool)
+    : threadPool_(threadPool) {}
+
+std::expected<CatalogImportStats, CatalogError>
+CatalogImporter::Import(const std::string &path,
+                        Graphics::ParticleSystem &particleSystem,
+                        const CatalogImportOptions &options) {
+  auto startTime = std::chrono::steady_clock::now();
+
+  MappedFile file;
+  if (!file.Open(path)) {
+    return std::unexpected(CatalogError::OpenFailed);
+  }
+
+  auto data = file.GetData();
+  CatalogFormat format = options.format == CatalogFormat::Auto
+                             ? DetectFormat(path, data)
+                             : options.format;
+  CatalogImportStats stats;
+
+  if (format == CatalogFormat::Binary) {
+    constexpr std::size_t recordBytes = BINARY_RECORD_FLOATS * sizeof(float);
+    std::size_t recordCount = data.size() / recordBytes;
+
+    if (recordCount == 0) {
+      return std::unexpected(CatalogError::TruncatedBinary);
+    }
+    if (data.size() % recordBytes != 0) {
+      spdlog::warn("Ignoring {} trailing bytes in '{}'",
+                   data.size() % recordBytes, path);
+    }
+
+    std::vector<CatalogChunk> chunks(
+        (recordCount + BINARY_CHUNK_RECORDS - 1) / BINARY_CHUNK_RECORDS);
+
+    threadPool_.ParallelFor(
+        recordCount, BINARY_CHUNK_RECORDS,
+        [&](std::size_t begin, std::size_t end) {
+          auto &chunk = chunks[begin / BINARY_CHUNK_RECORDS];
+          chunk.stars.reserve(end - begin);
+          float values[BINARY_RECORD_FLOATS];
+          Graphics::Particle star;
+
+          for (std::size_t i = begin; i < end; ++i) {
+            const char *record = data.data() + i * recordBytes;
+            for (std::size_t c = 0; c < BINARY_RECORD_FLOATS; ++c) {
+              values[c] = ReadLittleEndianFloat(record + c * sizeof(float));
+            }
+            if (FillParticle(star, values, BINARY_RECORD_FLOATS, options)) {
+              chunk.stars.push_back(star);
+            } else {
+              ++chunk.skippedRows;
+            }
+          }
+        });
+
+    stats.particleCount = CopyAcceptedStars(threadPool_, particleSystem, chunks);
+    for (const auto &chunk : chunks) {
+      stats.skippedRows += chunk.skippedRows;
+    }
+    if (stats.particleCount == 0) {
+      return std::unexpected(CatalogError::EmptyCatalog);
+    }
+  } else {
+    const char delimiter = format == CatalogFormat::Tsv ? '\t' : ',';
+
+    // Skip a column header if present
+    std::size_t bodyStart = 0;
+    auto firstLineEnd = std::find(data.begin(), data.end(), '\n');
+    if (IsHeaderLine(std::string_view(
+            data.data(), static_cast<std::size_t>(firstLineEnd - data.begin())))) {
+      bodyStart = static_cast<std::size_t>(firstLineEnd - data.begin()) + 1;
+    }
+
+    // Split the body into chunks that end on line boundaries
+    std::vector<CatalogChunk> chunks;
+    const std::size_t chunkBytes = std::max<std::size_t>(options.chunkBytes, 1);
+    for (std::size_t begin = bodyStart; begin < data.size();) {
+      std::size_t end = std::min(begin + chunkBytes, data.size());
+      if (end < data.size()) {
+        const void *newline =
+            std::memchr(data.data() + end, '\n', data.size() - end);
+        end = newline ? static_cast<std::size_t>(
+                            static_cast<const char *>(newline) - data.data()) + 1
+                      : data.size();
+      }
+      auto &chunk = chunks.emplace_back();
+      chunk.begin = begin;
+      chunk.end = end;
+      begin = end;
+    }
+
+    // Parse each chunk into its own list of accepted stars
+    threadPool_.ParallelFor(chunks.size(), 1, [&](std::size_t c, std::size_t) {
+      auto &chunk = chunks[c];
+      const char *p = data.data() + chunk.begin;
+      const char *chunkEnd = data.data() + chunk.end;
+      float values[MAX_COLUMNS];
+      Graphics::Particle star;
+
+      while (p < chunkEnd) {
+        const char *lineEnd = static_cast<const char *>(
+            std::memchr(p, '\n', static_cast<std::size_t>(chunkEnd - p)));
+        if (!lineEnd) {
+          lineEnd = chunkEnd;
+        }
+
+        int fields = ParseRow(p, lineEnd, delimiter, values);
+        if (fields >= 2 && FillParticle(star, values, fields, options)) {
+          chunk.stars.push_back(star);
+        } else {
+          ++chunk.skippedRows;
+        }
+
+        p = lineEnd < chunkEnd ? lineEnd + 1 : chunkEnd;
+      }
+    });
+
+    stats.particleCount = CopyAcceptedStars(threadPool_, particleSystem, chunks);
+    for (const auto &chunk : chunks) {
+      stats.skippedRows += chunk.skippedRows;
+    }
+    if (stats.particleCount == 0) {
+      return std::unexpected(CatalogError::EmptyCatalog);
+    }
+  }
+
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - startTime)
+                      .count();
+
+  spdlog::info("Imported {} stars from '{}' in {:.3f}s ({:.1f}M rows/s, {} "
+               "rows skipped)",
+               stats.particleCount, path, stats.seconds,
+               stats.seconds > 0.0
+                   ? (stats.particleCount + stats.skippedRows) / stats.seconds / 1e6
+                   : 0.0,
+               stats.skippedRows);
+
+  return stats;
+}
+
+} // namespace IO
@@ -0,0 +1,232 @@
+#include "IO/Checkpoint.hpp"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+
+namespace IO {
+
+static_assert(std::endian::native == std::endian::little,
+              "Checkpoints are stored little-endian and mapped in place");
+static_assert(std::is_trivially_copyable_v<Graphics::Particle>);
+static_assert(std::is_trivially_copyable_v<glm::vec2>);
+
+namespace {
+
+constexpr std::size_t SECTION_COUNT = 4;
+
+std::uint64_t AlignUp(std::uint64_t value) {
+  return (value + CHECKPOINT_ALIGNMENT - 1) / CHECKPOINT_ALIGNMENT *
+         CHECKPOINT_ALIGNMENT;
+}
+
+template <typename T>
+CheckpointSection MakeSection(CheckpointSectionType type, std::size_t count) {
+  CheckpointSection section;
+  section.type = type;
+  section.recordSize = sizeof(T);
+  section.count = count;
+  section.bytes = count * sizeof(T);
+  return section;
+}
+
+template <typename T>
+std::expected<std::span<const T>, CheckpointError>
+GetSection(std::span<const char> file,
+           std::span<const CheckpointSection> sections,
+           CheckpointSectionType type) {
+  auto it = std::ranges::find(sections, type, &CheckpointSection::type);
+  if (it == sections.end())
+    return std::unexpected(CheckpointError::MissingSection);
+
+  if (it->recordSize != sizeof(T) || it->bytes != it->count * sizeof(T) ||
+      it->offset % CHECKPOINT_ALIGNMENT != 0)
+    return std::unexpected(CheckpointError::LayoutMismatch);
+  if (it->offset > file.size() || it->bytes > file.size() - it->offset)
+    return std::unexpected(CheckpointError::Truncated);
+
+  // The mapping is page aligned and sections are 64-byte aligned
+  return std::span<const T>(
+      reinterpret_cast<const T *>(file.data() + it->offset), it->count);
+}
+
+} // namespace
+
+std::string_view ToString(CheckpointError error) {
+  switch (error) {
+  case CheckpointError::OpenFailed:
+    return "could not open file";
+  case CheckpointError::WriteFailed:
+    return "could not write file";
+  case CheckpointError::BadMagic:
+    return "not a checkpoint file";
+  case CheckpointError::UnsupportedVersion:
+    return "unsupported checkpoint version";
+  case CheckpointError::Truncated:
+    return "file is truncated";
+  case CheckpointError::LayoutMismatch:
+    return "record layout differs from this build";
+  case CheckpointError::MissingSection:
+    return "required section is missing";
+  }
+  return "unknown error";
+}
+
+std::expected<void, CheckpointError>
+WriteCheckpoint(const CheckpointState &state,
+                const std::filesystem::path &path) {
+  std::array<CheckpointSection, SECTION_COUNT> sections = {
+      MakeSection<Graphics::Particle>(CheckpointSectionType::Particles,
+                                      state.particles.size()),
+      MakeSection<CheckpointBody>(CheckpointSectionType::Bodies,
+                                  state.bodies.size()),
+      MakeSection<glm::vec2>(CheckpointSectionType::Trails,
+                             state.trails.size()),
+      MakeSection<char>(CheckpointSectionType::RngState,
+                        state.rngState.size())};
+  const std::array<const void *, SECTION_COUNT> sources = {
+      state.particles.data(), state.bodies.data(), state.trails.data(),
+      state.rngState.data()};
+
+  std::uint64_t offset =
+      AlignUp(sizeof(CheckpointHeader) + sizeof(sections));
+  for (auto &section : sections) {
+    section.offset = offset;
+    offset = AlignUp(offset + section.bytes);
+  }
+
+  CheckpointHeader header = state.header;
+  header.magic = CHECKPOINT_MAGIC;
+  header.version = CHECKPOINT_VERSION;
+  header.sectionCount = SECTION_COUNT;
+
+  // Written beside the target and renamed, so a crash never leaves a
+  // half-written checkpoint in place
+  auto temporaryPath = path;
+  temporaryPath += ".tmp";
+  {
+    std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+      return std::unexpected(CheckpointError::OpenFailed);
+
+    const std::array<char, CHECKPOINT_ALIGNMENT> padding{};
+    std::uint64_t written = 0;
+    auto write = [&](const void *data, std::uint64_t bytes) {
+      file.write(static_cast<const char *>(data),
+                 static_cast<std::streamsize>(bytes));
+      written += bytes;
+    };
+    auto padTo = [&](std::uint64_t target) {
+      write(padding.data(), target - written);
+    };
+
+    write(&header, sizeof(header));
+    write(sections.data(), sizeof(sections));
+    for (std::size_t i = 0; i < SECTION_COUNT; ++i) {
+      padTo(sections[i].offset);
+      write(sources[i], sections[i].bytes);
+    }
+    padTo(offset);
+
+    if (!file.flush())
+      return std::unexpected(CheckpointError::WriteFailed);
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporaryPath, path, error);
+  if (error)
+    return std::unexpected(CheckpointError::WriteFailed);
+  return {};
+}
+
+std::expected<Checkpoint, CheckpointError>
+Checkpoint::Open(const std::string &path) {
+  Checkpoint checkpoint;
+  if (!checkpoint.file_.Open(path))
+    return std::unexpected(CheckpointError::OpenFailed);
+
+  auto data = checkpoint.file_.GetData();
+  if (data.size() < sizeof(CheckpointHeader))
+    return std::unexpected(CheckpointError::Truncated);
+
+  std::memcpy(&checkpoint.header_, data.data(), sizeof(CheckpointHeader));
+  const auto &header = checkpoint.header_;
+  if (header.magic != CHECKPOINT_MAGIC)
+    return std::unexpected(CheckpointError::BadMagic);
+  if (header.version != CHECKPOINT_VERSION)
+    return std::unexpected(CheckpointError::UnsupportedVersion);
+
+  const std::size_t tableBytes =
+      std::size_t{header.sectionCount} * sizeof(CheckpointSection);
+  if (data.size() - sizeof(CheckpointHeader) < tableBytes)
+    return std::unexpected(CheckpointError::Truncated);
+
+  std::span<const CheckpointSection> sections(
+      reinterpret_cast<const CheckpointSection *>(data.data() +
+                                                  sizeof(CheckpointHeader)),
+      header.sectionCount);
+
+  auto particles = GetSection<Graphics::Particle>(
+      data, sections, CheckpointSectionType::Particles);
+  auto bodies =
+      GetSection<CheckpointBody>(data, sections, CheckpointSectionType::Bodies);
+  auto trails =
+      GetSection<glm::vec2>(data, sections, CheckpointSectionType::Trails);
+  auto rngState =
+      GetSection<char>(data, sections, CheckpointSectionType::RngState);
+  if (!particles)
+    return std::unexpected(particles.error());
+  if (!bodies)
+    return std::unexpected(bodies.error());
+  if (!trails)
+    return std::unexpected(trails.error());
+  if (!rngState)
+    return std::unexpected(rngState.error());
+
+  checkpoint.particles_ = particles.value();
+  checkpoint.bodies_ = bodies.value();
+  checkpoint.trails_ = trails.value();
+  checkpoint.rngState_ =
+      std::string_view(rngState.value().data(), rngState.value().size());
+  return checkpoint;
+}
+
+CheckpointWriter::~CheckpointWriter() {
+  if (pending_.valid()) {
+    pending_.wait();
+  }
+}
+
+bool CheckpointWriter::IsBusy() const {
+  return pending_.valid() && pending_.wait_for(std::chrono::seconds(0)) !=
+                                 std::future_status::ready;
+}
+
+bool CheckpointWriter::WriteAsync(std::shared_ptr<const CheckpointState> state,
+                                  std::filesystem::path path) {
+  if (IsBusy())
+    return false;
+
+  pending_ = std::async(
+      std::launch::async, [state = std::move(state), path = std::move(path)] {
+        auto start = std::chrono::steady_clock::now();
+
+        auto result = WriteCheckpoint(*state, path);
+        if (!result) {
+          spdlog::error("Failed to write checkpoint '{}': {}", path.string(),
+                        ToString(result.error()));
+          return;
+        }
+
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        spdlog::info("Checkpoint of {} particles written to {} in {:.2f} s",
+                     state->particles.size(), path.string(), elapsed.count());
+      });
+  return true;
+}
+
+} // namespace IO
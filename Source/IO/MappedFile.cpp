@@ -0,0 +1,103 @@
+#include "IO/MappedFile.hpp"
+#include <fstream>
+#include <spdlog/spdlog.h>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IO_HAS_MMAP 1
+#endif
+
+namespace IO {
+
+MappedFile::~MappedFile() { Close(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, false)),
+      fallbackBuffer_(std::move(other.fallbackBuffer_)) {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mapped_ = std::exchange(other.mapped_, false);
+    fallbackBuffer_ = std::move(other.fallbackBuffer_);
+  }
+  return *this;
+}
+
+bool MappedFile::Open(const std::string &path) {
+  Close();
+
+#ifdef IO_HAS_MMAP
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    spdlog::error("Failed to open '{}'", path);
+    return false;
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    spdlog::error("Cannot map empty or unreadable file '{}'", path);
+    return false;
+  }
+
+  void *address = ::mmap(nullptr, static_cast<std::size_t>(info.st_size),
+                         PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+
+  if (address == MAP_FAILED) {
+    spdlog::error("mmap failed for '{}'", path);
+    return false;
+  }
+
+  // Each worker streams through its own contiguous slice of the file
+  ::madvise(address, static_cast<std::size_t>(info.st_size), MADV_SEQUENTIAL);
+
+  data_ = static_cast<const char *>(address);
+  size_ = static_cast<std::size_t>(info.st_size);
+  mapped_ = true;
+  return true;
+#else
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    spdlog::error("Failed to open '{}'", path);
+    return false;
+  }
+
+  auto size = static_cast<std::size_t>(file.tellg());
+  if (size == 0) {
+    spdlog::error("Cannot map empty file '{}'", path);
+    return false;
+  }
+
+  fallbackBuffer_.resize(size);
+  file.seekg(0);
+  file.read(fallbackBuffer_.data(), static_cast<std::streamsize>(size));
+
+  data_ = fallbackBuffer_.data();
+  size_ = size;
+  return true;
+#endif
+}
+
+void MappedFile::Close() {
+#ifdef IO_HAS_MMAP
+  if (mapped_ && data_) {
+    ::munmap(const_cast<char *>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  fallbackBuffer_.clear();
+}
+
+} // namespace IO
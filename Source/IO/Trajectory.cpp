@@ -0,0 +1,407 @@
+#include "IO/Trajectory.hpp"
+#include "Core/ThreadPool.hpp"
+#include "IO/TrajectoryCodec.hpp"
+#include "Utils/FlightRecorder.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+namespace IO {
+
+static_assert(std::endian::native == std::endian::little,
+              "Trajectory files are stored little-endian");
+
+namespace {
+
+constexpr std::size_t CHUNK_PARTICLES = TrajectoryOptions::CHUNK_PARTICLES;
+
+// Active flag plus the selected fields
+std::size_t WordsPerParticle(std::uint32_t fields) {
+  return 1 + (fields & TRAJECTORY_POSITION ? 2 : 0) +
+         (fields & TRAJECTORY_VELOCITY ? 2 : 0) +
+         (fields & TRAJECTORY_COLOR ? 1 : 0);
+}
+
+// Chunk c covers slots [c * CHUNK_PARTICLES, +count) and its words start at
+// the first slot times WordsPerParticle
+std::size_t ChunkParticles(std::size_t particleCount, std::size_t chunk) {
+  return std::min(CHUNK_PARTICLES, particleCount - chunk * CHUNK_PARTICLES);
+}
+
+template <typename T>
+bool ReadTable(std::span<const char> file, std::uint64_t offset,
+               std::uint64_t count, std::vector<T> &table) {
+  if (offset > file.size() || count > (file.size() - offset) / sizeof(T))
+    return false;
+  table.resize(count);
+  std::memcpy(table.data(), file.data() + offset, count * sizeof(T));
+  return true;
+}
+
+} // namespace
+
+std::string_view ToString(TrajectoryError error) {
+  switch (error) {
+  case TrajectoryError::OpenFailed:
+    return "could not open file";
+  case TrajectoryError::BadMagic:
+    return "not a trajectory file or not closed cleanly";
+  case TrajectoryError::UnsupportedVersion:
+    return "unsupported trajectory version";
+  case TrajectoryError::Truncated:
+    return "file is truncated";
+  case TrajectoryError::FrameOutOfRange:
+    return "frame index out of range";
+  case TrajectoryError::CorruptChunk:
+    return "chunk failed to decode";
+  }
+  return "unknown error";
+}
+
+TrajectoryWriter::TrajectoryWriter(Core::ThreadPool &threadPool)
+    : threadPool_(threadPool), file_(threadPool) {}
+
+TrajectoryWriter::~TrajectoryWriter() { Close(); }
+
+bool TrajectoryWriter::Open(const std::filesystem::path &path,
+                            const TrajectoryOptions &options) {
+  Close();
+
+  if (!file_.Open(path)) {
+    spdlog::error("Failed to open trajectory file '{}'", path.string());
+    return false;
+  }
+
+  options_ = options;
+  options_.maxFramesInFlight = std::max<std::size_t>(options_.maxFramesInFlight, 1);
+
+  TrajectoryFileHeader header;
+  header.fields = options_.fields;
+  file_.Append(&header, sizeof(header));
+
+  frames_.clear();
+  chunks_.clear();
+  offset_ = sizeof(header);
+  rawBytes_ = 0;
+  writtenBytes_ = sizeof(header);
+  closing_ = false;
+  writer_ = std::thread(&TrajectoryWriter::WriterThread, this);
+
+  spdlog::info("Writing trajectory to {}", path.string());
+  return true;
+}
+
+void TrajectoryWriter::SubmitFrame(std::span<const Graphics::Particle> particles,
+                                   std::uint64_t step, double time) {
+  if (!IsOpen())
+    return;
+  TRACE_SCOPE("Trajectory capture");
+
+  // Block rather than drop frames when encoding falls behind
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    queueChanged_.wait(lock, [this] {
+      return queue_.size() < options_.maxFramesInFlight;
+    });
+  }
+
+  const std::uint32_t fields = options_.fields;
+  const std::size_t wordsPerParticle = WordsPerParticle(fields);
+  auto frame = std::make_shared<FrameData>();
+  frame->particleCount = particles.size();
+  frame->words.resize(particles.size() * wordsPerParticle);
+
+  // Transpose each chunk into per-field word arrays
+  threadPool_.ParallelFor(
+      particles.size(), CHUNK_PARTICLES,
+      [&](std::size_t begin, std::size_t end) {
+        const std::size_t count = end - begin;
+        std::uint32_t *out = frame->words.data() + begin * wordsPerParticle;
+        for (std::size_t i = 0; i < count; ++i) {
+          const auto &particle = particles[begin + i];
+          std::uint32_t *word = out + i;
+          *word = particle.active ? 1 : 0;
+          if (fields & TRAJECTORY_POSITION) {
+            word[count] = std::bit_cast<std::uint32_t>(particle.position.x);
+            word[2 * count] = std::bit_cast<std::uint32_t>(particle.position.y);
+            word += 2 * count;
+          }
+          if (fields & TRAJECTORY_VELOCITY) {
+            word[count] = std::bit_cast<std::uint32_t>(particle.velocity.x);
+            word[2 * count] = std::bit_cast<std::uint32_t>(particle.velocity.y);
+            word += 2 * count;
+          }
+          if (fields & TRAJECTORY_COLOR) {
+            word[count] = particle.color.toInteger();
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  // Deltas need the same slots as the previous frame
+  const std::uint32_t index = submittedFrames_++;
+  std::shared_ptr<const FrameData> reference;
+  if (previousFrame_ && previousFrame_->particleCount == particles.size() &&
+      index - keyframe_ < std::max<std::uint32_t>(options_.keyframeInterval, 1)) {
+    reference = previousFrame_;
+  } else {
+    keyframe_ = index;
+  }
+
+  PendingFrame pending;
+  pending.entry.step = step;
+  pending.entry.time = time;
+  pending.entry.particleCount = static_cast<std::uint32_t>(particles.size());
+  pending.entry.keyframe = keyframe_;
+
+  // Encoding runs on the pool while the simulation carries on
+  for (std::size_t begin = 0; begin < particles.size();
+       begin += CHUNK_PARTICLES) {
+    const std::size_t first = begin * wordsPerParticle;
+    const std::size_t length =
+        std::min(CHUNK_PARTICLES, particles.size() - begin) * wordsPerParticle;
+    pending.chunks.push_back(threadPool_.Submit(
+        Core::TaskPriority::Background, [frame, reference, first, length] {
+          std::span<const std::uint32_t> words(frame->words);
+          return EncodeWords(
+              words.subspan(first, length),
+              reference ? std::span<const std::uint32_t>(reference->words)
+                              .subspan(first, length)
+                        : std::span<const std::uint32_t>());
+        }));
+  }
+  rawBytes_ += frame->words.size() * sizeof(std::uint32_t);
+  previousFrame_ = std::move(frame);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(pending));
+  }
+  queueChanged_.notify_all();
+}
+
+void TrajectoryWriter::WriterThread() {
+  for (;;) {
+    PendingFrame frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queueChanged_.wait(lock, [this] { return closing_ || !queue_.empty(); });
+      if (queue_.empty())
+        return;
+      frame = std::move(queue_.front());
+    }
+
+    frame.entry.firstChunk = static_cast<std::uint32_t>(chunks_.size());
+    frame.entry.chunkCount = static_cast<std::uint32_t>(frame.chunks.size());
+
+    for (std::size_t c = 0; c < frame.chunks.size(); ++c) {
+      auto encoded = frame.chunks[c].get();
+      file_.Append(encoded.data(), encoded.size());
+
+      const auto particleCount = static_cast<std::uint32_t>(
+          ChunkParticles(frame.entry.particleCount, c));
+      chunks_.push_back({offset_, static_cast<std::uint32_t>(encoded.size()),
+                         particleCount});
+      offset_ += encoded.size();
+      writtenBytes_ += encoded.size();
+    }
+    frames_.push_back(frame.entry);
+
+    // Only now does the frame stop counting against maxFramesInFlight
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      queue_.pop_front();
+    }
+    queueChanged_.notify_all();
+  }
+}
+
+void TrajectoryWriter::Close() {
+  if (!writer_.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  queueChanged_.notify_all();
+  writer_.join();
+  previousFrame_.reset();
+  submittedFrames_ = 0;
+  keyframe_ = 0;
+
+  TrajectoryTrailer trailer;
+  trailer.frameTableOffset = offset_;
+  trailer.frameCount = frames_.size();
+  trailer.chunkTableOffset = offset_ + frames_.size() * sizeof(TrajectoryFrameEntry);
+  trailer.chunkCount = chunks_.size();
+
+  file_.Append(frames_.data(), frames_.size() * sizeof(TrajectoryFrameEntry));
+  file_.Append(chunks_.data(), chunks_.size() * sizeof(TrajectoryChunkEntry));
+  file_.Append(&trailer, sizeof(trailer));
+
+  if (!file_.Close()) {
+    spdlog::error("Failed to finish trajectory file");
+  } else if (rawBytes_ > 0) {
+    spdlog::info("Trajectory closed: {} frames, {:.1f} MB raw stored in "
+                 "{:.1f} MB ({:.2f}x)",
+                 frames_.size(), rawBytes_ / 1e6, writtenBytes_ / 1e6,
+                 static_cast<double>(rawBytes_) / writtenBytes_);
+  }
+}
+
+std::expected<TrajectoryReader, TrajectoryError>
+TrajectoryReader::Open(const std::string &path) {
+  TrajectoryReader reader;
+  if (!reader.file_.Open(path))
+    return std::unexpected(TrajectoryError::OpenFailed);
+
+  auto data = reader.file_.GetData();
+  if (data.size() < sizeof(TrajectoryFileHeader) + sizeof(TrajectoryTrailer))
+    return std::unexpected(TrajectoryError::Truncated);
+
+  TrajectoryFileHeader header;
+  std::memcpy(&header, data.data(), sizeof(header));
+  TrajectoryTrailer trailer;
+  std::memcpy(&trailer, data.data() + data.size() - sizeof(trailer),
+              sizeof(trailer));
+
+  if (header.magic != TRAJECTORY_MAGIC || trailer.magic != TRAJECTORY_MAGIC)
+    return std::unexpected(TrajectoryError::BadMagic);
+  if (header.version != TRAJECTORY_VERSION)
+    return std::unexpected(TrajectoryError::UnsupportedVersion);
+
+  if (!ReadTable(data, trailer.frameTableOffset, trailer.frameCount,
+                 reader.frames_) ||
+      !ReadTable(data, trailer.chunkTableOffset, trailer.chunkCount,
+                 reader.chunks_))
+    return std::unexpected(TrajectoryError::Truncated);
+
+  for (std::size_t i = 0; i < reader.frames_.size(); ++i) {
+    const auto &frame = reader.frames_[i];
+    if (std::uint64_t{frame.firstChunk} + frame.chunkCount >
+        reader.chunks_.size())
+      return std::unexpected(TrajectoryError::Truncated);
+    // Delta chains must run backwards to a key frame of the same size
+    if (frame.keyframe > i ||
+        (frame.keyframe < i &&
+         (reader.frames_[i - 1].keyframe != frame.keyframe ||
+          reader.frames_[i - 1].particleCount != frame.particleCount)))
+      return std::unexpected(TrajectoryError::CorruptChunk);
+  }
+  for (const auto &chunk : reader.chunks_) {
+    if (chunk.offset > trailer.frameTableOffset ||
+        chunk.encodedBytes > trailer.frameTableOffset - chunk.offset)
+      return std::unexpected(TrajectoryError::Truncated);
+  }
+
+  reader.fields_ = header.fields;
+  return reader;
+}
+
+bool TrajectoryReader::DecodeFrameWords(
+    std::size_t index, std::span<const std::uint32_t> reference,
+    std::vector<std::uint32_t> &words) const {
+  const auto &entry = frames_[index];
+  const std::size_t wordsPerParticle = WordsPerParticle(fields_);
+  auto data = file_.GetData();
+
+  words.resize(std::size_t{entry.particleCount} * wordsPerParticle);
+  std::size_t first = 0;
+  for (std::uint32_t c = 0; c < entry.chunkCount; ++c) {
+    const auto &chunk = chunks_[entry.firstChunk + c];
+    if (first + chunk.particleCount > entry.particleCount)
+      return false;
+
+    const std::size_t begin = first * wordsPerParticle;
+    const std::size_t length = chunk.particleCount * wordsPerParticle;
+    std::span<const std::uint8_t> encoded(
+        reinterpret_cast<const std::uint8_t *>(data.data() + chunk.offset),
+        chunk.encodedBytes);
+    if (!DecodeWords(encoded, std::span(words).subspan(begin, length),
+                     reference.empty() ? reference
+                                       : reference.subspan(begin, length)))
+      return false;
+    first += chunk.particleCount;
+  }
+  return first == entry.particleCount;
+}
+
+std::expected<TrajectoryFrame, TrajectoryError>
+TrajectoryReader::ReadFrame(std::size_t index) {
+  if (index >= frames_.size())
+    return std::unexpected(TrajectoryError::FrameOutOfRange);
+
+  // Walk forward from the key frame, or from the last frame read if it lies
+  // on the same chain
+  const auto &entry = frames_[index];
+  std::size_t next = entry.keyframe;
+  if (lastIndex_ < index && lastIndex_ >= entry.keyframe) {
+    next = lastIndex_ + 1;
+  } else if (lastIndex_ == index) {
+    next = index + 1;
+  } else {
+    lastWords_.clear();
+  }
+
+  std::vector<std::uint32_t> words;
+  for (; next <= index; ++next) {
+    const bool isKeyframe = frames_[next].keyframe == next;
+    if (!DecodeFrameWords(next,
+                          isKeyframe ? std::span<const std::uint32_t>()
+                                     : std::span<const std::uint32_t>(lastWords_),
+                          words)) {
+      lastIndex_ = static_cast<std::size_t>(-1);
+      return std::unexpected(TrajectoryError::CorruptChunk);
+    }
+    std::swap(words, lastWords_);
+    lastIndex_ = next;
+  }
+
+  TrajectoryFrame frame;
+  frame.step = entry.step;
+  frame.time = entry.time;
+
+  const std::size_t count = entry.particleCount;
+  frame.active.resize(count);
+  if (fields_ & TRAJECTORY_POSITION)
+    frame.positions.resize(count);
+  if (fields_ & TRAJECTORY_VELOCITY)
+    frame.velocities.resize(count);
+  if (fields_ & TRAJECTORY_COLOR)
+    frame.colors.resize(count);
+
+  const std::size_t wordsPerParticle = WordsPerParticle(fields_);
+  for (std::size_t begin = 0; begin < count; begin += CHUNK_PARTICLES) {
+    const std::size_t chunkCount = ChunkParticles(count, begin / CHUNK_PARTICLES);
+    const std::uint32_t *word = lastWords_.data() + begin * wordsPerParticle;
+    auto takeArray = [&] {
+      const std::uint32_t *array = word;
+      word += chunkCount;
+      return array;
+    };
+
+    const std::uint32_t *active = takeArray();
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+      frame.active[begin + i] = active[i] != 0;
+    }
+    auto readVectors = [&](std::vector<glm::vec2> &values) {
+      const std::uint32_t *x = takeArray();
+      const std::uint32_t *y = takeArray();
+      for (std::size_t i = 0; i < chunkCount; ++i) {
+        values[begin + i] = {std::bit_cast<float>(x[i]),
+                             std::bit_cast<float>(y[i])};
+      }
+    };
+    if (fields_ & TRAJECTORY_POSITION)
+      readVectors(frame.positions);
+    if (fields_ & TRAJECTORY_VELOCITY)
+      readVectors(frame.velocities);
+    if (fields_ & TRAJECTORY_COLOR)
+      std::copy_n(takeArray(), chunkCount, frame.colors.begin() + begin);
+  }
+  return frame;
+}
+
+} // namespace IO
@@ -0,0 +1,213 @@
+#include "IO/TrajectoryCodec.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace IO {
+
+namespace {
+
+enum BlockMode : std::uint8_t { STORED = 0, COMPRESSED = 1 };
+
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 14;
+
+std::uint32_t Load32(const std::uint8_t *data) {
+  std::uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+// Small differences of either sign map to small unsigned values
+std::uint32_t ZigZag(std::uint32_t delta) {
+  return (delta << 1) ^ (0u - (delta >> 31));
+}
+
+std::uint32_t UnZigZag(std::uint32_t value) {
+  return (value >> 1) ^ (0u - (value & 1));
+}
+
+std::uint32_t Hash(std::uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void WriteLength(std::vector<std::uint8_t> &out, std::size_t length) {
+  while (length >= 255) {
+    out.push_back(255);
+    length -= 255;
+  }
+  out.push_back(static_cast<std::uint8_t>(length));
+}
+
+bool ReadLength(std::span<const std::uint8_t> in, std::size_t &ip,
+                std::size_t &length) {
+  std::uint8_t byte;
+  do {
+    if (ip >= in.size())
+      return false;
+    byte = in[ip++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+// One sequence: token (literal length << 4 | match length - 4), extended
+// lengths, literals, then a 16-bit offset and extended match length. The
+// final sequence carries literals only.
+void WriteSequence(std::vector<std::uint8_t> &out,
+                   std::span<const std::uint8_t> literals, std::size_t offset,
+                   std::size_t matchLength) {
+  const std::size_t literalLength = literals.size();
+  const std::size_t matchCode = matchLength ? matchLength - MIN_MATCH : 0;
+
+  out.push_back(static_cast<std::uint8_t>(
+      (std::min<std::size_t>(literalLength, 15) << 4) |
+      std::min<std::size_t>(matchCode, 15)));
+  if (literalLength >= 15) {
+    WriteLength(out, literalLength - 15);
+  }
+  out.insert(out.end(), literals.begin(), literals.end());
+
+  if (matchLength == 0)
+    return;
+
+  out.push_back(static_cast<std::uint8_t>(offset & 0xFF));
+  out.push_back(static_cast<std::uint8_t>(offset >> 8));
+  if (matchCode >= 15) {
+    WriteLength(out, matchCode - 15);
+  }
+}
+
+void CompressLZ(std::span<const std::uint8_t> in,
+                std::vector<std::uint8_t> &out) {
+  std::vector<std::int64_t> table(std::size_t{1} << HASH_BITS, -1);
+  std::size_t anchor = 0;
+  std::size_t pos = 0;
+
+  while (pos + MIN_MATCH <= in.size()) {
+    const std::uint32_t sequence = Load32(&in[pos]);
+    const std::uint32_t slot = Hash(sequence);
+    const std::int64_t candidate = table[slot];
+    table[slot] = static_cast<std::int64_t>(pos);
+
+    const auto ref = static_cast<std::size_t>(candidate);
+    if (candidate < 0 || pos - ref > MAX_OFFSET ||
+        Load32(&in[ref]) != sequence) {
+      ++pos;
+      continue;
+    }
+
+    std::size_t length = MIN_MATCH;
+    while (pos + length < in.size() && in[ref + length] == in[pos + length]) {
+      ++length;
+    }
+
+    WriteSequence(out, in.subspan(anchor, pos - anchor), pos - ref, length);
+    pos += length;
+    anchor = pos;
+  }
+
+  WriteSequence(out, in.subspan(anchor), 0, 0);
+}
+
+bool DecompressLZ(std::span<const std::uint8_t> in,
+                  std::span<std::uint8_t> out) {
+  std::size_t ip = 0;
+  std::size_t op = 0;
+
+  while (ip < in.size()) {
+    const std::uint8_t token = in[ip++];
+
+    std::size_t literalLength = token >> 4;
+    if (literalLength == 15 && !ReadLength(in, ip, literalLength))
+      return false;
+    if (literalLength > in.size() - ip || literalLength > out.size() - op)
+      return false;
+    std::memcpy(out.data() + op, in.data() + ip, literalLength);
+    ip += literalLength;
+    op += literalLength;
+
+    if (ip == in.size())
+      break; // Final, literal-only sequence
+
+    if (in.size() - ip < 2)
+      return false;
+    const std::size_t offset = in[ip] | (std::size_t{in[ip + 1]} << 8);
+    ip += 2;
+
+    std::size_t matchLength = token & 0x0F;
+    if (matchLength == 15 && !ReadLength(in, ip, matchLength))
+      return false;
+    matchLength += MIN_MATCH;
+
+    if (offset == 0 || offset > op || matchLength > out.size() - op)
+      return false;
+
+    // Byte by byte: matches may overlap their own output
+    for (std::size_t i = 0; i < matchLength; ++i, ++op) {
+      out[op] = out[op - offset];
+    }
+  }
+
+  return op == out.size();
+}
+
+} // namespace
+
+std::vector<std::uint8_t> EncodeWords(std::span<const std::uint32_t> words,
+                                      std::span<const std::uint32_t> reference) {
+  const std::size_t count = words.size();
+  const bool hasReference = reference.size() == count && count > 0;
+
+  // Delta against the reference, then transpose into byte planes
+  std::vector<std::uint8_t> shuffled(count * 4);
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::uint32_t delta =
+        hasReference ? ZigZag(words[i] - reference[i]) : words[i];
+    for (std::size_t b = 0; b < 4; ++b) {
+      shuffled[b * count + i] = static_cast<std::uint8_t>(delta >> (8 * b));
+    }
+  }
+
+  std::vector<std::uint8_t> encoded;
+  encoded.reserve(shuffled.size() / 2 + 16);
+  encoded.push_back(COMPRESSED);
+  CompressLZ(shuffled, encoded);
+
+  if (encoded.size() > shuffled.size()) {
+    encoded.assign(1, STORED);
+    encoded.insert(encoded.end(), shuffled.begin(), shuffled.end());
+  }
+  return encoded;
+}
+
+bool DecodeWords(std::span<const std::uint8_t> encoded,
+                 std::span<std::uint32_t> words,
+                 std::span<const std::uint32_t> reference) {
+  if (encoded.empty())
+    return false;
+
+  const std::size_t count = words.size();
+  std::vector<std::uint8_t> shuffled(count * 4);
+  const auto payload = encoded.subspan(1);
+
+  if (encoded[0] == STORED) {
+    if (payload.size() != shuffled.size())
+      return false;
+    std::ranges::copy(payload, shuffled.begin());
+  } else if (encoded[0] != COMPRESSED || !DecompressLZ(payload, shuffled)) {
+    return false;
+  }
+
+  const bool hasReference = reference.size() == count && count > 0;
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint32_t delta = 0;
+    for (std::size_t b = 0; b < 4; ++b) {
+      delta |= std::uint32_t{shuffled[b * count + i]} << (8 * b);
+    }
+    words[i] = hasReference ? reference[i] + UnZigZag(delta) : delta;
+  }
+  return true;
+}
+
+} // namespace IO
@@ -1,34 +1,55 @@
 #include "Modes/ParticleGalaxyMode.hpp"
 #include "Core/DisplaySystem.hpp"
 #include "Core/Renderer.hpp"
+#include "IO/CatalogImporter.hpp"
+#include "Physics/GravityKernels.hpp"
 #include "Utils/Math.hpp"
+#include "Utils/PerformanceProfiler.hpp"
 #include <algorithm>
-#include <execution>
+#include <limits>
 #include <numbers>
 #include <random>
 #include <spdlog/spdlog.h>
+#include <sstream>
 
 namespace Modes {
 
-struct ParticleGalaxyMode::QuadTreeNode {
-  glm::vec2 center;
-  float halfSize;
-  float totalMass = 0.0f;
-  glm::vec2 centerOfMass{0.0f, 0.0f};
-  std::vector<std::size_t> particleIndices;
-  std::unique_ptr<QuadTreeNode> children[4];
-
-  static constexpr std::size_t MAX_PARTICLES_PER_NODE = 10;
-  static constexpr float MIN_NODE_SIZE = 10.0f;
-};
-
 ParticleGalaxyMode::ParticleGalaxyMode(Core::DisplaySystem &displaySystem)
     : VisualMode(displaySystem),
-      particleSystem_(std::make_unique<Graphics::ParticleSystem>(30000)),
-      threadPool_(std::make_unique<Core::ThreadPool>()), massiveObjects_(),
-      rng_(std::random_device{}()) {}
+      threadPool_(std::make_unique<Core::ThreadPool>()),
+      seed_(std::random_device{}()), rng_(seed_),
+      clusterFinder_(std::make_unique<Analysis::ClusterFinder>(*threadPool_)),
+      profileAnalyzer_(
+          std::make_unique<Analysis::ProfileAnalyzer>(*threadPool_)),
+      particleLOD_(std::make_unique<Physics::ParticleLOD>(*threadPool_)),
+      spatialHash_(std::make_unique<Physics::SpatialHash>(*threadPool_)),
+      checkpointWriter_(std::make_unique<IO::CheckpointWriter>()),
+      trajectoryWriter_(std::make_unique<IO::TrajectoryWriter>(*threadPool_)) {
+  // Large particle buffers are first-touched by the workers that update them
+  Core::SetFirstTouchPool(threadPool_.get());
+  // Analysis and file writes may hold the other workers for a whole frame
+  if (threadPool_->GetNumThreads() >= MIN_THREADS_TO_RESERVE) {
+    threadPool_->SetReservedWorkers(RESERVED_FRAME_WORKERS);
+  }
+  GetDisplaySystem().GetProfiler().SetThreadPool(threadPool_.get());
+  physicsEngine_ =
+      std::make_unique<Physics::PhysicsEngine>(*threadPool_, MAX_PARTICLES);
+  particleSystem_ = &physicsEngine_->GetParticleSystem();
+  physicsEngine_->SetGravitationalConstant(GRAVITATIONAL_CONSTANT);
+  starfield_ = std::make_unique<Graphics::Starfield>(*threadPool_);
+
+  auto directSummation =
+      std::make_unique<Physics::DirectSummation>(*threadPool_);
+  directSummation_ = directSummation.get();
+  physicsEngine_->RegisterSolver(std::move(directSummation));
+
+  SetExecutionBackend(Core::ExecutionBackendType::ThreadPool);
+}
 
-ParticleGalaxyMode::~ParticleGalaxyMode() = default;
+ParticleGalaxyMode::~ParticleGalaxyMode() {
+  Core::SetFirstTouchPool(nullptr);
+  GetDisplaySystem().GetProfiler().SetThreadPool(nullptr);
+}
 
 void ParticleGalaxyMode::Initialize() {
   spdlog::info("Initializing Particle Galaxy Mode");
@@ -40,16 +61,34 @@ void ParticleGalaxyMode::Initialize() {
   // Set particle system blend mode for glowing effect
   particleSystem_->SetBlendMode(sf::BlendAdd);
 
+  ResetCamera();
+
+  fontLoaded_ = font_.loadFromFile("Assets/Fonts/arial.ttf");
+  if (!fontLoaded_) {
+    spdlog::warn("Failed to load HUD font");
+  }
+
   // Create initial galaxy
   CreateGalaxyPreset(0);
 }
 
 void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
   currentPreset_ = preset;
-
-  // Clear existing particles
-  massiveObjects_.clear();
+  catalogLoaded_ = false;
+  stepCount_ = 0;
+  rng_.seed(seed_ + static_cast<std::uint32_t>(preset));
+
+  // Clear existing particles; catalogs and checkpoints size the pool to
+  // their file, presets use the full pool again
+  GetBodies().clear();
+  if (particleSystem_->GetParticles().size() != MAX_PARTICLES) {
+    particleSystem_->Resize(MAX_PARTICLES);
+  }
   particleSystem_->Clear();
+  particleLOD_->Reset();
+  physicsEngine_->DiscardDeferredTime();
+  particleSystem_->InvalidateVertices();
+  InvalidateSpatialHash();
 
   auto windowSize = GetDisplaySystem().GetWindow().getSize();
   glm::vec2 center(windowSize.x * 0.5f, windowSize.y * 0.5f);
@@ -68,7 +107,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
     blackHole.mass = 30000.0f;
     blackHole.radius = 5.0f;
     blackHole.color = sf::Color(255, 255, 200);
-    massiveObjects_.push_back(blackHole);
+    GetBodies().push_back(blackHole);
 
     // Galaxy parameters for Milky Way
     const int numArms = 4; // Milky Way has 4 main spiral arms
@@ -99,7 +138,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
 
       // Orbital velocity
       float orbitalSpeed =
-          std::sqrt(gravitationalConstant_ * blackHole.mass / r) *
+          std::sqrt(GRAVITATIONAL_CONSTANT * blackHole.mass / r) *
           speedDist(rng_);
       glm::vec2 toCenter = glm::normalize(center - particle.position);
       particle.velocity = glm::vec2(-toCenter.y, toCenter.x) * orbitalSpeed;
@@ -197,7 +236,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
 
       // Orbital velocity with some variation
       float orbitalSpeed =
-          std::sqrt(gravitationalConstant_ * blackHole.mass / radius) *
+          std::sqrt(GRAVITATIONAL_CONSTANT * blackHole.mass / radius) *
           speedDist(rng_);
       glm::vec2 toCenter = glm::normalize(center - particle.position);
       particle.velocity = glm::vec2(-toCenter.y, toCenter.x) * orbitalSpeed;
@@ -309,7 +348,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
 
         // Cluster orbital velocity
         float orbitalSpeed =
-            std::sqrt(gravitationalConstant_ * blackHole.mass / clusterRadius) *
+            std::sqrt(GRAVITATIONAL_CONSTANT * blackHole.mass / clusterRadius) *
             0.8f;
         glm::vec2 toCenter = glm::normalize(center - clusterCenter);
         particle.velocity = glm::vec2(-toCenter.y, toCenter.x) * orbitalSpeed;
@@ -341,7 +380,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
     star1.mass = totalMass * 0.6f;
     star1.radius = 15.0f;
     star1.color = sf::Color(255, 200, 100);
-    massiveObjects_.push_back(star1);
+    GetBodies().push_back(star1);
 
     CelestialBody star2;
     star2.position = center + glm::vec2(separation * 0.5f, 0.0f);
@@ -349,7 +388,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
     star2.mass = totalMass * 0.4f;
     star2.radius = 12.0f;
     star2.color = sf::Color(100, 150, 255);
-    massiveObjects_.push_back(star2);
+    GetBodies().push_back(star2);
 
     // Create accretion disks
     for (int i = 0; i < 30000; ++i) {
@@ -358,7 +397,7 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
 
       // Randomly assign to one of the stars
       int starIndex = (i % 3 == 0) ? 0 : 1;
-      glm::vec2 starPos = massiveObjects_[starIndex].position;
+      glm::vec2 starPos = GetBodies()[starIndex].position;
 
       Graphics::Particle particle;
       particle.position = starPos + glm::vec2(radius * std::cos(angle),
@@ -367,10 +406,10 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
                                     );
 
       // Orbital velocity
-      float orbitalSpeed = std::sqrt(gravitationalConstant_ *
-                                     massiveObjects_[starIndex].mass / radius);
+      float orbitalSpeed = std::sqrt(GRAVITATIONAL_CONSTANT *
+                                     GetBodies()[starIndex].mass / radius);
       glm::vec2 toStar = glm::normalize(starPos - particle.position);
-      particle.velocity = massiveObjects_[starIndex].velocity +
+      particle.velocity = GetBodies()[starIndex].velocity +
                           glm::vec2(-toStar.y, toStar.x) * orbitalSpeed;
 
       particle.color = (starIndex == 0) ? sf::Color(255, 220, 180, 150)
@@ -435,13 +474,250 @@ void ParticleGalaxyMode::CreateGalaxyPreset(int preset) {
 
   spdlog::info(
       "Created galaxy preset {} with {} particles and {} massive objects",
-      preset, particleSystem_->GetActiveParticleCount(), massiveObjects_.size());
+      preset, particleSystem_->GetActiveParticleCount(), GetBodies().size());
+}
+
+bool ParticleGalaxyMode::LoadCatalog(const std::string &path) {
+  auto windowSize = GetDisplaySystem().GetWindow().getSize();
+  glm::vec2 center(windowSize.x * 0.5f, windowSize.y * 0.5f);
+
+  IO::CatalogImportOptions options;
+  options.origin = center;
+
+  IO::CatalogImporter importer(*threadPool_);
+  auto result = importer.Import(path, *particleSystem_, options);
+  if (!result) {
+    spdlog::error("Failed to load catalog '{}': {}", path,
+                  IO::ToString(result.error()));
+    return false;
+  }
+
+  GetBodies().clear();
+  particleLOD_->Reset();
+  physicsEngine_->DiscardDeferredTime();
+  particleSystem_->InvalidateVertices();
+  InvalidateSpatialHash();
+
+  CelestialBody blackHole;
+  blackHole.position = center;
+  blackHole.velocity = glm::vec2(0.0f, 0.0f);
+  blackHole.mass = CATALOG_CENTRAL_MASS;
+  blackHole.radius = 5.0f;
+  blackHole.color = sf::Color(255, 255, 200);
+  GetBodies().push_back(blackHole);
+
+  catalogPath_ = path;
+  catalogLoaded_ = true;
+  stepCount_ = 0;
+  return true;
+}
+
+bool ParticleGalaxyMode::SaveCheckpoint(const std::string &path) {
+  if (checkpointWriter_->IsBusy()) {
+    spdlog::warn("Previous checkpoint is still being written; skipping");
+    return false;
+  }
+  TRACE_SCOPE("Checkpoint snapshot");
+
+  // Merged stars live in their super-particles; put them back first
+  if (lodEnabled_) {
+    particleLOD_->SplitAll(particleSystem_->GetParticles());
+    particleSystem_->InvalidateVertices();
+    lodTimer_ = LOD_INTERVAL;
+  }
+  // Deferred stars are brought up to the current time
+  physicsEngine_->CatchUp();
+
+  if (!checkpointState_) {
+    checkpointState_ = std::make_shared<IO::CheckpointState>();
+  }
+  auto &state = *checkpointState_;
+
+  state.header.stepCount = stepCount_;
+  state.header.simulationTime = simulationTime_;
+  state.header.timeDilation = timeDilation_;
+  state.header.preset = currentPreset_;
+  state.header.seed = seed_;
+
+  // No-op resize when the pool size is unchanged since the last checkpoint
+  const auto &particles = particleSystem_->GetParticles();
+  state.particles.resize(particles.size());
+  threadPool_->ParallelFor(particles.size(), PHYSICS_CHUNK_SIZE,
+                           [&](std::size_t begin, std::size_t end) {
+                             std::copy(particles.begin() + begin,
+                                       particles.begin() + end,
+                                       state.particles.begin() + begin);
+                           },
+                           Core::TaskPriority::Critical);
+
+  state.bodies.clear();
+  state.trails.clear();
+  for (const auto &body : GetBodies()) {
+    state.bodies.push_back({body.position, body.velocity, body.mass,
+                            body.radius, body.color.toInteger(),
+                            static_cast<std::uint32_t>(body.trail.size())});
+    state.trails.insert(state.trails.end(), body.trail.begin(),
+                        body.trail.end());
+  }
+
+  std::ostringstream rngStream;
+  rngStream << rng_;
+  state.rngState = rngStream.str();
+
+  spdlog::info("Checkpoint snapshot taken at step {}, writing to {}",
+               stepCount_, path);
+  return checkpointWriter_->WriteAsync(checkpointState_, path);
+}
+
+bool ParticleGalaxyMode::RestoreCheckpoint(const std::string &path) {
+  auto checkpoint = IO::Checkpoint::Open(path);
+  if (!checkpoint) {
+    spdlog::error("Failed to restore checkpoint '{}': {}", path,
+                  IO::ToString(checkpoint.error()));
+    return false;
+  }
+
+  const auto &header = checkpoint.value().GetHeader();
+  auto bodies = checkpoint.value().GetBodies();
+  auto trails = checkpoint.value().GetTrails();
+
+  // Reset and demo mode rebuild the scene from the stored preset
+  if (header.preset < 0 || header.preset >= NUM_PRESETS) {
+    spdlog::error("Failed to restore checkpoint '{}': unknown preset {}",
+                  path, header.preset);
+    return false;
+  }
+
+  std::size_t trailPoints = 0;
+  for (const auto &record : bodies) {
+    trailPoints += record.trailCount;
+  }
+  if (trailPoints != trails.size()) {
+    spdlog::error("Failed to restore checkpoint '{}': trail table does not "
+                  "match its bodies",
+                  path);
+    return false;
+  }
+
+  // Parsed before any live state changes, so a bad section aborts cleanly
+  auto rng = rng_;
+  std::istringstream rngStream{std::string(checkpoint.value().GetRngState())};
+  if (!(rngStream >> rng)) {
+    spdlog::error("Failed to restore checkpoint '{}': corrupt random "
+                  "generator state",
+                  path);
+    return false;
+  }
+
+  // Particle records are copied straight out of the mapping
+  auto source = checkpoint.value().GetParticles();
+  if (source.size() != particleSystem_->GetParticles().size()) {
+    particleSystem_->Resize(source.size());
+  }
+  auto &particles = particleSystem_->GetParticles();
+  threadPool_->ParallelFor(source.size(), PHYSICS_CHUNK_SIZE,
+                           [&](std::size_t begin, std::size_t end) {
+                             std::copy(source.begin() + begin,
+                                       source.begin() + end,
+                                       particles.begin() + begin);
+                           },
+                           Core::TaskPriority::Critical);
+
+  GetBodies().clear();
+  std::size_t trailOffset = 0;
+  for (const auto &record : bodies) {
+    CelestialBody body;
+    body.position = record.position;
+    body.velocity = record.velocity;
+    body.mass = record.mass;
+    body.radius = record.radius;
+    body.color = sf::Color(record.color);
+    body.trail.assign(trails.begin() + trailOffset,
+                      trails.begin() + trailOffset + record.trailCount);
+    trailOffset += record.trailCount;
+    GetBodies().push_back(std::move(body));
+  }
+
+  rng_ = rng;
+  seed_ = header.seed;
+  currentPreset_ = header.preset;
+  timeDilation_ = header.timeDilation;
+  stepCount_ = header.stepCount;
+  simulationTime_ = header.simulationTime;
+  catalogLoaded_ = false;
+  particleLOD_->Reset();
+  physicsEngine_->DiscardDeferredTime();
+  particleSystem_->InvalidateVertices();
+  InvalidateSpatialHash();
+  lodTimer_ = LOD_INTERVAL;
+  MarkSceneDirty();
+
+  spdlog::info("Restored {} particles and {} bodies at step {} from {}",
+               source.size(), GetBodies().size(), stepCount_, path);
+  return true;
+}
+
+void ParticleGalaxyMode::SetExecutionBackend(Core::ExecutionBackendType type) {
+  executionBackend_ = Core::CreateExecutionBackend(type, *threadPool_);
+  physicsEngine_->SetExecutionBackend(executionBackend_.get());
+  spdlog::info("Particle passes run on the {} backend",
+               executionBackend_->GetName());
+}
+
+void ParticleGalaxyMode::SetFusedPipeline(bool enabled) {
+  physicsEngine_->SetFusedPipeline(enabled);
+  spdlog::info("Particle update and vertex generation run {}",
+               enabled ? "fused per chunk" : "as separate passes");
+}
+
+void ParticleGalaxyMode::SetParticleRenderer(
+    Graphics::ParticleRenderBackendType type) {
+  particleSystem_->SetRenderBackend(Graphics::CreateParticleRenderBackend(type));
+  spdlog::info("Stars are drawn by the {} particle renderer",
+               particleSystem_->GetRenderBackend().GetName());
+}
+
+void ParticleGalaxyMode::SelectFastestParticleRenderer() {
+  SetParticleRenderer(Graphics::SelectFastestParticleRenderBackend(
+      particleSystem_->GetParticles(),
+      GetDisplaySystem().GetWindow().getSize(), executionBackend_.get()));
+}
+
+void ParticleGalaxyMode::SetSeed(std::uint32_t seed) {
+  seed_ = seed;
+  spdlog::info("Preset seed set to {}", seed_);
+  CreateGalaxyPreset(currentPreset_);
+}
+
+std::uint64_t ParticleGalaxyMode::ComputeStateHash() const {
+  const auto &particles = particleSystem_->GetParticles();
+  std::span<const Graphics::Particle> all(particles);
+
+  // Chunk hashes are combined in chunk order
+  std::uint64_t hash = executionBackend_->Reduce(
+      particles.size(), PHYSICS_CHUNK_SIZE, std::uint64_t{0},
+      [all](std::size_t begin, std::size_t end) {
+        return Physics::HashParticleState(all.subspan(begin, end - begin));
+      },
+      Physics::CombineHashes);
+
+  for (const auto &body : GetBodies()) {
+    const float state[] = {body.position.x, body.position.y, body.velocity.x,
+                           body.velocity.y, body.mass};
+    hash = Physics::HashFloats(hash, state);
+  }
+  return hash;
 }
 
 void ParticleGalaxyMode::Update(float deltaTime) {
   if (paused_)
     return;
 
+  // Frame times vary from run to run; regression runs step by a fixed amount
+  if (deterministic_) {
+    deltaTime = FIXED_TIMESTEP;
+  }
+
   // Handle demo mode
   if (demoMode_) {
     demoTimer_ += deltaTime;
@@ -453,137 +729,356 @@ void ParticleGalaxyMode::Update(float deltaTime) {
     }
   }
 
-  float scaledDeltaTime = deltaTime * timeDilation_;
+  UpdateAudioReactivity(deltaTime);
+  float scaledDeltaTime = deltaTime * timeDilation_ * audioTimeScale_;
+
+  if (brushHeld_ && brush_ != Brush::Off) {
+    ApplyBrush(scaledDeltaTime);
+  }
+
+  // Bodies, star-star solver, tracers and drift
+  {
+    TRACE_SCOPE("UpdatePhysics");
+    UpdatePhysics(scaledDeltaTime);
+  }
+  simulationTime_ += scaledDeltaTime;
+  ++stepCount_;
+
+  if (sonifier_) {
+    UpdateSonification();
+  }
 
-  // Update physics in parallel
-  UpdatePhysics(scaledDeltaTime);
+  if (deterministic_ && stepCount_ % HASH_LOG_INTERVAL == 0) {
+    spdlog::info("Step {} state hash {:016x}", stepCount_, ComputeStateHash());
+  }
 
-  // Update particle system for rendering
-  particleSystem_->Update(scaledDeltaTime);
+  if (trajectoryWriter_->IsOpen() && stepCount_ % trajectoryInterval_ == 0) {
+    trajectoryWriter_->SubmitFrame(particleSystem_->GetParticles(), stepCount_,
+                                   simulationTime_);
+  }
+
+  UpdateLevelOfDetail(deltaTime);
+  UpdateBackgroundAnalysis(deltaTime);
 }
 
-void ParticleGalaxyMode::UpdatePhysics(float deltaTime) {
-  // Update massive objects (they affect each other)
-  for (std::size_t i = 0; i < massiveObjects_.size(); ++i) {
-    glm::vec2 totalForce(0.0f, 0.0f);
+void ParticleGalaxyMode::UpdateLevelOfDetail(float deltaTime) {
+  if (!lodEnabled_)
+    return;
 
-    for (std::size_t j = 0; j < massiveObjects_.size(); ++j) {
-      if (i == j)
-        continue;
+  lodTimer_ += deltaTime;
+  if (lodTimer_ < LOD_INTERVAL)
+    return;
+  lodTimer_ = 0.0f;
+
+  glm::vec2 visibleMin, visibleMax;
+  camera_.GetWorldBounds(visibleMin, visibleMax);
+  const glm::vec2 size = visibleMax - visibleMin;
+
+  // Full detail on screen and around the dominant body
+  Physics::InterestRegion region;
+  region.visibleMin = visibleMin - glm::vec2(LOD_MARGIN);
+  region.visibleMax = visibleMax + glm::vec2(LOD_MARGIN);
+  region.focus = camera_.GetPosition();
+  if (const CelestialBody *body = GetDominantBody()) {
+    region.focus = body->position;
+  }
+  region.focusRadius = std::max(size.x, size.y) * 0.6f;
 
-      totalForce += CalculateGravitationalForce(
-          massiveObjects_[i].position, massiveObjects_[j].position,
-          massiveObjects_[i].mass, massiveObjects_[j].mass);
-    }
+  TRACE_SCOPE("LOD refresh");
+  particleLOD_->Refresh(particleSystem_->GetParticles(), region);
+  particleSystem_->InvalidateVertices();
+}
 
-    glm::vec2 acceleration = totalForce / massiveObjects_[i].mass;
-    massiveObjects_[i].velocity += acceleration * deltaTime;
-    massiveObjects_[i].position += massiveObjects_[i].velocity * deltaTime;
+void ParticleGalaxyMode::UpdateBackgroundAnalysis(float deltaTime) {
+  clusterTimer_ += deltaTime;
+  analysisTimer_ += deltaTime;
 
-    // Update trail
-    if (showTrails_) {
-      massiveObjects_[i].trail.push_back(massiveObjects_[i].position);
-      if (massiveObjects_[i].trail.size() > CelestialBody::MAX_TRAIL_LENGTH) {
-        massiveObjects_[i].trail.erase(massiveObjects_[i].trail.begin());
-      }
+  bool clustersDue = showClusters_ && clusterTimer_ >= CLUSTER_INTERVAL &&
+                     !clusterFinder_->IsBusy();
+  bool profileDue = (showAnalysis_ || streamAnalysis_) &&
+                    analysisTimer_ >= ANALYSIS_INTERVAL &&
+                    !profileAnalyzer_->IsBusy();
+  if (!clustersDue && !profileDue)
+    return;
+
+  // Both analyses share one snapshot when they fall due together
+  TRACE_SCOPE("Analysis snapshot");
+  auto snapshot = Analysis::ParticleSnapshot::Capture(
+      particleSystem_->GetParticles(), *threadPool_);
+
+  if (profileDue) {
+    analysisTimer_ = 0.0f;
+
+    auto windowSize = GetDisplaySystem().GetWindow().getSize();
+    glm::vec2 center(windowSize.x * 0.5f, windowSize.y * 0.5f);
+    glm::vec2 centerVelocity(0.0f, 0.0f);
+    if (const CelestialBody *body = GetDominantBody()) {
+      center = body->position;
+      centerVelocity = body->velocity;
     }
+
+    profileAnalyzer_->AnalyzeAsync(
+        clustersDue ? snapshot : std::move(snapshot), center, centerVelocity,
+        simulationTime_);
   }
 
-  // Update particles in parallel batches
-  auto& particles = particleSystem_->GetParticles();
-  const std::size_t batchSize = particles.size() / threadPool_->GetNumThreads();
-  std::vector<std::future<void>> futures;
+  if (clustersDue) {
+    clusterTimer_ = 0.0f;
+    clusterFinder_->FindAsync(std::move(snapshot));
+  }
+}
+
+Core::TraceContext ParticleGalaxyMode::GetTraceContext() const {
+  Core::TraceContext context;
+  context.emplace_back("activeParticles",
+                       std::to_string(particleSystem_->GetActiveParticleCount()));
+  context.emplace_back("massiveObjects", std::to_string(GetBodies().size()));
+  context.emplace_back("scene", catalogLoaded_
+                                    ? catalogPath_
+                                    : "preset " + std::to_string(currentPreset_ + 1));
+  context.emplace_back("timeDilation", std::to_string(timeDilation_));
+  context.emplace_back("step", std::to_string(stepCount_));
+  context.emplace_back("seed", std::to_string(seed_));
+  context.emplace_back("backend", executionBackend_->GetName());
+  if (lodEnabled_) {
+    context.emplace_back("lodMergedParticles",
+                         std::to_string(particleLOD_->GetMergedParticleCount()));
+  }
+  return context;
+}
+
+const CelestialBody *ParticleGalaxyMode::GetDominantBody() const {
+  auto it = std::ranges::max_element(GetBodies(), {}, &CelestialBody::mass);
+  return it != GetBodies().end() ? &*it : nullptr;
+}
 
-  for (std::size_t i = 0; i < threadPool_->GetNumThreads(); ++i) {
-    std::size_t start = i * batchSize;
-    std::size_t end = (i == threadPool_->GetNumThreads() - 1)
-                          ? particles.size()
-                          : (i + 1) * batchSize;
+bool ParticleGalaxyMode::EnableAnalysisCsv(const std::string &path) {
+  streamAnalysis_ = profileAnalyzer_->OpenCsvStream(path);
+  return streamAnalysis_;
+}
 
-    futures.push_back(threadPool_->Submit([this, start, end, deltaTime]() {
-      UpdateParticlePhysics(start, end, deltaTime);
-    }));
+bool ParticleGalaxyMode::EnableTrajectoryOutput(const std::string &path,
+                                                std::uint64_t interval,
+                                                bool includeColors) {
+  IO::TrajectoryOptions options;
+  if (includeColors) {
+    options.fields |= IO::TRAJECTORY_COLOR;
   }
+  trajectoryInterval_ = std::max<std::uint64_t>(interval, 1);
+  return trajectoryWriter_->Open(path, options);
+}
 
-  // Wait for all threads to complete
-  for (auto &future : futures) {
-    future.wait();
+bool ParticleGalaxyMode::EnableAudio(const std::string &source) {
+  audioAnalyzer_ = std::make_unique<Audio::AudioAnalyzer>();
+  const bool started = source == "mic" ? audioAnalyzer_->StartCapture()
+                                       : audioAnalyzer_->PlayFile(source);
+  if (!started) {
+    audioAnalyzer_.reset();
   }
+  return started;
 }
 
-void ParticleGalaxyMode::UpdateParticlePhysics(std::size_t start,
-                                               std::size_t end,
-                                               float deltaTime) {
-  auto& particles = particleSystem_->GetParticles();
-  
-  for (std::size_t i = start; i < end && i < particles.size(); ++i) {
-    if (!particles[i].active)
+void ParticleGalaxyMode::UpdateAudioReactivity(float deltaTime) {
+  // Regression runs must not depend on what the microphone hears
+  if (!audioAnalyzer_ || deterministic_) {
+    audioTimeScale_ = audioGravityScale_ = 1.0f;
+    return;
+  }
+
+  // Never waits on the audio thread; without new analysis the last
+  // features stay in effect
+  audioFeatures_.onset = false;
+  audioAnalyzer_->Poll(audioFeatures_);
+  if (audioFeatures_.onset) {
+    audioPulse_ = std::min(audioPulse_ + 0.5f + audioFeatures_.onsetStrength, 2.0f);
+  }
+  audioPulse_ *= std::exp(-AUDIO_PULSE_DECAY * deltaTime);
+
+  audioTimeScale_ = 1.0f + AUDIO_TIME_GAIN * audioFeatures_.GetBass();
+  audioGravityScale_ = 1.0f + AUDIO_GRAVITY_GAIN * audioPulse_;
+}
+
+void ParticleGalaxyMode::EnableSonification(std::size_t bufferFrames) {
+  Audio::SonifierOptions options;
+  options.bufferFrames = bufferFrames;
+  sonifier_ = std::make_unique<Audio::Sonifier>(options);
+  UpdateSonification();
+  sonifier_->play();
+  spdlog::info("Sonification on, {} frame buffers ({:.1f} ms latency)",
+               options.bufferFrames,
+               3000.0 * options.bufferFrames / options.sampleRate);
+}
+
+void ParticleGalaxyMode::UpdateSonification() {
+  auto &parameters = sonifierParameters_;
+  parameters.voiceCount = 0;
+
+  const CelestialBody *dominant = GetDominantBody();
+  if (!dominant) {
+    sonifier_->Publish(parameters);
+    return;
+  }
+
+  const float halfWidth = GetDisplaySystem().GetWindow().getSize().x * 0.5f;
+  auto panOf = [&](const glm::vec2 &position) {
+    const float x = camera_.WorldToScreen(position).x;
+    return std::clamp((x - halfWidth) / halfWidth, -1.0f, 1.0f);
+  };
+
+  const float referenceOmega =
+      std::sqrt(GRAVITATIONAL_CONSTANT * dominant->mass /
+                (SONIFY_REFERENCE_RADIUS * SONIFY_REFERENCE_RADIUS *
+                 SONIFY_REFERENCE_RADIUS));
+  parameters.voices[parameters.voiceCount++] = {SONIFY_DRONE_PITCH, 0.5f,
+                                                panOf(dominant->position)};
+  for (const auto &body : GetBodies()) {
+    if (&body == dominant ||
+        parameters.voiceCount == Audio::SonifierParameters::MAX_VOICES)
+      continue;
+
+    const glm::vec2 offset = body.position - dominant->position;
+    const glm::vec2 relativeVelocity = body.velocity - dominant->velocity;
+    const float distanceSquared = glm::dot(offset, offset);
+    if (distanceSquared < 1.0f)
       continue;
 
-    glm::vec2 totalForce(0.0f, 0.0f);
+    const float omega =
+        std::abs(offset.x * relativeVelocity.y - offset.y * relativeVelocity.x) /
+        distanceSquared;
+    const float ratio = std::clamp(omega / referenceOmega, 0.25f, 8.0f);
+    const float amplitude =
+        std::clamp(std::sqrt(body.mass / dominant->mass), 0.1f, 1.0f);
+    parameters.voices[parameters.voiceCount++] = {
+        SONIFY_BASE_PITCH * ratio, amplitude, panOf(body.position)};
+  }
 
-    // Calculate force from massive objects only (optimization)
-    for (const auto &massiveObject : massiveObjects_) {
-      totalForce += CalculateGravitationalForce(
-          particles[i].position, massiveObject.position,
-          particles[i].mass, massiveObject.mass);
+  // Keep the sum of voices near full scale however many bodies there are
+  const float voiceGain = 1.0f / std::sqrt(static_cast<float>(parameters.voiceCount));
+  for (std::size_t v = 0; v < parameters.voiceCount; ++v) {
+    parameters.voices[v].amplitude *= voiceGain;
+  }
+
+  // Closest pair, in units of their summed radii, with hysteresis so one
+  // encounter fires one transient
+  float closest = std::numeric_limits<float>::max();
+  float encounterSpeed = 0.0f;
+  glm::vec2 encounterPosition(0.0f, 0.0f);
+  for (std::size_t i = 0; i < GetBodies().size(); ++i) {
+    for (std::size_t j = i + 1; j < GetBodies().size(); ++j) {
+      const auto &a = GetBodies()[i];
+      const auto &b = GetBodies()[j];
+      const float separation = glm::length(a.position - b.position) /
+                               std::max(a.radius + b.radius, 1.0f);
+      if (separation < closest) {
+        closest = separation;
+        encounterSpeed = glm::length(a.velocity - b.velocity);
+        encounterPosition = 0.5f * (a.position + b.position);
+      }
     }
+  }
+  if (!inEncounter_ && closest < ENCOUNTER_RADII) {
+    inEncounter_ = true;
+    ++parameters.transientSerial;
+    parameters.transientAmplitude =
+        std::clamp(encounterSpeed / ENCOUNTER_SPEED, 0.2f, 1.0f);
+    parameters.transientPan = panOf(encounterPosition);
+  } else if (inEncounter_ && closest > 1.5f * ENCOUNTER_RADII) {
+    inEncounter_ = false;
+  }
 
-    glm::vec2 acceleration = totalForce / particles[i].mass;
-    particles[i].velocity += acceleration * deltaTime;
-    particles[i].position += particles[i].velocity * deltaTime;
+  sonifier_->Publish(parameters);
+}
 
-    // Check if particle is too far from center (remove if so)
-    auto windowSize = GetDisplaySystem().GetWindow().getSize();
-    glm::vec2 center(windowSize.x * 0.5f, windowSize.y * 0.5f);
-    float distanceFromCenter =
-        glm::length(particles[i].position - center);
+void ParticleGalaxyMode::SetPrecision(Physics::Precision precision) {
+  physicsEngine_->SetPrecision(precision);
+}
 
-    if (distanceFromCenter > windowSize.x * 1.5f) {
-      particles[i].active = false;
-    }
+bool ParticleGalaxyMode::SetSolver(Physics::SolverType type) {
+  if (!physicsEngine_->SetSolver(type)) {
+    return false;
   }
+  if (type == Physics::SolverType::Direct) {
+    spdlog::info("Direct gravity on for up to {} stars",
+                 directSummation_->GetParticleLimit());
+  }
+  return true;
 }
 
-glm::vec2 ParticleGalaxyMode::CalculateGravitationalForce(const glm::vec2 &pos1,
-                                                          const glm::vec2 &pos2,
-                                                          float mass1,
-                                                          float mass2) const {
-  glm::vec2 direction = pos2 - pos1;
-  float distanceSq = glm::dot(direction, direction);
+void ParticleGalaxyMode::SetTemporalLOD(std::uint32_t interval) {
+  if (interval > 1) {
+    temporalInterval_ = interval;
+  }
+  physicsEngine_->SetTemporalLOD(interval);
+}
 
-  // Prevent division by zero and extreme forces
-  constexpr float MIN_DISTANCE_SQ = 10.0f;
-  distanceSq = std::max(distanceSq, MIN_DISTANCE_SQ);
+void ParticleGalaxyMode::UpdatePhysics(float deltaTime) {
+  auto windowSize = GetDisplaySystem().GetWindow().getSize();
+  glm::vec2 center(windowSize.x * 0.5f, windowSize.y * 0.5f);
+  if (physicsEngine_->GetTemporalLOD() > 1) {
+    // Distant stars cost a fraction of a step, so they are kept
+    physicsEngine_->SetBounds(center, std::numeric_limits<float>::max());
+    glm::vec2 visibleMin, visibleMax;
+    camera_.GetWorldBounds(visibleMin, visibleMax);
+    const glm::vec2 margin = (visibleMax - visibleMin) * TEMPORAL_LOD_MARGIN;
+    physicsEngine_->SetViewRegion(visibleMin - margin, visibleMax + margin);
+  } else {
+    physicsEngine_->SetBounds(center, windowSize.x * 1.5f);
+  }
+  physicsEngine_->SetBodyMassScale(audioGravityScale_);
+  physicsEngine_->Step(deltaTime);
 
-  float forceMagnitude = gravitationalConstant_ * mass1 * mass2 / distanceSq;
-  glm::vec2 forceDirection = glm::normalize(direction);
+  if (showTrails_) {
+    for (auto &body : GetBodies()) {
+      body.trail.push_back(body.position);
+      if (body.trail.size() > CelestialBody::MAX_TRAIL_LENGTH) {
+        body.trail.erase(body.trail.begin());
+      }
+    }
+  }
 
-  return forceDirection * forceMagnitude;
+  // Super-particles feel the massive objects like any other particle
+  particleLOD_->Integrate(deltaTime, [this](const glm::vec2 &position) {
+    return physicsEngine_->BodyAccelerationAt(position);
+  });
 }
 
 void ParticleGalaxyMode::Render(sf::RenderTarget &target) {
   auto &renderer = GetDisplaySystem().GetRenderer();
+  camera_.Update();
+  renderer.SetCamera(camera_);
+
+  // Distant stars first, with their own parallax views
+  if (showStarfield_) {
+    starfield_->Update(camera_.GetPosition(), camera_.GetSize(),
+                       camera_.GetZoom(), camera_.GetRotation());
+    starfield_->Render(target);
+  }
 
-  // Draw grid if enabled
+  // Draw grid if enabled, over the visible world rectangle
   if (showGrid_) {
-    auto windowSize = target.getSize();
+    glm::vec2 visibleMin, visibleMax;
+    camera_.GetWorldBounds(visibleMin, visibleMax);
     sf::Color gridColor(50, 50, 50, 100);
     float gridSpacing = 50.0f;
+    while ((visibleMax.x - visibleMin.x) / gridSpacing > 200.0f) {
+      gridSpacing *= 2.0f;
+    }
 
-    for (float x = 0; x < windowSize.x; x += gridSpacing) {
-      renderer.DrawLine(glm::vec2(x, 0), glm::vec2(x, windowSize.y), gridColor,
-                        0.5f);
+    for (float x = std::floor(visibleMin.x / gridSpacing) * gridSpacing;
+         x < visibleMax.x; x += gridSpacing) {
+      renderer.DrawLine(glm::vec2(x, visibleMin.y), glm::vec2(x, visibleMax.y),
+                        gridColor, 0.5f);
     }
-    for (float y = 0; y < windowSize.y; y += gridSpacing) {
-      renderer.DrawLine(glm::vec2(0, y), glm::vec2(windowSize.x, y), gridColor,
-                        0.5f);
+    for (float y = std::floor(visibleMin.y / gridSpacing) * gridSpacing;
+         y < visibleMax.y; y += gridSpacing) {
+      renderer.DrawLine(glm::vec2(visibleMin.x, y), glm::vec2(visibleMax.x, y),
+                        gridColor, 0.5f);
     }
   }
 
   // Draw trails for massive objects
   if (showTrails_) {
-    for (const auto &body : massiveObjects_) {
+    for (const auto &body : GetBodies()) {
       for (std::size_t i = 1; i < body.trail.size(); ++i) {
         float alpha = static_cast<float>(i) / body.trail.size();
         sf::Color trailColor = body.color;
@@ -595,10 +1090,29 @@ void ParticleGalaxyMode::Render(sf::RenderTarget &target) {
   }
 
   // Draw particles
-  particleSystem_->Render(target);
+  {
+    TRACE_SCOPE("ParticleSystem::Render");
+    particleSystem_->Render(target);
+  }
+  if (lodEnabled_) {
+    RenderSuperParticles(target);
+  }
+
+  // Outline detected clusters
+  std::shared_ptr<const Analysis::ClusterCatalog> clusters;
+  if (showClusters_) {
+    clusters = clusterFinder_->GetLatest();
+  }
+  if (clusters) {
+    for (const auto &cluster : clusters->clusters) {
+      renderer.DrawCircle(cluster.center,
+                          std::max(cluster.radius * 2.0f, 4.0f),
+                          sf::Color(120, 255, 160, 160), false);
+    }
+  }
 
   // Draw massive objects
-  for (const auto &body : massiveObjects_) {
+  for (const auto &body : GetBodies()) {
     renderer.DrawCircle(body.position, body.radius, body.color, true);
 
     // Draw glow effect
@@ -610,26 +1124,235 @@ void ParticleGalaxyMode::Render(sf::RenderTarget &target) {
     }
   }
 
-  // Draw UI info
-  sf::Font font;
-  if (font.loadFromFile("Assets/Fonts/arial.ttf")) {
-    sf::Text infoText;
-    infoText.setFont(font);
-    infoText.setCharacterSize(14);
-    infoText.setFillColor(sf::Color::White);
+  // Mark the inspected star
+  if (selectedStar_) {
+    const auto &particles = particleSystem_->GetParticles();
+    if (*selectedStar_ < particles.size() && particles[*selectedStar_].active) {
+      renderer.DrawCircle(particles[*selectedStar_].position,
+                          6.0f / camera_.GetZoom(), sf::Color(255, 220, 90),
+                          false);
+    }
+  }
+
+  // Label the most massive clusters
+  if (clusters && fontLoaded_) {
+    sf::Text label;
+    label.setFont(font_);
+    label.setCharacterSize(11);
+    label.setFillColor(sf::Color(120, 255, 160));
+
+    std::size_t labelCount =
+        std::min(clusters->clusters.size(), MAX_CLUSTER_LABELS);
+    for (std::size_t i = 0; i < labelCount; ++i) {
+      const auto &cluster = clusters->clusters[i];
+      label.setString("#" + std::to_string(cluster.id) + " (" +
+                      std::to_string(cluster.memberCount) + ")");
+      label.setPosition(cluster.center.x + cluster.radius * 2.0f + 2.0f,
+                        cluster.center.y);
+      target.draw(label);
+    }
+  }
+
+  // Overlays (and the cached-scene copy) are in screen pixels
+  renderer.ResetCamera();
+  if (showAnalysis_) {
+    RenderAnalysisOverlay(target);
+  }
+}
+
+void ParticleGalaxyMode::RenderHUD(sf::RenderTarget &target) {
+  if (!fontLoaded_)
+    return;
+
+  std::shared_ptr<const Analysis::ClusterCatalog> clusters;
+  if (showClusters_) {
+    clusters = clusterFinder_->GetLatest();
+  }
 
-    std::string info = "Particle Galaxy Mode\n";
-    info += "Particles: " +
-            std::to_string(particleSystem_->GetActiveParticleCount()) + "\n";
-    info += "Time Dilation: " + std::to_string(timeDilation_) + "x\n";
+  sf::Text infoText;
+  infoText.setFont(font_);
+  infoText.setCharacterSize(14);
+  infoText.setFillColor(sf::Color::White);
+
+  std::string info = "Particle Galaxy Mode\n";
+  info += "Particles: " +
+          std::to_string(particleSystem_->GetActiveParticleCount()) + "\n";
+  info += "Time Dilation: " + std::to_string(timeDilation_) + "x" +
+          (paused_ ? " (paused)\n" : "\n");
+  info += "Backend: " + executionBackend_->GetName() + ", " +
+          Physics::ToString(physicsEngine_->GetPrecision()) + " precision" +
+          ", " + particleSystem_->GetRenderBackend().GetName() +
+          " renderer" +
+          (physicsEngine_->IsFusedPipeline() ? ", fused\n" : "\n");
+  const auto solver = physicsEngine_->GetSolver();
+  const auto &timing = physicsEngine_->GetLastStepTiming();
+  info += "Physics: " + std::to_string(timing.GetTotalSeconds() * 1000.0) +
+          " ms (bodies " + std::to_string(timing.bodySeconds * 1000.0) +
+          ", solver " + std::to_string(timing.solverSeconds * 1000.0) +
+          ", stars " + std::to_string(timing.particleSeconds * 1000.0) +
+          ")\n";
+  if (solver == Physics::SolverType::Direct) {
+    const auto &stats = directSummation_->GetLastStats();
+    info += !physicsEngine_->IsSolverApplied()
+                ? "Direct gravity: off above " +
+                      std::to_string(directSummation_->GetParticleLimit()) +
+                      " stars\n"
+                : "Direct gravity: " + std::to_string(stats.bodies) +
+                      " stars, " + std::to_string(stats.seconds * 1000.0) +
+                      " ms, " + std::to_string(stats.gflops) + " GFLOP/s\n";
+  }
+  // Averages of every solver run this session, to compare them in place
+  info += "Solver: " + Physics::ToString(solver);
+  for (std::size_t i = 0; i < Physics::SOLVER_TYPE_COUNT; ++i) {
+    const auto type = static_cast<Physics::SolverType>(i);
+    const auto &average = physicsEngine_->GetSolverTiming(type);
+    if (average.steps > 0) {
+      info += ", " + Physics::ToString(type) + " " +
+              std::to_string(average.averageStepSeconds * 1000.0) + " ms";
+    }
+  }
+  info += "\n";
+  if (audioAnalyzer_ && audioAnalyzer_->IsRunning()) {
+    info += "Audio: bass " + std::to_string(audioFeatures_.GetBass()) +
+            ", gravity x" + std::to_string(audioGravityScale_) + "\n";
+  }
+  if (physicsEngine_->GetTemporalLOD() > 1) {
+    info += "Temporal LOD: " +
+            std::to_string(physicsEngine_->GetDeferredCount()) +
+            " stars deferred, off-view every " +
+            std::to_string(physicsEngine_->GetTemporalLOD()) + " steps\n";
+  }
+  if (lodEnabled_) {
+    info += "LOD: " + std::to_string(particleLOD_->GetMergedParticleCount()) +
+            " stars in " +
+            std::to_string(particleLOD_->GetSuperParticles().size()) +
+            " super-particles\n";
+  }
+  if (showClusters_) {
+    info += "Clusters: " +
+            (clusters ? std::to_string(clusters->clusters.size()) : "...") +
+            " (link " + std::to_string(clusterFinder_->GetLinkingLength()) +
+            ")\n";
+  }
+  if (catalogLoaded_) {
+    info += "Catalog: " + catalogPath_ + "\n";
+  } else {
     info += "Preset: " + std::to_string(currentPreset_ + 1) + "/" +
             std::to_string(NUM_PRESETS) + "\n";
-    info += "Controls: 1-5: Presets, Mouse: Add mass, Scroll: Time dilation\n";
-    info += "Space: Pause, T: Trails, G: Grid";
+  }
+  if (selectedStar_) {
+    info += "Selected " + DescribeStar(*selectedStar_) + "\n";
+  }
+  info += "Controls: 1-5: Presets, Left: Add mass / brush, Right: Inspect, "
+          "Scroll: Time dilation\n";
+  info += "Middle drag: Pan, Ctrl+Scroll: Zoom, Home: Reset view, Q: Brush (" +
+          std::string(brush_ == Brush::Attract ? "attract"
+                      : brush_ == Brush::Repel ? "repel"
+                      : brush_ == Brush::Swirl ? "swirl"
+                                               : "off") +
+          ")\n";
+  if (showAnalysis_) {
+    if (auto profile = profileAnalyzer_->GetLatest()) {
+      const auto &a = profile->globalFourierAmplitudes;
+      info += "Fourier A1-A4: " + std::to_string(a[0]) + " " +
+              std::to_string(a[1]) + " " + std::to_string(a[2]) + " " +
+              std::to_string(a[3]) + "\n";
+    }
+  }
+  info += "Space: Pause, T: Trails, G: Grid, F: Clusters, [/]: Link length\n";
+  info += "A: Profiles (cyan v_rot, orange sigma, yellow density), L: LOD, "
+          "B: Backend, D: Solver, V: Temporal LOD, P: Profile report\n";
+  info += "F5/F9: Save/Restore checkpoint (" + checkpointPath_ + ")";
+
+  infoText.setString(info);
+  infoText.setPosition(10, 10);
+  target.draw(infoText);
 
-    infoText.setString(info);
-    infoText.setPosition(10, 10);
-    target.draw(infoText);
+  auto &renderer = GetDisplaySystem().GetRenderer();
+  if (brush_ != Brush::Off) {
+    renderer.DrawCircle(cursor_, BRUSH_RADIUS,
+                        brushHeld_ ? sf::Color(255, 200, 120, 180)
+                                   : sf::Color(255, 255, 255, 60),
+                        false);
+  }
+
+  if (hoveredStar_ && !panning_) {
+    sf::Text tooltip;
+    tooltip.setFont(font_);
+    tooltip.setCharacterSize(12);
+    tooltip.setFillColor(sf::Color(255, 240, 180));
+    tooltip.setString(DescribeStar(*hoveredStar_));
+    tooltip.setPosition(cursor_.x + 14.0f, cursor_.y + 14.0f);
+    target.draw(tooltip);
+  }
+}
+
+void ParticleGalaxyMode::RenderSuperParticles(sf::RenderTarget &target) {
+  const auto &groups = particleLOD_->GetSuperParticles();
+  superParticleVertices_.resize(groups.size() * 4);
+
+  std::size_t vertexIndex = 0;
+  for (const auto &group : groups) {
+    // Sized by how many stars the group stands for
+    float halfSize = std::clamp(std::sqrt(float(group.memberCount)), 1.0f, 8.0f);
+    sf::Vector2f pos(group.position.x, group.position.y);
+
+    superParticleVertices_[vertexIndex++] =
+        sf::Vertex(pos + sf::Vector2f(-halfSize, -halfSize), group.color);
+    superParticleVertices_[vertexIndex++] =
+        sf::Vertex(pos + sf::Vector2f(halfSize, -halfSize), group.color);
+    superParticleVertices_[vertexIndex++] =
+        sf::Vertex(pos + sf::Vector2f(halfSize, halfSize), group.color);
+    superParticleVertices_[vertexIndex++] =
+        sf::Vertex(pos + sf::Vector2f(-halfSize, halfSize), group.color);
+  }
+
+  target.draw(superParticleVertices_, sf::RenderStates(sf::BlendAdd));
+}
+
+void ParticleGalaxyMode::RenderAnalysisOverlay(sf::RenderTarget &target) {
+  auto profile = profileAnalyzer_->GetLatest();
+  if (!profile || profile->bins.empty())
+    return;
+
+  auto &renderer = GetDisplaySystem().GetRenderer();
+  const glm::vec2 plotSize(320.0f, 160.0f);
+  const glm::vec2 origin(10.0f, target.getSize().y - plotSize.y - 10.0f);
+
+  renderer.DrawRectangle(origin, plotSize, sf::Color(0, 0, 0, 160), true);
+  renderer.DrawRectangle(origin, plotSize, sf::Color(80, 80, 80, 200), false);
+
+  float maxVelocity = 1.0f;
+  float maxDensity = 1e-6f;
+  for (const auto &bin : profile->bins) {
+    maxVelocity = std::max({maxVelocity, std::abs(bin.rotationVelocity),
+                            bin.tangentialDispersion, bin.radialDispersion});
+    maxDensity = std::max(maxDensity, bin.surfaceDensity);
+  }
+
+  const float maxRadius = profile->bins.back().outerRadius;
+  auto toPlot = [&](float radius, float fraction) {
+    return origin + glm::vec2(radius / maxRadius * plotSize.x,
+                              (1.0f - glm::clamp(fraction, 0.0f, 1.0f)) *
+                                  plotSize.y);
+  };
+
+  for (std::size_t b = 1; b < profile->bins.size(); ++b) {
+    const auto &prev = profile->bins[b - 1];
+    const auto &bin = profile->bins[b];
+    float r0 = (prev.innerRadius + prev.outerRadius) * 0.5f;
+    float r1 = (bin.innerRadius + bin.outerRadius) * 0.5f;
+
+    renderer.DrawLine(toPlot(r0, std::abs(prev.rotationVelocity) / maxVelocity),
+                      toPlot(r1, std::abs(bin.rotationVelocity) / maxVelocity),
+                      sf::Color(100, 220, 255));
+    renderer.DrawLine(
+        toPlot(r0, prev.tangentialDispersion / maxVelocity),
+        toPlot(r1, bin.tangentialDispersion / maxVelocity),
+        sf::Color(255, 160, 80));
+    renderer.DrawLine(toPlot(r0, prev.surfaceDensity / maxDensity),
+                      toPlot(r1, bin.surfaceDensity / maxDensity),
+                      sf::Color(255, 240, 120));
   }
 }
 
@@ -647,26 +1370,135 @@ void ParticleGalaxyMode::HandleInput(const Core::InputEvent &event) {
     } else if (event.key.code == sf::Keyboard::T) {
       showTrails_ = !showTrails_;
       if (!showTrails_) {
-        for (auto &body : massiveObjects_) {
+        for (auto &body : GetBodies()) {
           body.trail.clear();
         }
       }
     } else if (event.key.code == sf::Keyboard::G) {
       showGrid_ = !showGrid_;
+    } else if (event.key.code == sf::Keyboard::A) {
+      showAnalysis_ = !showAnalysis_;
+      analysisTimer_ = ANALYSIS_INTERVAL;
+    } else if (event.key.code == sf::Keyboard::F) {
+      showClusters_ = !showClusters_;
+      clusterTimer_ = CLUSTER_INTERVAL; // Search on the next update
+    } else if (event.key.code == sf::Keyboard::LBracket ||
+               event.key.code == sf::Keyboard::RBracket) {
+      float scale = event.key.code == sf::Keyboard::RBracket ? 1.25f : 0.8f;
+      clusterFinder_->SetLinkingLength(glm::clamp(
+          clusterFinder_->GetLinkingLength() * scale, 0.5f, 50.0f));
+      clusterTimer_ = CLUSTER_INTERVAL;
+    } else if (event.key.code == sf::Keyboard::B) {
+      // Cycle through the backends compiled into this build
+      auto backends = Core::GetAvailableExecutionBackends();
+      auto it = std::ranges::find(backends, executionBackend_->GetType());
+      auto next = (it == backends.end() || std::next(it) == backends.end())
+                      ? backends.front()
+                      : *std::next(it);
+      SetExecutionBackend(next);
+    } else if (event.key.code == sf::Keyboard::L) {
+      lodEnabled_ = !lodEnabled_;
+      if (!lodEnabled_) {
+        particleLOD_->SplitAll(particleSystem_->GetParticles());
+        particleSystem_->InvalidateVertices();
+      }
+      lodTimer_ = LOD_INTERVAL; // Refresh on the next update
+    } else if (event.key.code == sf::Keyboard::F5) {
+      SaveCheckpoint(checkpointPath_);
+    } else if (event.key.code == sf::Keyboard::F9) {
+      RestoreCheckpoint(checkpointPath_);
+    } else if (event.key.code == sf::Keyboard::Q) {
+      brush_ = static_cast<Brush>((static_cast<int>(brush_) + 1) % 4);
+      brushHeld_ = false;
+    } else if (event.key.code == sf::Keyboard::Home) {
+      ResetCamera();
+    } else if (event.key.code == sf::Keyboard::D) {
+      // Cycle through the registered solvers
+      auto type = physicsEngine_->GetSolver();
+      do {
+        type = static_cast<Physics::SolverType>(
+            (static_cast<std::size_t>(type) + 1) % Physics::SOLVER_TYPE_COUNT);
+      } while (!physicsEngine_->HasSolver(type));
+      SetSolver(type);
+    } else if (event.key.code == sf::Keyboard::V) {
+      SetTemporalLOD(physicsEngine_->GetTemporalLOD() > 1 ? 1
+                                                          : temporalInterval_);
+    } else if (event.key.code == sf::Keyboard::S) {
+      showStarfield_ = !showStarfield_;
+    } else if (event.key.code == sf::Keyboard::P) {
+      // Frame timings and thread pool scheduling metrics to the log
+      GetDisplaySystem().GetProfiler().GenerateReport();
     } else if (event.key.code == sf::Keyboard::R) {
-      CreateGalaxyPreset(currentPreset_);
+      if (catalogLoaded_) {
+        LoadCatalog(catalogPath_);
+      } else {
+        CreateGalaxyPreset(currentPreset_);
+      }
+    }
+
+    // Backend and linking length only show up in the HUD while paused
+    if (event.key.code == sf::Keyboard::B ||
+        event.key.code == sf::Keyboard::LBracket ||
+        event.key.code == sf::Keyboard::RBracket) {
+      MarkHUDDirty();
+    } else {
+      MarkSceneDirty();
     }
     break;
 
   case Core::InputEvent::Type::MouseButtonPressed:
+    cursor_ = event.mouseButton.position;
     if (event.mouseButton.button == sf::Mouse::Left) {
-      AddMassiveObject(event.mouseButton.position);
+      if (brush_ != Brush::Off) {
+        brushHeld_ = true;
+        MarkHUDDirty();
+      } else {
+        AddMassiveObject(camera_.ScreenToWorld(cursor_));
+        MarkSceneDirty();
+      }
+    } else if (event.mouseButton.button == sf::Mouse::Right) {
+      selectedStar_ = PickStar(cursor_);
+      MarkSceneDirty();
+    } else if (event.mouseButton.button == sf::Mouse::Middle) {
+      panning_ = true;
+    }
+    break;
+
+  case Core::InputEvent::Type::MouseButtonReleased:
+    if (event.mouseButton.button == sf::Mouse::Left) {
+      brushHeld_ = false;
+    } else if (event.mouseButton.button == sf::Mouse::Middle) {
+      panning_ = false;
     }
+    MarkHUDDirty();
+    break;
+
+  case Core::InputEvent::Type::MouseMoved:
+    if (panning_) {
+      camera_.Move(camera_.ScreenToWorld(cursor_) -
+                   camera_.ScreenToWorld(event.mouseMove.position));
+      cursor_ = event.mouseMove.position;
+      MarkSceneDirty();
+      break;
+    }
+    cursor_ = event.mouseMove.position;
+    hoveredStar_ = PickStar(cursor_, HOVER_HASH_MAX_AGE);
+    MarkHUDDirty();
     break;
 
   case Core::InputEvent::Type::MouseWheelScrolled:
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::LControl) ||
+        sf::Keyboard::isKeyPressed(sf::Keyboard::RControl)) {
+      // Keep the world point under the cursor in place
+      const glm::vec2 anchor = camera_.ScreenToWorld(event.mouseWheel.position);
+      camera_.Zoom(event.mouseWheel.delta > 0 ? 1.25f : 0.8f);
+      camera_.Move(anchor - camera_.ScreenToWorld(event.mouseWheel.position));
+      MarkSceneDirty();
+      break;
+    }
     timeDilation_ *= (event.mouseWheel.delta > 0) ? 1.1f : 0.9f;
     timeDilation_ = glm::clamp(timeDilation_, 0.1f, 10.0f);
+    MarkHUDDirty();
     break;
 
   default:
@@ -674,6 +1506,90 @@ void ParticleGalaxyMode::HandleInput(const Core::InputEvent &event) {
   }
 }
 
+void ParticleGalaxyMode::OnResize(unsigned int width, unsigned int height) {
+  camera_.SetSize(glm::vec2(width, height));
+}
+
+void ParticleGalaxyMode::ResetCamera() {
+  const auto windowSize = GetDisplaySystem().GetWindow().getSize();
+  const glm::vec2 size(windowSize.x, windowSize.y);
+  camera_.SetSize(size);
+  camera_.SetPosition(size * 0.5f);
+  camera_.SetRotation(0.0f);
+  camera_.SetZoom(1.0f);
+}
+
+void ParticleGalaxyMode::EnsureSpatialHash(std::uint64_t maxAge) {
+  if (spatialHashValid_ && stepCount_ - spatialHashStep_ <= maxAge)
+    return;
+
+  TRACE_SCOPE("SpatialHash build");
+  spatialHash_->Build(particleSystem_->GetParticles());
+  spatialHashValid_ = true;
+  spatialHashStep_ = stepCount_;
+}
+
+void ParticleGalaxyMode::InvalidateSpatialHash() {
+  // Pool slots now hold different stars
+  spatialHashValid_ = false;
+  hoveredStar_.reset();
+  selectedStar_.reset();
+}
+
+std::optional<std::uint32_t>
+ParticleGalaxyMode::PickStar(const glm::vec2 &screenPosition,
+                             std::uint64_t maxAge) {
+  EnsureSpatialHash(maxAge);
+  return spatialHash_->Nearest(camera_.ScreenToWorld(screenPosition),
+                               PICK_RADIUS / camera_.GetZoom());
+}
+
+std::string ParticleGalaxyMode::DescribeStar(std::uint32_t index) const {
+  const auto &particles = particleSystem_->GetParticles();
+  if (index >= particles.size() || !particles[index].active)
+    return "star #" + std::to_string(index) + " (merged)";
+
+  const auto &particle = particles[index];
+  glm::vec2 offset = particle.position;
+  glm::vec2 velocity = particle.velocity;
+  if (const CelestialBody *body = GetDominantBody()) {
+    offset -= body->position;
+    velocity -= body->velocity;
+  }
+  return "star #" + std::to_string(index) +
+         ": r " + std::to_string(static_cast<int>(glm::length(offset))) +
+         ", speed " + std::to_string(static_cast<int>(glm::length(velocity))) +
+         ", mass " + std::to_string(particle.mass);
+}
+
+void ParticleGalaxyMode::ApplyBrush(float deltaTime) {
+  EnsureSpatialHash();
+  const glm::vec2 center = camera_.ScreenToWorld(cursor_);
+  const float radius = BRUSH_RADIUS / camera_.GetZoom();
+  brushHits_.clear();
+  spatialHash_->QueryRadius(center, radius, brushHits_);
+
+  // Linear falloff from full strength at the centre to none at the rim
+  auto &particles = particleSystem_->GetParticles();
+  for (std::uint32_t index : brushHits_) {
+    auto &particle = particles[index];
+    const glm::vec2 offset = particle.position - center;
+    const float distance = glm::length(offset);
+    if (distance < 1e-3f)
+      continue;
+
+    const glm::vec2 direction = offset / distance;
+    glm::vec2 push = direction;
+    if (brush_ == Brush::Attract) {
+      push = -direction;
+    } else if (brush_ == Brush::Swirl) {
+      push = glm::vec2(-direction.y, direction.x);
+    }
+    particle.velocity +=
+        push * (BRUSH_STRENGTH * (1.0f - distance / radius) * deltaTime);
+  }
+}
+
 void ParticleGalaxyMode::AddMassiveObject(const glm::vec2 &position) {
   CelestialBody newBody;
   newBody.position = position;
@@ -684,10 +1600,16 @@ void ParticleGalaxyMode::AddMassiveObject(const glm::vec2 &position) {
                             std::uniform_int_distribution<int>(150, 255)(rng_),
                             std::uniform_int_distribution<int>(150, 255)(rng_));
 
-  massiveObjects_.push_back(newBody);
+  GetBodies().push_back(newBody);
   spdlog::info("Added massive object at ({}, {})", position.x, position.y);
 }
 
+bool ParticleGalaxyMode::IsIdle() const {
+  // Results still in flight would land while the display system sleeps
+  return paused_ && !clusterFinder_->IsBusy() && !profileAnalyzer_->IsBusy() &&
+         (!showStarfield_ || starfield_->GetPendingTileCount() == 0);
+}
+
 void ParticleGalaxyMode::OnActivate() {
   spdlog::info("Particle Galaxy Mode activated");
 }
@@ -0,0 +1,184 @@
+#include "Physics/DirectSummation.hpp"
+#include "Core/ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <spdlog/spdlog.h>
+
+namespace Physics {
+
+namespace {
+
+// Interactions of body i with every body of a j tile. The lane loop has a
+// fixed width so the compiler vectorizes it across j without reassociating
+// the sums; the partial sums are folded in lane order afterwards. Diagonal
+// tiles only take j > i so each pair is evaluated once.
+template <bool Diagonal, std::size_t TileSize, std::size_t Lanes>
+void InteractBody(std::size_t i, float xi, float yi, float massI,
+                  const float *xj, const float *yj, const float *massJ,
+                  float *forceXJ, float *forceYJ, float softeningSq,
+                  float &forceXI, float &forceYI) {
+  float sumX[Lanes] = {};
+  float sumY[Lanes] = {};
+  for (std::size_t j = 0; j < TileSize; j += Lanes) {
+    for (std::size_t lane = 0; lane < Lanes; ++lane) {
+      const std::size_t k = j + lane;
+      const float dx = xj[k] - xi;
+      const float dy = yj[k] - yi;
+      const float distanceSq = dx * dx + dy * dy + softeningSq;
+      const float inverse = 1.0f / std::sqrt(distanceSq);
+      float scale = inverse * inverse * inverse;
+      if constexpr (Diagonal) {
+        scale = k > i ? scale : 0.0f;
+      }
+
+      const float towardJ = massJ[k] * scale;
+      sumX[lane] += towardJ * dx;
+      sumY[lane] += towardJ * dy;
+      const float towardI = massI * scale;
+      forceXJ[k] -= towardI * dx;
+      forceYJ[k] -= towardI * dy;
+    }
+  }
+
+  for (std::size_t lane = 0; lane < Lanes; ++lane) {
+    forceXI += sumX[lane];
+    forceYI += sumY[lane];
+  }
+}
+
+} // namespace
+
+DirectSummation::DirectSummation(Core::ThreadPool &threadPool,
+                                 float softeningSq)
+    : threadPool_(threadPool), softeningSq_(std::max(softeningSq, 1e-6f)) {}
+
+void DirectSummation::InteractTiles(std::size_t tileI, std::size_t tileJ,
+                                    float *forceX, float *forceY) const {
+  const std::size_t baseI = tileI * TILE_SIZE;
+  const std::size_t baseJ = tileJ * TILE_SIZE;
+  const std::size_t endI = std::min(baseI + TILE_SIZE, bodyCount_);
+  const float *xj = &x_[baseJ];
+  const float *yj = &y_[baseJ];
+  const float *massJ = &mass_[baseJ];
+
+  for (std::size_t i = baseI; i < endI; ++i) {
+    if (tileI == tileJ) {
+      InteractBody<true, TILE_SIZE, SIMD_LANES>(
+          i - baseI, x_[i], y_[i], mass_[i], xj, yj, massJ, forceX + baseJ,
+          forceY + baseJ, softeningSq_, forceX[i], forceY[i]);
+    } else {
+      InteractBody<false, TILE_SIZE, SIMD_LANES>(
+          i - baseI, x_[i], y_[i], mass_[i], xj, yj, massJ, forceX + baseJ,
+          forceY + baseJ, softeningSq_, forceX[i], forceY[i]);
+    }
+  }
+}
+
+DirectSummationStats DirectSummation::ComputeAccelerations(
+    std::span<const Graphics::Particle> particles, float gravitationalConstant,
+    std::span<glm::vec2> accelerations) {
+  const auto start = std::chrono::steady_clock::now();
+
+  // Pack active bodies; padding is massless so it neither pulls nor is kept
+  indices_.clear();
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    if (particles[i].active) {
+      indices_.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+  bodyCount_ = indices_.size();
+  const std::size_t tileCount = (bodyCount_ + TILE_SIZE - 1) / TILE_SIZE;
+  const std::size_t padded = tileCount * TILE_SIZE;
+  x_.assign(padded, 0.0f);
+  y_.assign(padded, 0.0f);
+  mass_.assign(padded, 0.0f);
+  for (std::size_t body = 0; body < bodyCount_; ++body) {
+    const auto &particle = particles[indices_[body]];
+    x_[body] = particle.position.x;
+    y_[body] = particle.position.y;
+    mass_[body] = particle.mass;
+  }
+  laneForceX_.assign(WORK_LANES * padded, 0.0f);
+  laneForceY_.assign(WORK_LANES * padded, 0.0f);
+
+  // Upper-triangle tile pairs dealt round-robin to the work lanes; pairs of
+  // a lane run in order into that lane's buffers
+  const std::size_t pairCount = tileCount * (tileCount + 1) / 2;
+  threadPool_.ParallelFor(
+      std::min(WORK_LANES, pairCount), 1,
+      [&](std::size_t lane, std::size_t) {
+        float *forceX = &laneForceX_[lane * padded];
+        float *forceY = &laneForceY_[lane * padded];
+        std::size_t pair = 0;
+        for (std::size_t tileI = 0; tileI < tileCount; ++tileI) {
+          for (std::size_t tileJ = tileI; tileJ < tileCount; ++tileJ) {
+            if (pair++ % WORK_LANES == lane) {
+              InteractTiles(tileI, tileJ, forceX, forceY);
+            }
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  // Merge the lanes in order and scatter back to particle order
+  std::fill(accelerations.begin(), accelerations.end(), glm::vec2(0.0f));
+  threadPool_.ParallelFor(
+      bodyCount_, TILE_SIZE * 4, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t body = begin; body < end; ++body) {
+          glm::vec2 force(0.0f);
+          for (std::size_t lane = 0; lane < WORK_LANES; ++lane) {
+            force.x += laneForceX_[lane * padded + body];
+            force.y += laneForceY_[lane * padded + body];
+          }
+          accelerations[indices_[body]] = force * gravitationalConstant;
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  const double bodies = static_cast<double>(bodyCount_);
+  const double pairs = bodies * std::max(bodies - 1.0, 0.0) / 2.0;
+  lastStats_.bodies = bodyCount_;
+  lastStats_.seconds = seconds;
+  lastStats_.gflops =
+      seconds > 0.0 ? pairs * FLOPS_PER_PAIR / seconds * 1e-9 : 0.0;
+  return lastStats_;
+}
+
+void DirectSummation::Kick(std::span<Graphics::Particle> particles,
+                           float gravitationalConstant, float deltaTime) {
+  accelerations_.resize(particles.size());
+  ComputeAccelerations(particles, gravitationalConstant, accelerations_);
+  threadPool_.ParallelFor(
+      particles.size(), 16384, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+          if (particles[i].active) {
+            particles[i].velocity += accelerations_[i] * deltaTime;
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+}
+
+void DirectSummation::Kick(std::span<Graphics::Particle> particles,
+                           std::span<glm::dvec2> velocities,
+                           float gravitationalConstant, float deltaTime) {
+  accelerations_.resize(particles.size());
+  ComputeAccelerations(particles, gravitationalConstant, accelerations_);
+  threadPool_.ParallelFor(
+      particles.size(), 16384, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+          if (particles[i].active) {
+            velocities[i] += glm::dvec2(accelerations_[i]) *
+                             static_cast<double>(deltaTime);
+            particles[i].velocity = glm::vec2(velocities[i]);
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+}
+
+} // namespace Physics
@@ -0,0 +1,31 @@
+#include "Physics/ForceSolver.hpp"
+
+namespace Physics {
+
+std::string ToString(SolverType type) {
+  switch (type) {
+  case SolverType::MassiveBodies:
+    return "bodies";
+  case SolverType::Direct:
+    return "direct";
+  case SolverType::Tree:
+    return "tree";
+  case SolverType::Grid:
+    return "grid";
+  }
+  return "unknown";
+}
+
+std::optional<SolverType> ParseSolver(std::string_view name) {
+  if (name == "bodies")
+    return SolverType::MassiveBodies;
+  if (name == "direct")
+    return SolverType::Direct;
+  if (name == "tree")
+    return SolverType::Tree;
+  if (name == "grid")
+    return SolverType::Grid;
+  return std::nullopt;
+}
+
+} // namespace Physics
@@ -0,0 +1,237 @@
+#include "Physics/GravityKernels.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Physics {
+
+namespace {
+
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+std::uint64_t HashWord(std::uint64_t hash, std::uint32_t word) {
+  for (int byte = 0; byte < 4; ++byte) {
+    hash ^= (word >> (byte * 8)) & 0xFFu;
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+std::uint64_t HashFloat(std::uint64_t hash, float value) {
+  return HashWord(hash, std::bit_cast<std::uint32_t>(value));
+}
+
+// One tracer's kick-drift; false once it escaped far from the centre
+template <typename Scalar>
+bool AdvanceTracer(Vec2<Scalar> &position, Vec2<Scalar> &velocity, Scalar mass,
+                   std::span<const BasicGravitySource<Scalar>> sources,
+                   Scalar gravitationalConstant, Scalar deltaTime,
+                   const Vec2<Scalar> &center, Scalar maxDistance) {
+  // Summed in source order
+  Vec2<Scalar> totalForce(Scalar(0), Scalar(0));
+  for (const auto &source : sources) {
+    totalForce += GravitationalForce(position, source.position, mass,
+                                     source.mass, gravitationalConstant);
+  }
+
+  Vec2<Scalar> acceleration = totalForce / mass;
+  velocity += acceleration * deltaTime;
+  position += velocity * deltaTime;
+
+  return !(glm::length(position - center) > maxDistance);
+}
+
+// Reloads the double state of a particle changed outside the integrator
+void SyncTracer(const Graphics::Particle &particle, glm::dvec2 &position,
+                glm::dvec2 &velocity) {
+  if (glm::vec2(position) != particle.position ||
+      glm::vec2(velocity) != particle.velocity) {
+    position = glm::dvec2(particle.position);
+    velocity = glm::dvec2(particle.velocity);
+  }
+}
+
+} // namespace
+
+std::string ToString(Precision precision) {
+  switch (precision) {
+  case Precision::Fast:
+    return "fast";
+  case Precision::Mixed:
+    return "mixed";
+  case Precision::Accurate:
+    return "accurate";
+  }
+  return "unknown";
+}
+
+std::optional<Precision> ParsePrecision(std::string_view name) {
+  if (name == "fast")
+    return Precision::Fast;
+  if (name == "mixed")
+    return Precision::Mixed;
+  if (name == "accurate")
+    return Precision::Accurate;
+  return std::nullopt;
+}
+
+template <typename Scalar>
+Vec2<Scalar> GravitationalForce(const Vec2<Scalar> &pos1,
+                                const Vec2<Scalar> &pos2, Scalar mass1,
+                                Scalar mass2, Scalar gravitationalConstant) {
+  Vec2<Scalar> direction = pos2 - pos1;
+  Scalar distanceSq = glm::dot(direction, direction);
+
+  // Prevent division by zero and extreme forces
+  constexpr Scalar MIN_DISTANCE_SQ = 10;
+  distanceSq = std::max(distanceSq, MIN_DISTANCE_SQ);
+
+  Scalar forceMagnitude = gravitationalConstant * mass1 * mass2 / distanceSq;
+  Vec2<Scalar> forceDirection = glm::normalize(direction);
+
+  return forceDirection * forceMagnitude;
+}
+
+template <typename Scalar>
+void AdvanceBodies(std::span<BodyState<Scalar>> bodies,
+                   Scalar gravitationalConstant, Scalar deltaTime) {
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    Vec2<Scalar> totalForce(Scalar(0), Scalar(0));
+    for (std::size_t j = 0; j < bodies.size(); ++j) {
+      if (i == j)
+        continue;
+
+      totalForce +=
+          GravitationalForce(bodies[i].position, bodies[j].position,
+                             bodies[i].mass, bodies[j].mass,
+                             gravitationalConstant);
+    }
+
+    Vec2<Scalar> acceleration = totalForce / bodies[i].mass;
+    bodies[i].velocity += acceleration * deltaTime;
+    bodies[i].position += bodies[i].velocity * deltaTime;
+  }
+}
+
+template glm::vec2 GravitationalForce<float>(const glm::vec2 &,
+                                             const glm::vec2 &, float, float,
+                                             float);
+template glm::dvec2 GravitationalForce<double>(const glm::dvec2 &,
+                                               const glm::dvec2 &, double,
+                                               double, double);
+template void AdvanceBodies<float>(std::span<BodyState<float>>, float, float);
+template void AdvanceBodies<double>(std::span<BodyState<double>>, double,
+                                    double);
+
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<const GravitySource> sources,
+                      float gravitationalConstant, float deltaTime,
+                      const glm::vec2 &center, float maxDistance) {
+  for (auto &particle : particles) {
+    if (!particle.active)
+      continue;
+
+    particle.active = AdvanceTracer(particle.position, particle.velocity,
+                                    particle.mass, sources,
+                                    gravitationalConstant, deltaTime, center,
+                                    maxDistance);
+  }
+}
+
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<glm::dvec2> positions,
+                      std::span<glm::dvec2> velocities,
+                      std::span<const BasicGravitySource<double>> sources,
+                      double gravitationalConstant, double deltaTime,
+                      const glm::dvec2 &center, double maxDistance) {
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    auto &particle = particles[i];
+    if (!particle.active)
+      continue;
+
+    SyncTracer(particle, positions[i], velocities[i]);
+    particle.active = AdvanceTracer(
+        positions[i], velocities[i], static_cast<double>(particle.mass),
+        sources, gravitationalConstant, deltaTime, center, maxDistance);
+    particle.position = glm::vec2(positions[i]);
+    particle.velocity = glm::vec2(velocities[i]);
+  }
+}
+
+void SyncTracers(std::span<const Graphics::Particle> particles,
+                 std::span<glm::dvec2> positions,
+                 std::span<glm::dvec2> velocities) {
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    if (particles[i].active) {
+      SyncTracer(particles[i], positions[i], velocities[i]);
+    }
+  }
+}
+
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<const float> stepTimes,
+                      std::span<const GravitySource> sources,
+                      float gravitationalConstant, const glm::vec2 &center,
+                      float maxDistance) {
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    auto &particle = particles[i];
+    if (!particle.active || stepTimes[i] == 0.0f)
+      continue;
+
+    particle.active = AdvanceTracer(particle.position, particle.velocity,
+                                    particle.mass, sources,
+                                    gravitationalConstant, stepTimes[i],
+                                    center, maxDistance);
+  }
+}
+
+void AdvanceParticles(std::span<Graphics::Particle> particles,
+                      std::span<const float> stepTimes,
+                      std::span<glm::dvec2> positions,
+                      std::span<glm::dvec2> velocities,
+                      std::span<const BasicGravitySource<double>> sources,
+                      double gravitationalConstant, const glm::dvec2 &center,
+                      double maxDistance) {
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    auto &particle = particles[i];
+    if (!particle.active || stepTimes[i] == 0.0f)
+      continue;
+
+    SyncTracer(particle, positions[i], velocities[i]);
+    particle.active = AdvanceTracer(
+        positions[i], velocities[i], static_cast<double>(particle.mass),
+        sources, gravitationalConstant, static_cast<double>(stepTimes[i]),
+        center, maxDistance);
+    particle.position = glm::vec2(positions[i]);
+    particle.velocity = glm::vec2(velocities[i]);
+  }
+}
+
+std::uint64_t HashParticleState(std::span<const Graphics::Particle> particles) {
+  std::uint64_t hash = FNV_OFFSET;
+  for (const auto &particle : particles) {
+    if (!particle.active)
+      continue;
+
+    hash = HashFloat(hash, particle.position.x);
+    hash = HashFloat(hash, particle.position.y);
+    hash = HashFloat(hash, particle.velocity.x);
+    hash = HashFloat(hash, particle.velocity.y);
+  }
+  return hash;
+}
+
+std::uint64_t HashFloats(std::uint64_t seed, std::span<const float> values) {
+  for (float value : values) {
+    seed = HashFloat(seed, value);
+  }
+  return seed;
+}
+
+std::uint64_t CombineHashes(std::uint64_t seed, std::uint64_t value) {
+  seed = HashWord(seed, static_cast<std::uint32_t>(value));
+  return HashWord(seed, static_cast<std::uint32_t>(value >> 32));
+}
+
+} // namespace Physics
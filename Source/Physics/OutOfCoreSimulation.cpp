@@ -0,0 +1,659 @@
+#include "Physics/OutOfCoreSimulation.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Physics/GravityKernels.hpp"
+#include "Utils/FlightRecorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <numeric>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PHYSICS_HAS_MMAP 1
+#endif
+
+namespace Physics {
+
+static_assert(sizeof(StreamedParticle) == 20);
+static_assert(std::is_trivially_copyable_v<OutOfCoreHeader> &&
+              std::is_trivially_copyable_v<OutOfCoreBlock>);
+
+namespace {
+
+constexpr std::size_t PAGE_SIZE = 4096;
+constexpr std::size_t CHUNK_SIZE = 16384;
+// Mass deposit lanes per block: a fixed count, so the summed grid does not
+// depend on the worker count
+constexpr std::size_t DEPOSIT_LANES = 16;
+constexpr std::uint32_t TILE_BITS = 8; // 256 x 256 generation tiles
+constexpr std::size_t TILE_BATCH = 1024;
+
+std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+std::uint32_t SpreadBits(std::uint32_t value) {
+  value &= 0xFFFF;
+  value = (value | (value << 8)) & 0x00FF00FF;
+  value = (value | (value << 4)) & 0x0F0F0F0F;
+  value = (value | (value << 2)) & 0x33333333;
+  value = (value | (value << 1)) & 0x55555555;
+  return value;
+}
+
+std::uint32_t MortonCode(std::uint32_t x, std::uint32_t y) {
+  return SpreadBits(x) | (SpreadBits(y) << 1);
+}
+
+// Per-chunk moments, combined in chunk order so summaries don't depend on
+// the worker count
+struct BlockMoments {
+  double mass = 0.0;
+  glm::dvec2 weightedPosition{0.0, 0.0};
+  double weightedRadiusSq = 0.0;
+  glm::vec2 boundsMin{INFINITY, INFINITY};
+  glm::vec2 boundsMax{-INFINITY, -INFINITY};
+
+  void Add(const StreamedParticle &particle) {
+    const glm::dvec2 position(particle.position);
+    mass += particle.mass;
+    weightedPosition += position * static_cast<double>(particle.mass);
+    weightedRadiusSq += glm::dot(position, position) * particle.mass;
+    boundsMin = glm::min(boundsMin, particle.position);
+    boundsMax = glm::max(boundsMax, particle.position);
+  }
+
+  void Merge(const BlockMoments &other) {
+    mass += other.mass;
+    weightedPosition += other.weightedPosition;
+    weightedRadiusSq += other.weightedRadiusSq;
+    boundsMin = glm::min(boundsMin, other.boundsMin);
+    boundsMax = glm::max(boundsMax, other.boundsMax);
+  }
+};
+
+} // namespace
+
+OutOfCoreSimulation::OutOfCoreSimulation(Core::ThreadPool &threadPool,
+                                         const OutOfCoreSettings &settings)
+    : threadPool_(threadPool), settings_(settings) {
+  // Whole pages per block, so blocks can be advised and released alone
+  constexpr std::size_t granularity =
+      PAGE_SIZE / std::gcd(PAGE_SIZE, sizeof(StreamedParticle));
+  settings_.blockParticles =
+      AlignUp(std::max<std::size_t>(settings_.blockParticles, 1), granularity);
+  settings_.fieldResolution = std::max<std::size_t>(settings_.fieldResolution, 2);
+}
+
+OutOfCoreSimulation::~OutOfCoreSimulation() { Close(); }
+
+bool OutOfCoreSimulation::Map(const std::filesystem::path &path,
+                              std::uint64_t bytes, bool create) {
+#ifdef PHYSICS_HAS_MMAP
+  fd_ = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR,
+               0644);
+  if (fd_ < 0) {
+    spdlog::error("Failed to open out-of-core file '{}': {}", path.string(),
+                  std::strerror(errno));
+    return false;
+  }
+
+  if (create) {
+    if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+      spdlog::error("Failed to size '{}' to {} bytes: {}", path.string(),
+                    bytes, std::strerror(errno));
+      Close();
+      return false;
+    }
+  } else {
+    struct stat info {};
+    if (::fstat(fd_, &info) != 0 || info.st_size < 0) {
+      Close();
+      return false;
+    }
+    bytes = static_cast<std::uint64_t>(info.st_size);
+  }
+
+  void *mapping = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd_, 0);
+  if (mapping == MAP_FAILED) {
+    spdlog::error("Failed to map '{}': {}", path.string(), std::strerror(errno));
+    Close();
+    return false;
+  }
+
+  mapping_ = static_cast<char *>(mapping);
+  mappingSize_ = bytes;
+  stopReadAhead_ = false;
+  readAheadThread_ = std::thread(&OutOfCoreSimulation::ReadAheadThread, this);
+  return true;
+#else
+  spdlog::error("Out-of-core simulation needs memory-mapped files");
+  return false;
+#endif
+}
+
+void OutOfCoreSimulation::Close() {
+  if (readAheadThread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(readAheadMutex_);
+      stopReadAhead_ = true;
+      readAheadQueue_.clear();
+    }
+    readAheadChanged_.notify_all();
+    readAheadThread_.join();
+  }
+
+#ifdef PHYSICS_HAS_MMAP
+  if (mapping_) {
+    ::msync(mapping_, mappingSize_, MS_SYNC);
+    ::munmap(mapping_, mappingSize_);
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+#endif
+  fd_ = -1;
+  mapping_ = nullptr;
+  mappingSize_ = 0;
+  header_ = nullptr;
+  blocks_ = {};
+  massGridValid_ = false;
+}
+
+bool OutOfCoreSimulation::Create(const std::filesystem::path &path) {
+  Close();
+
+  const std::uint64_t particleCount = std::max<std::uint64_t>(settings_.particleCount, 1);
+  const auto blockCount = static_cast<std::uint32_t>(
+      (particleCount + settings_.blockParticles - 1) / settings_.blockParticles);
+  const std::uint64_t dataOffset = AlignUp(
+      sizeof(OutOfCoreHeader) + blockCount * sizeof(OutOfCoreBlock), PAGE_SIZE);
+  const std::uint64_t fileSize = AlignUp(
+      dataOffset + particleCount * sizeof(StreamedParticle), PAGE_SIZE);
+
+  if (!Map(path, fileSize, true))
+    return false;
+
+  header_ = new (mapping_) OutOfCoreHeader();
+  header_->blockCount = blockCount;
+  header_->particleCount = particleCount;
+  header_->centralMass = settings_.centralMass;
+  header_->gravitationalConstant = settings_.gravitationalConstant;
+  header_->dataOffset = dataOffset;
+
+  blocks_ = {reinterpret_cast<OutOfCoreBlock *>(mapping_ + sizeof(OutOfCoreHeader)),
+             blockCount};
+  for (std::uint32_t b = 0; b < blockCount; ++b) {
+    blocks_[b] = OutOfCoreBlock();
+    blocks_[b].firstParticle = std::uint64_t{b} * settings_.blockParticles;
+    blocks_[b].particleCount =
+        std::min<std::uint64_t>(settings_.blockParticles,
+                                particleCount - blocks_[b].firstParticle);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  GenerateDisk();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  spdlog::info("Created out-of-core file {}: {} particles in {} blocks "
+               "({:.1f} GB) in {:.1f} s",
+               path.string(), particleCount, blockCount, fileSize / 1e9,
+               elapsed.count());
+  return true;
+}
+
+bool OutOfCoreSimulation::Open(const std::filesystem::path &path) {
+  Close();
+  if (!Map(path, 0, false))
+    return false;
+
+  auto fail = [&](const char *reason) {
+    spdlog::error("Cannot resume '{}': {}", path.string(), reason);
+    Close();
+    return false;
+  };
+
+  if (mappingSize_ < sizeof(OutOfCoreHeader))
+    return fail("file is truncated");
+  header_ = reinterpret_cast<OutOfCoreHeader *>(mapping_);
+  if (header_->magic != OUT_OF_CORE_MAGIC)
+    return fail("not an out-of-core particle file");
+  if (header_->version != OUT_OF_CORE_VERSION)
+    return fail("unsupported version");
+
+  const std::uint64_t tableEnd =
+      sizeof(OutOfCoreHeader) + std::uint64_t{header_->blockCount} * sizeof(OutOfCoreBlock);
+  if (tableEnd > header_->dataOffset || header_->dataOffset % PAGE_SIZE != 0 ||
+      header_->dataOffset > mappingSize_ ||
+      header_->particleCount >
+          (mappingSize_ - header_->dataOffset) / sizeof(StreamedParticle))
+    return fail("file is truncated");
+
+  blocks_ = {reinterpret_cast<OutOfCoreBlock *>(mapping_ + sizeof(OutOfCoreHeader)),
+             header_->blockCount};
+  std::uint64_t expected = 0;
+  for (const auto &block : blocks_) {
+    if (block.firstParticle != expected ||
+        block.firstParticle * sizeof(StreamedParticle) % PAGE_SIZE != 0)
+      return fail("block table is corrupt");
+    expected += block.particleCount;
+  }
+  if (expected != header_->particleCount)
+    return fail("block table is corrupt");
+
+  // The file's physics wins over the command line
+  settings_.centralMass = header_->centralMass;
+  settings_.gravitationalConstant = header_->gravitationalConstant;
+
+  spdlog::info("Resuming out-of-core file {} at step {}: {} particles in {} "
+               "blocks",
+               path.string(), header_->step, header_->particleCount,
+               header_->blockCount);
+  return true;
+}
+
+std::span<StreamedParticle>
+OutOfCoreSimulation::GetBlockParticles(std::size_t block) const {
+  auto *particles =
+      reinterpret_cast<StreamedParticle *>(mapping_ + header_->dataOffset);
+  return {particles + blocks_[block].firstParticle,
+          static_cast<std::size_t>(blocks_[block].particleCount)};
+}
+
+void OutOfCoreSimulation::GenerateDisk() {
+  TRACE_SCOPE("Out-of-core generate");
+  constexpr std::uint32_t tilesPerAxis = 1u << TILE_BITS;
+  constexpr std::size_t tileCount = std::size_t{tilesPerAxis} * tilesPerAxis;
+
+  const float radius = settings_.diskRadius;
+  const float scaleLength = radius / 4.0f;
+  const float tileSize = 2.0f * radius / tilesPerAxis;
+  const std::uint64_t particleCount = header_->particleCount;
+
+  // Tiles in Morton order, each holding its share of an exponential disk
+  std::vector<std::uint32_t> tiles(tileCount);
+  std::iota(tiles.begin(), tiles.end(), 0u);
+  std::ranges::sort(tiles, {}, [](std::uint32_t tile) {
+    return MortonCode(tile % tilesPerAxis, tile / tilesPerAxis);
+  });
+
+  auto tileCenter = [&](std::uint32_t tile) {
+    return glm::vec2(-radius + (tile % tilesPerAxis + 0.5f) * tileSize,
+                     -radius + (tile / tilesPerAxis + 0.5f) * tileSize);
+  };
+
+  std::vector<double> weights(tileCount);
+  for (std::size_t i = 0; i < tileCount; ++i) {
+    const float r = glm::length(tileCenter(tiles[i]));
+    weights[i] = r < radius ? std::exp(-r / scaleLength) : 0.0;
+  }
+  const double totalWeight = std::accumulate(weights.begin(), weights.end(), 0.0);
+
+  // Floor the expected counts, then hand the remainder to the largest
+  // fractional parts
+  std::vector<std::uint64_t> counts(tileCount);
+  std::vector<std::pair<double, std::size_t>> remainders(tileCount);
+  std::uint64_t assigned = 0;
+  for (std::size_t i = 0; i < tileCount; ++i) {
+    const double expected = particleCount * weights[i] / totalWeight;
+    counts[i] = static_cast<std::uint64_t>(expected);
+    remainders[i] = {expected - counts[i], i};
+    assigned += counts[i];
+  }
+  std::ranges::sort(remainders, std::greater<>());
+  for (std::size_t i = 0; assigned < particleCount; ++i, ++assigned) {
+    ++counts[remainders[i % tileCount].second];
+  }
+
+  std::vector<std::uint64_t> starts(tileCount + 1, 0);
+  std::partial_sum(counts.begin(), counts.end(), starts.begin() + 1);
+
+  const float particleMass = settings_.diskMass / particleCount;
+  const float gravity = settings_.gravitationalConstant;
+  auto *particles =
+      reinterpret_cast<StreamedParticle *>(mapping_ + header_->dataOffset);
+
+  std::size_t summarized = 0;
+  for (std::size_t batch = 0; batch < tileCount; batch += TILE_BATCH) {
+    const std::size_t batchEnd = std::min(batch + TILE_BATCH, tileCount);
+    threadPool_.ParallelFor(
+        batchEnd - batch, 16, [&](std::size_t begin, std::size_t end) {
+          for (std::size_t i = batch + begin; i < batch + end; ++i) {
+            std::mt19937 rng(settings_.seed ^
+                             static_cast<std::uint32_t>(tiles[i] * 2654435761u));
+            std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+            const glm::vec2 center = tileCenter(tiles[i]);
+
+            for (std::uint64_t p = starts[i]; p < starts[i + 1]; ++p) {
+              StreamedParticle &particle = particles[p];
+              particle.position =
+                  center + glm::vec2(offset(rng), offset(rng)) * tileSize;
+              particle.mass = particleMass;
+
+              // Circular orbit around the enclosed mass
+              const float r = std::max(glm::length(particle.position), 1.0f);
+              const float x = r / scaleLength;
+              const float enclosed =
+                  settings_.centralMass +
+                  settings_.diskMass * (1.0f - (1.0f + x) * std::exp(-x));
+              const float speed = std::sqrt(gravity * enclosed / r);
+              particle.velocity =
+                  glm::vec2(-particle.position.y, particle.position.x) / r *
+                  speed;
+            }
+          }
+        });
+
+    // Summarize and drop every block the batch has completed
+    for (; summarized < blocks_.size() &&
+           blocks_[summarized].firstParticle + blocks_[summarized].particleCount <=
+               starts[batchEnd];
+         ++summarized) {
+      blocks_[summarized] = IntegrateBlock(summarized, false, nullptr);
+      ReleaseBlock(summarized);
+    }
+  }
+}
+
+OutOfCoreBlock OutOfCoreSimulation::IntegrateBlock(std::size_t block,
+                                                   bool advance,
+                                                   std::vector<double> *mass) {
+  std::span<StreamedParticle> particles = GetBlockParticles(block);
+  const std::size_t chunkCount = (particles.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  std::vector<BlockMoments> moments(chunkCount);
+
+  const float deltaTime = settings_.timeStep;
+  const float gravity = settings_.gravitationalConstant;
+  const float centralMass = settings_.centralMass;
+  const glm::vec2 origin(0.0f, 0.0f);
+
+  threadPool_.ParallelFor(
+      particles.size(), CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        BlockMoments &chunk = moments[begin / CHUNK_SIZE];
+        for (std::size_t i = begin; i < end; ++i) {
+          StreamedParticle &particle = particles[i];
+          if (advance) {
+            // The central mass exactly, everything else from the grid
+            const glm::vec2 acceleration =
+                GravitationalForce(particle.position, origin, 1.0f,
+                                   centralMass, gravity) +
+                FarFieldAt(particle.position);
+            particle.velocity += acceleration * deltaTime;
+            particle.position += particle.velocity * deltaTime;
+          }
+          chunk.Add(particle);
+        }
+      });
+
+  BlockMoments total;
+  for (const auto &chunk : moments) {
+    total.Merge(chunk);
+  }
+  if (mass) {
+    DepositMass(particles, *mass);
+  }
+
+  OutOfCoreBlock summary = blocks_[block];
+  summary.mass = static_cast<float>(total.mass);
+  if (total.mass > 0.0) {
+    const glm::dvec2 center = total.weightedPosition / total.mass;
+    summary.centerOfMass = glm::vec2(center);
+    summary.extent = static_cast<float>(std::sqrt(std::max(
+        0.0, total.weightedRadiusSq / total.mass - glm::dot(center, center))));
+    summary.boundsMin = total.boundsMin;
+    summary.boundsMax = total.boundsMax;
+  }
+  return summary;
+}
+
+void OutOfCoreSimulation::BuildLattice() {
+  glm::vec2 low(INFINITY, INFINITY);
+  glm::vec2 high(-INFINITY, -INFINITY);
+  for (const auto &block : blocks_) {
+    if (block.mass <= 0.0f)
+      continue;
+    low = glm::min(low, block.boundsMin);
+    high = glm::max(high, block.boundsMax);
+  }
+  if (low.x > high.x) {
+    low = high = glm::vec2(0.0f, 0.0f);
+  }
+
+  // A little margin so this step's drift stays on the grid
+  const glm::vec2 margin = (high - low) * 0.02f + glm::vec2(1.0f);
+  fieldMin_ = low - margin;
+  fieldMax_ = high + margin;
+  fieldCell_ = (fieldMax_ - fieldMin_) /
+               static_cast<float>(settings_.fieldResolution - 1);
+}
+
+void OutOfCoreSimulation::DepositMass(
+    std::span<const StreamedParticle> particles, std::vector<double> &mass) {
+  const std::size_t resolution = settings_.fieldResolution;
+  const std::size_t nodes = resolution * resolution;
+  laneMass_.assign(DEPOSIT_LANES * nodes, 0.0f);
+  const float limit = static_cast<float>(resolution - 1) - 1e-3f;
+
+  // Cloud-in-cell onto the lattice nodes; stragglers go to the edge
+  threadPool_.ParallelFor(DEPOSIT_LANES, 1, [&](std::size_t lane, std::size_t) {
+    float *grid = &laneMass_[lane * nodes];
+    const std::size_t begin = particles.size() * lane / DEPOSIT_LANES;
+    const std::size_t end = particles.size() * (lane + 1) / DEPOSIT_LANES;
+    for (std::size_t i = begin; i < end; ++i) {
+      const glm::vec2 cell =
+          glm::clamp((particles[i].position - fieldMin_) / fieldCell_,
+                     glm::vec2(0.0f), glm::vec2(limit));
+      const auto x = static_cast<std::size_t>(cell.x);
+      const auto y = static_cast<std::size_t>(cell.y);
+      const glm::vec2 t =
+          cell - glm::vec2(static_cast<float>(x), static_cast<float>(y));
+      const float m = particles[i].mass;
+      float *node = &grid[y * resolution + x];
+      node[0] += m * (1.0f - t.x) * (1.0f - t.y);
+      node[1] += m * t.x * (1.0f - t.y);
+      node[resolution] += m * (1.0f - t.x) * t.y;
+      node[resolution + 1] += m * t.x * t.y;
+    }
+  });
+
+  for (std::size_t lane = 0; lane < DEPOSIT_LANES; ++lane) {
+    const float *grid = &laneMass_[lane * nodes];
+    for (std::size_t n = 0; n < nodes; ++n) {
+      mass[n] += grid[n];
+    }
+  }
+}
+
+void OutOfCoreSimulation::BuildFarField() {
+  TRACE_SCOPE("Out-of-core far field");
+  // Occupied nodes of the last deposit become softened point masses
+  const std::size_t resolution = settings_.fieldResolution;
+  sources_.clear();
+  for (std::size_t y = 0; y < resolution; ++y) {
+    for (std::size_t x = 0; x < resolution; ++x) {
+      const double mass = massGrid_[y * resolution + x];
+      if (mass > 0.0) {
+        sources_.push_back(
+            {massMin_ + massCell_ * glm::vec2(static_cast<float>(x),
+                                              static_cast<float>(y)),
+             static_cast<float>(mass)});
+      }
+    }
+  }
+  sourceSofteningSq_ = glm::dot(massCell_, massCell_) + 1.0f;
+
+  field_.resize(resolution * resolution);
+  threadPool_.ParallelFor(resolution, 4, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t y = begin; y < end; ++y) {
+      for (std::size_t x = 0; x < resolution; ++x) {
+        const glm::vec2 position =
+            fieldMin_ + fieldCell_ * glm::vec2(static_cast<float>(x),
+                                               static_cast<float>(y));
+        field_[y * resolution + x] = DirectFarField(position);
+      }
+    }
+  });
+}
+
+glm::vec2 OutOfCoreSimulation::DirectFarField(const glm::vec2 &position) const {
+  // Each node's mass is spread over about a cell, which also stands in for
+  // the pairwise forces between stars closer than that
+  const float gravity = settings_.gravitationalConstant;
+  glm::vec2 acceleration(0.0f, 0.0f);
+  for (const auto &source : sources_) {
+    const glm::vec2 offset = source.position - position;
+    const float softenedSq = glm::dot(offset, offset) + sourceSofteningSq_;
+    acceleration += offset * (gravity * source.mass /
+                              (softenedSq * std::sqrt(softenedSq)));
+  }
+  return acceleration;
+}
+
+glm::vec2 OutOfCoreSimulation::FarFieldAt(const glm::vec2 &position) const {
+  const glm::vec2 cell = (position - fieldMin_) / fieldCell_;
+  const float limit = static_cast<float>(settings_.fieldResolution - 1);
+  if (!(cell.x >= 0.0f && cell.y >= 0.0f && cell.x < limit && cell.y < limit))
+    return DirectFarField(position); // Escapers off the grid
+
+  const auto x = static_cast<std::size_t>(cell.x);
+  const auto y = static_cast<std::size_t>(cell.y);
+  const glm::vec2 t = cell - glm::vec2(static_cast<float>(x), static_cast<float>(y));
+  const std::size_t row = settings_.fieldResolution;
+  const glm::vec2 *node = &field_[y * row + x];
+
+  return glm::mix(glm::mix(node[0], node[1], t.x),
+                  glm::mix(node[row], node[row + 1], t.x), t.y);
+}
+
+OutOfCoreStepStats OutOfCoreSimulation::Step() {
+  OutOfCoreStepStats stats;
+  if (!header_)
+    return stats;
+  TRACE_SCOPE("Out-of-core step");
+
+  auto start = std::chrono::steady_clock::now();
+  BuildLattice();
+  // After Create or Open nothing has been deposited yet: one read-only pass
+  if (!massGridValid_) {
+    StreamBlocks(false);
+  }
+  BuildFarField();
+
+  // Summaries stay fixed during the pass; the lattice was built from them
+  std::ranges::copy(StreamBlocks(true), blocks_.begin());
+
+  ++header_->step;
+  header_->time += settings_.timeStep;
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  stats.seconds = elapsed.count();
+  stats.particlesPerSecond =
+      stats.seconds > 0.0 ? header_->particleCount / stats.seconds : 0.0;
+  return stats;
+}
+
+std::vector<OutOfCoreBlock> OutOfCoreSimulation::StreamBlocks(bool advance) {
+  const std::size_t resolution = settings_.fieldResolution;
+  nextMassGrid_.assign(resolution * resolution, 0.0);
+
+  std::vector<OutOfCoreBlock> updated(blocks_.size());
+  const std::size_t readAhead = settings_.readAheadBlocks;
+  for (std::size_t b = 0; b < std::min(readAhead, blocks_.size()); ++b) {
+    RequestReadAhead(b);
+  }
+  for (std::size_t b = 0; b < blocks_.size(); ++b) {
+    streamPosition_ = b;
+    if (b + readAhead < blocks_.size()) {
+      RequestReadAhead(b + readAhead);
+    }
+    updated[b] = IntegrateBlock(b, advance, &nextMassGrid_);
+    ReleaseBlock(b);
+  }
+  streamPosition_ = 0;
+
+  massGrid_.swap(nextMassGrid_);
+  massMin_ = fieldMin_;
+  massCell_ = fieldCell_;
+  massGridValid_ = true;
+  return updated;
+}
+
+double OutOfCoreSimulation::Run(std::uint64_t steps) {
+  double totalSeconds = 0.0;
+  for (std::uint64_t i = 0; i < steps; ++i) {
+    auto stats = Step();
+    totalSeconds += stats.seconds;
+    spdlog::info("Out-of-core step {}: {:.2f} s, {:.1f} M particles/s",
+                 GetStep(), stats.seconds, stats.particlesPerSecond / 1e6);
+  }
+
+  const double mean =
+      totalSeconds > 0.0 ? GetParticleCount() * steps / totalSeconds : 0.0;
+  spdlog::info("Out-of-core run: {} steps of {} particles, {:.1f} M "
+               "particles/s",
+               steps, GetParticleCount(), mean / 1e6);
+  return mean;
+}
+
+void OutOfCoreSimulation::RequestReadAhead(std::size_t block) {
+  {
+    std::lock_guard<std::mutex> lock(readAheadMutex_);
+    readAheadQueue_.push_back(block);
+  }
+  readAheadChanged_.notify_one();
+}
+
+void OutOfCoreSimulation::ReadAheadThread() {
+  for (;;) {
+    std::size_t block;
+    {
+      std::unique_lock<std::mutex> lock(readAheadMutex_);
+      readAheadChanged_.wait(
+          lock, [this] { return stopReadAhead_ || !readAheadQueue_.empty(); });
+      if (stopReadAhead_)
+        return;
+      block = readAheadQueue_.front();
+      readAheadQueue_.pop_front();
+    }
+
+    // Fell behind: faulting a released block back in would only waste I/O
+    if (block < streamPosition_)
+      continue;
+
+#ifdef PHYSICS_HAS_MMAP
+    // Start the reads, then fault the pages in so the workers don't
+    std::span<StreamedParticle> particles = GetBlockParticles(block);
+    char *begin = reinterpret_cast<char *>(particles.data());
+    const std::size_t bytes = AlignUp(particles.size_bytes(), PAGE_SIZE);
+    ::madvise(begin, bytes, MADV_WILLNEED);
+    for (std::size_t offset = 0; offset < particles.size_bytes();
+         offset += PAGE_SIZE) {
+      static_cast<void>(*static_cast<volatile char *>(begin + offset));
+    }
+#endif
+  }
+}
+
+void OutOfCoreSimulation::ReleaseBlock(std::size_t block) {
+#ifdef PHYSICS_HAS_MMAP
+  // Queue write-back and unmap the pages; dirty data stays in the page
+  // cache, so resident memory is bounded by the read-ahead window
+  std::span<StreamedParticle> particles = GetBlockParticles(block);
+  char *begin = reinterpret_cast<char *>(particles.data());
+  const std::size_t bytes = AlignUp(particles.size_bytes(), PAGE_SIZE);
+  ::msync(begin, bytes, MS_ASYNC);
+  ::madvise(begin, bytes, MADV_DONTNEED);
+#endif
+}
+
+} // namespace Physics
@@ -0,0 +1,173 @@
+#include "Physics/ParticleLOD.hpp"
+#include "Core/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Physics {
+
+namespace {
+
+struct Candidate {
+  std::int64_t cell;
+  std::uint32_t index;
+};
+
+std::int64_t CellKey(const glm::vec2 &position, float inverseCellSize) {
+  auto cx = static_cast<std::int32_t>(std::floor(position.x * inverseCellSize));
+  auto cy = static_cast<std::int32_t>(std::floor(position.y * inverseCellSize));
+  return (static_cast<std::int64_t>(cx) << 32) |
+         static_cast<std::uint32_t>(cy);
+}
+
+} // namespace
+
+ParticleLOD::ParticleLOD(Core::ThreadPool &threadPool)
+    : threadPool_(threadPool) {}
+
+void ParticleLOD::Refresh(std::span<Graphics::Particle> particles,
+                          const InterestRegion &region) {
+  // Split groups that (partly) overlap the region of interest again
+  std::vector<SuperParticle> keptGroups;
+  std::vector<Member> keptMembers;
+  keptGroups.reserve(superParticles_.size());
+  keptMembers.reserve(members_.size());
+
+  for (const auto &group : superParticles_) {
+    if (region.Contains(group.position, group.extent * 2.0f)) {
+      Split(particles, group);
+      continue;
+    }
+
+    SuperParticle kept = group;
+    kept.firstMember = static_cast<std::uint32_t>(keptMembers.size());
+    keptMembers.insert(keptMembers.end(), members_.begin() + group.firstMember,
+                       members_.begin() + group.firstMember +
+                           group.memberCount);
+    keptGroups.push_back(kept);
+  }
+
+  superParticles_.swap(keptGroups);
+  members_.swap(keptMembers);
+
+  Merge(particles, region);
+}
+
+void ParticleLOD::SplitAll(std::span<Graphics::Particle> particles) {
+  for (const auto &group : superParticles_) {
+    Split(particles, group);
+  }
+  Reset();
+}
+
+void ParticleLOD::Reset() {
+  superParticles_.clear();
+  members_.clear();
+}
+
+void ParticleLOD::Split(std::span<Graphics::Particle> particles,
+                        const SuperParticle &group) {
+  for (std::uint32_t m = 0; m < group.memberCount; ++m) {
+    const Member &member = members_[group.firstMember + m];
+    if (member.particleIndex >= particles.size())
+      continue;
+
+    auto &particle = particles[member.particleIndex];
+    particle.position = group.position + member.positionOffset;
+    particle.velocity = group.velocity + member.velocityOffset;
+    particle.active = true;
+  }
+}
+
+void ParticleLOD::Merge(std::span<Graphics::Particle> particles,
+                        const InterestRegion &region) {
+  const float inverseCellSize = 1.0f / settings_.cellSize;
+  const std::size_t chunkCount = (particles.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  std::vector<std::vector<Candidate>> chunkCandidates(chunkCount);
+
+  // Collect low-interest particles; each chunk keeps index order
+  threadPool_.ParallelFor(
+      particles.size(), CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        auto &candidates = chunkCandidates[begin / CHUNK_SIZE];
+        for (std::size_t i = begin; i < end; ++i) {
+          const auto &particle = particles[i];
+          if (particle.active && !region.Contains(particle.position)) {
+            candidates.push_back({CellKey(particle.position, inverseCellSize),
+                                  static_cast<std::uint32_t>(i)});
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  std::vector<Candidate> candidates;
+  for (auto &chunk : chunkCandidates) {
+    candidates.insert(candidates.end(), chunk.begin(), chunk.end());
+  }
+
+  // Stable sort keeps members in index order, so grouping is deterministic
+  std::ranges::stable_sort(candidates, {}, &Candidate::cell);
+
+  for (std::size_t runStart = 0; runStart < candidates.size();) {
+    std::size_t runEnd = runStart + 1;
+    while (runEnd < candidates.size() &&
+           candidates[runEnd].cell == candidates[runStart].cell) {
+      ++runEnd;
+    }
+
+    const std::size_t runSize = runEnd - runStart;
+    if (runSize < settings_.minGroupSize) {
+      runStart = runEnd;
+      continue;
+    }
+
+    double mass = 0.0;
+    glm::dvec2 weightedPosition(0.0);
+    glm::dvec2 momentum(0.0);
+    double r = 0.0, g = 0.0, b = 0.0, a = 0.0;
+    for (std::size_t c = runStart; c < runEnd; ++c) {
+      const auto &particle = particles[candidates[c].index];
+      mass += particle.mass;
+      weightedPosition += glm::dvec2(particle.position) * double(particle.mass);
+      momentum += glm::dvec2(particle.velocity) * double(particle.mass);
+      r += particle.color.r;
+      g += particle.color.g;
+      b += particle.color.b;
+      a += particle.color.a;
+    }
+
+    SuperParticle group;
+    group.mass = static_cast<float>(mass);
+    group.position = glm::vec2(weightedPosition / mass);
+    group.velocity = glm::vec2(momentum / mass);
+    group.firstMember = static_cast<std::uint32_t>(members_.size());
+    group.memberCount = static_cast<std::uint32_t>(runSize);
+    group.color = sf::Color(static_cast<sf::Uint8>(r / runSize),
+                            static_cast<sf::Uint8>(g / runSize),
+                            static_cast<sf::Uint8>(b / runSize),
+                            static_cast<sf::Uint8>(a / runSize));
+
+    double xx = 0.0, yy = 0.0, xy = 0.0;
+    for (std::size_t c = runStart; c < runEnd; ++c) {
+      auto &particle = particles[candidates[c].index];
+      Member member{candidates[c].index, particle.position - group.position,
+                    particle.velocity - group.velocity};
+      members_.push_back(member);
+
+      double w = particle.mass;
+      xx += w * member.positionOffset.x * member.positionOffset.x;
+      yy += w * member.positionOffset.y * member.positionOffset.y;
+      xy += w * member.positionOffset.x * member.positionOffset.y;
+
+      particle.active = false;
+    }
+
+    group.momentXXYY = glm::vec2(static_cast<float>(xx / mass),
+                                 static_cast<float>(yy / mass));
+    group.momentXY = static_cast<float>(xy / mass);
+    group.extent = std::sqrt(group.momentXXYY.x + group.momentXXYY.y);
+    superParticles_.push_back(group);
+
+    runStart = runEnd;
+  }
+}
+
+} // namespace Physics
@@ -1,7 +1,387 @@
 #include "Physics/PhysicsEngine.hpp"
+#include "Core/ExecutionBackend.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Utils/FlightRecorder.hpp"
+#include <algorithm>
+#include <chrono>
+#include <spdlog/spdlog.h>
 
 namespace Physics {
 
-// PhysicsEngine implementation will go here
+namespace {
 
-} // namespace Physics
\ No newline at end of file
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Brings body states in line with the float bodies, keeping the state of
+// every body whose rounded value still matches (the integrator's own
+// result) and reloading any that were added or changed elsewhere
+template <typename Scalar>
+void SyncBodyStates(std::vector<BodyState<Scalar>> &states,
+                    const std::vector<CelestialBody> &bodies) {
+  states.resize(bodies.size());
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    auto &state = states[i];
+    const auto &body = bodies[i];
+    if (glm::vec2(state.position) != body.position ||
+        glm::vec2(state.velocity) != body.velocity ||
+        static_cast<float>(state.mass) != body.mass) {
+      state = {Vec2<Scalar>(body.position), Vec2<Scalar>(body.velocity),
+               static_cast<Scalar>(body.mass)};
+    }
+  }
+}
+
+template <typename Scalar>
+void AdvanceBodyStates(std::vector<BodyState<Scalar>> &states,
+                       std::vector<CelestialBody> &bodies,
+                       float gravitationalConstant, float deltaTime) {
+  SyncBodyStates(states, bodies);
+  AdvanceBodies<Scalar>(states, static_cast<Scalar>(gravitationalConstant),
+                        static_cast<Scalar>(deltaTime));
+  for (std::size_t i = 0; i < bodies.size(); ++i) {
+    bodies[i].position = glm::vec2(states[i].position);
+    bodies[i].velocity = glm::vec2(states[i].velocity);
+  }
+}
+
+} // namespace
+
+PhysicsEngine::PhysicsEngine(Core::ThreadPool &threadPool,
+                             std::size_t maxParticles)
+    : threadPool_(threadPool),
+      particleSystem_(
+          std::make_unique<Graphics::ParticleSystem>(maxParticles)) {}
+
+PhysicsEngine::~PhysicsEngine() = default;
+
+void PhysicsEngine::SetExecutionBackend(Core::ExecutionBackend *backend) {
+  executionBackend_ = backend;
+  particleSystem_->SetExecutionBackend(backend);
+}
+
+void PhysicsEngine::SetPrecision(Precision precision) {
+  precision_ = precision;
+  // Reloaded from the float state on the next step
+  preciseBodies_.clear();
+  precisePositions_.clear();
+  preciseVelocities_.clear();
+  spdlog::info("Simulation precision: {}", ToString(precision));
+}
+
+void PhysicsEngine::SetTemporalLOD(std::uint32_t interval) {
+  interval = std::max<std::uint32_t>(interval, 1);
+  if (interval == temporalInterval_) {
+    return;
+  }
+  if (temporalInterval_ > 1 && interval == 1) {
+    CatchUp();
+  }
+  temporalInterval_ = interval;
+  if (interval > 1) {
+    spdlog::info("Temporal LOD: stars out of view step every {} steps",
+                 interval);
+  } else {
+    spdlog::info("Temporal LOD off");
+  }
+}
+
+void PhysicsEngine::CatchUp() {
+  if (pendingTimes_.empty()) {
+    return;
+  }
+  if (precision_ == Precision::Accurate) {
+    // Sources for the double kernel, which a precision change cleared
+    SyncBodyStates(preciseBodies_, bodies_);
+  }
+  ScheduleParticles(0.0f, true);
+  AdvanceStars(0.0f, true);
+  pendingTimes_.clear();
+}
+
+void PhysicsEngine::DiscardDeferredTime() {
+  pendingTimes_.clear();
+  deferredCount_ = 0;
+}
+
+void PhysicsEngine::RegisterSolver(std::unique_ptr<ForceSolver> solver) {
+  const auto type = solver->GetType();
+  solvers_[static_cast<std::size_t>(type)] = std::move(solver);
+}
+
+bool PhysicsEngine::HasSolver(SolverType type) const {
+  return type == SolverType::MassiveBodies ||
+         solvers_[static_cast<std::size_t>(type)] != nullptr;
+}
+
+bool PhysicsEngine::SetSolver(SolverType type) {
+  if (!HasSolver(type)) {
+    spdlog::warn("No {} solver is registered; keeping {}", ToString(type),
+                 ToString(solver_));
+    return false;
+  }
+
+  const auto &previous = GetSolverTiming(solver_);
+  if (previous.steps > 0) {
+    spdlog::info("Solver {}: {:.2f} ms per step ({:.2f} ms in the solver) "
+                 "over {} steps",
+                 ToString(solver_), previous.averageStepSeconds * 1000.0,
+                 previous.averageSolverSeconds * 1000.0, previous.steps);
+  }
+  solver_ = type;
+  spdlog::info("Physics solver: {}", ToString(type));
+  return true;
+}
+
+glm::vec2 PhysicsEngine::BodyAccelerationAt(const glm::vec2 &position) const {
+  glm::vec2 acceleration(0.0f, 0.0f);
+  for (const auto &body : bodies_) {
+    acceleration += GravitationalForce(position, body.position, 1.0f,
+                                       body.mass, gravitationalConstant_);
+  }
+  return acceleration;
+}
+
+template <typename F>
+void PhysicsEngine::ForEachChunk(std::size_t count, F &&func) {
+  // Fixed-size chunks, so the work split does not depend on the worker count
+  if (executionBackend_) {
+    executionBackend_->ForEachChunk(count, PHYSICS_CHUNK_SIZE, func);
+  } else {
+    threadPool_.ParallelFor(count, PHYSICS_CHUNK_SIZE, func,
+                            Core::TaskPriority::Critical);
+  }
+}
+
+void PhysicsEngine::Step(float deltaTime) {
+  auto start = Clock::now();
+  StepBodies(deltaTime);
+  lastTiming_.bodySeconds = SecondsSince(start);
+
+  // Star-star forces, kicked from the same positions the bodies see
+  start = Clock::now();
+  ForceSolver *solver = solvers_[static_cast<std::size_t>(solver_)].get();
+  solverApplied_ =
+      solver && (solver->GetParticleLimit() == 0 ||
+                 particleSystem_->GetActiveParticleCount() <=
+                     solver->GetParticleLimit());
+  if (solverApplied_) {
+    TRACE_SCOPE("Force solver");
+    auto &particles = particleSystem_->GetParticles();
+    if (precision_ == Precision::Accurate) {
+      // Kicking only the float velocities would make the kernel reload the
+      // double state from them
+      SyncPreciseParticles();
+      solver->Kick(particles, preciseVelocities_, gravitationalConstant_,
+                   deltaTime);
+    } else {
+      solver->Kick(particles, gravitationalConstant_, deltaTime);
+    }
+  }
+  lastTiming_.solverSeconds = SecondsSince(start);
+
+  start = Clock::now();
+  StepParticles(deltaTime);
+  lastTiming_.particleSeconds = SecondsSince(start);
+
+  auto &timing = solverTimings_[static_cast<std::size_t>(solver_)];
+  const double weight = timing.steps == 0 ? 1.0 : TIMING_SMOOTHING;
+  timing.averageStepSeconds +=
+      (lastTiming_.GetTotalSeconds() - timing.averageStepSeconds) * weight;
+  timing.averageSolverSeconds +=
+      (lastTiming_.solverSeconds - timing.averageSolverSeconds) * weight;
+  ++timing.steps;
+}
+
+void PhysicsEngine::SyncPreciseParticles() {
+  std::span<const Graphics::Particle> particles(
+      particleSystem_->GetParticles());
+  precisePositions_.resize(particles.size());
+  preciseVelocities_.resize(particles.size());
+  std::span<glm::dvec2> positions(precisePositions_);
+  std::span<glm::dvec2> velocities(preciseVelocities_);
+  ForEachChunk(particles.size(), [&](std::size_t begin, std::size_t end) {
+    const std::size_t count = end - begin;
+    SyncTracers(particles.subspan(begin, count),
+                positions.subspan(begin, count),
+                velocities.subspan(begin, count));
+  });
+}
+
+void PhysicsEngine::StepBodies(float deltaTime) {
+  // Massive objects affect each other
+  if (precision_ == Precision::Fast) {
+    AdvanceBodyStates(bodyStates_, bodies_, gravitationalConstant_,
+                      deltaTime);
+  } else {
+    AdvanceBodyStates(preciseBodies_, bodies_, gravitationalConstant_,
+                      deltaTime);
+  }
+}
+
+void PhysicsEngine::StepParticles(float deltaTime) {
+  const bool deferred = temporalInterval_ > 1;
+  if (deferred) {
+    ScheduleParticles(deltaTime, false);
+  } else {
+    deferredCount_ = 0;
+  }
+  AdvanceStars(deltaTime, deferred);
+}
+
+void PhysicsEngine::ScheduleParticles(float deltaTime, bool catchUp) {
+  std::span<const Graphics::Particle> particles(
+      particleSystem_->GetParticles());
+  // New slots owe no time
+  pendingTimes_.resize(particles.size());
+  stepTimes_.resize(particles.size());
+  chunkDeferred_.assign(
+      (particles.size() + PHYSICS_CHUNK_SIZE - 1) / PHYSICS_CHUNK_SIZE, 0);
+
+  // Group g of the stars out of view is due on steps where the phase is g
+  const std::uint64_t phase = temporalPhase_++ % temporalInterval_;
+  const glm::vec2 viewMin = viewMin_;
+  const glm::vec2 viewMax = viewMax_;
+  ForEachChunk(particles.size(), [&](std::size_t begin, std::size_t end) {
+    std::size_t deferred = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      const auto &particle = particles[i];
+      if (!particle.active) {
+        pendingTimes_[i] = 0.0f;
+        stepTimes_[i] = 0.0f;
+        continue;
+      }
+
+      const float owed = pendingTimes_[i] + deltaTime;
+      const bool visible = particle.position.x >= viewMin.x &&
+                           particle.position.x <= viewMax.x &&
+                           particle.position.y >= viewMin.y &&
+                           particle.position.y <= viewMax.y;
+      const bool due = catchUp || visible || i % temporalInterval_ == phase;
+      stepTimes_[i] = due ? owed : 0.0f;
+      pendingTimes_[i] = due ? 0.0f : owed;
+      deferred += due ? 0 : 1;
+    }
+    chunkDeferred_[begin / PHYSICS_CHUNK_SIZE] = deferred;
+  });
+
+  deferredCount_ = 0;
+  for (std::size_t count : chunkDeferred_) {
+    deferredCount_ += count;
+  }
+}
+
+void PhysicsEngine::AdvanceStars(float deltaTime, bool perParticle) {
+  std::span<Graphics::Particle> particles(particleSystem_->GetParticles());
+  std::span<const float> stepTimes(stepTimes_);
+  const glm::vec2 center = boundsCenter_;
+  const float maxDistance = maxDistance_;
+  auto &system = *particleSystem_;
+
+  // The particle system's own ageing, damping and drift. Accurate runs
+  // apply it to the double state too, or the kernel would reload that
+  // from the drifted floats on the next step.
+  const bool accurate = precision_ == Precision::Accurate;
+  if (accurate) {
+    // New slots hold zeros and are reloaded by the kernel on first use
+    precisePositions_.resize(particles.size());
+    preciseVelocities_.resize(particles.size());
+  }
+  std::span<glm::dvec2> positions(precisePositions_);
+  std::span<glm::dvec2> velocities(preciseVelocities_);
+  auto updateRange = [&](std::size_t begin, std::size_t end) {
+    if (accurate && perParticle) {
+      system.UpdateRange(begin, end, stepTimes, positions, velocities);
+    } else if (accurate) {
+      system.UpdateRange(begin, end, deltaTime, positions, velocities);
+    } else if (perParticle) {
+      system.UpdateRange(begin, end, stepTimes);
+    } else {
+      system.UpdateRange(begin, end, deltaTime);
+    }
+  };
+
+  // That update, then the chunk's quads, while its particles are still in
+  // cache. Other render backends build their own vertices, so they get
+  // separate passes.
+  const bool fused = fusedPipeline_ && system.CanFuseVertices();
+  auto finishChunk = [&](std::size_t begin, std::size_t end) {
+    if (!fused) {
+      return;
+    }
+    updateRange(begin, end);
+    system.WriteVertices(begin, end);
+  };
+  if (fused) {
+    system.BeginFusedFrame(PHYSICS_CHUNK_SIZE);
+  }
+
+  if (accurate) {
+    std::vector<BasicGravitySource<double>> sources;
+    sources.reserve(preciseBodies_.size());
+    for (const auto &body : preciseBodies_) {
+      sources.push_back({body.position, body.mass * bodyMassScale_});
+    }
+
+    ForEachChunk(particles.size(), [&](std::size_t begin, std::size_t end) {
+      const std::size_t count = end - begin;
+      if (perParticle) {
+        AdvanceParticles(particles.subspan(begin, count),
+                         stepTimes.subspan(begin, count),
+                         positions.subspan(begin, count),
+                         velocities.subspan(begin, count), sources,
+                         gravitationalConstant_, glm::dvec2(center),
+                         maxDistance);
+      } else {
+        AdvanceParticles(particles.subspan(begin, count),
+                         positions.subspan(begin, count),
+                         velocities.subspan(begin, count), sources,
+                         gravitationalConstant_, deltaTime,
+                         glm::dvec2(center), maxDistance);
+      }
+      finishChunk(begin, end);
+    });
+  } else {
+    // Mixed runs hand the tracers their sources rounded to float
+    std::vector<GravitySource> sources;
+    sources.reserve(bodies_.size());
+    for (const auto &body : bodies_) {
+      sources.push_back({body.position, body.mass * bodyMassScale_});
+    }
+
+    ForEachChunk(particles.size(), [&](std::size_t begin, std::size_t end) {
+      const std::size_t count = end - begin;
+      if (perParticle) {
+        AdvanceParticles(particles.subspan(begin, count),
+                         stepTimes.subspan(begin, count), sources,
+                         gravitationalConstant_, center, maxDistance);
+      } else {
+        AdvanceParticles(particles.subspan(begin, count), sources,
+                         gravitationalConstant_, deltaTime, center,
+                         maxDistance);
+      }
+      finishChunk(begin, end);
+    });
+  }
+
+  if (fused) {
+    system.EndFusedFrame();
+    return;
+  }
+
+  // Separate passes: serial particle system update, vertices built in Render
+  TRACE_SCOPE("ParticleSystem::Update");
+  if (accurate) {
+    system.InvalidateVertices();
+    updateRange(0, particles.size());
+  } else if (perParticle) {
+    system.Update(stepTimes);
+  } else {
+    system.Update(deltaTime);
+  }
+}
+
+} // namespace Physics
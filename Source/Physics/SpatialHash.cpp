@@ -0,0 +1,234 @@
+#include "Physics/SpatialHash.hpp"
+#include "Core/ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+
+namespace Physics {
+
+namespace {
+
+// Roughly eight particles per bucket, within sane table sizes
+std::size_t BucketCountFor(std::size_t particleCount) {
+  return std::clamp<std::size_t>(std::bit_ceil(particleCount / 8 + 1), 1024,
+                                 std::size_t{1} << 20);
+}
+
+} // namespace
+
+SpatialHash::SpatialHash(Core::ThreadPool &threadPool, float cellSize)
+    : threadPool_(threadPool) {
+  SetCellSize(cellSize);
+}
+
+void SpatialHash::SetCellSize(float cellSize) {
+  cellSize_ = std::max(cellSize, 1e-3f);
+  inverseCellSize_ = 1.0f / cellSize_;
+  // Every particle's cell changes meaning; force a full rebuild
+  particleBucket_.clear();
+}
+
+void SpatialHash::Build(std::span<const Graphics::Particle> particles) {
+  const std::size_t count = particles.size();
+  const std::size_t bucketCount = BucketCountFor(count);
+  // Large tables get fewer, larger chunks so the histograms stay bounded
+  const std::size_t maxChunks =
+      std::max<std::size_t>(MAX_HISTOGRAM_COUNTERS / bucketCount, 1);
+  const std::size_t chunkSize =
+      std::max(CHUNK_SIZE, (count + maxChunks - 1) / maxChunks);
+  const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+  // A new size or table invalidates the previous assignment
+  bool reassigned = particleBucket_.size() != count ||
+                    bucketStart_.size() != bucketCount + 1;
+  if (reassigned) {
+    particleBucket_.assign(count, NO_BUCKET);
+    bucketStart_.assign(bucketCount + 1, 0);
+    bucketMask_ = static_cast<std::uint32_t>(bucketCount - 1);
+  }
+  chunkCounts_.resize(chunkCount * bucketCount);
+
+  // Bucket every particle and count per chunk
+  std::atomic<bool> moved{reassigned};
+  threadPool_.ParallelFor(
+      count, chunkSize, [&](std::size_t begin, std::size_t end) {
+        std::uint32_t *counts = &chunkCounts_[begin / chunkSize * bucketCount];
+        std::fill_n(counts, bucketCount, 0u);
+        bool chunkMoved = false;
+        for (std::size_t i = begin; i < end; ++i) {
+          const auto &particle = particles[i];
+          const std::uint32_t bucket =
+              particle.active ? BucketOf(CellOf(particle.position)) : NO_BUCKET;
+          chunkMoved = chunkMoved || bucket != particleBucket_[i];
+          particleBucket_[i] = bucket;
+          if (bucket != NO_BUCKET) {
+            ++counts[bucket];
+          }
+        }
+        if (chunkMoved) {
+          moved.store(true, std::memory_order_relaxed);
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  // Same buckets as last time: the order stands, only positions changed
+  if (!moved.load(std::memory_order_relaxed)) {
+    threadPool_.ParallelFor(
+        entries_.size(), CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+          for (std::size_t e = begin; e < end; ++e) {
+            entryPositions_[e] = particles[entries_[e]].position;
+          }
+        },
+        Core::TaskPriority::Critical);
+    return;
+  }
+
+  // Bucket totals, their prefix sum, then each chunk's offset per bucket.
+  // Histogram rows are walked whole so every pass reads memory in order.
+  bucketCursor_.resize(bucketCount);
+  threadPool_.ParallelFor(
+      bucketCount, BUCKET_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        std::fill(&bucketStart_[begin + 1], &bucketStart_[end + 1], 0u);
+        for (std::size_t c = 0; c < chunkCount; ++c) {
+          const std::uint32_t *counts = &chunkCounts_[c * bucketCount];
+          for (std::size_t b = begin; b < end; ++b) {
+            bucketStart_[b + 1] += counts[b];
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+  bucketStart_[0] = 0;
+  for (std::size_t b = 0; b < bucketCount; ++b) {
+    bucketStart_[b + 1] += bucketStart_[b];
+  }
+  threadPool_.ParallelFor(
+      bucketCount, BUCKET_CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+        std::copy(&bucketStart_[begin], &bucketStart_[end], &bucketCursor_[begin]);
+        for (std::size_t c = 0; c < chunkCount; ++c) {
+          std::uint32_t *counts = &chunkCounts_[c * bucketCount];
+          for (std::size_t b = begin; b < end; ++b) {
+            const std::uint32_t chunkTotal = counts[b];
+            counts[b] = bucketCursor_[b];
+            bucketCursor_[b] += chunkTotal;
+          }
+        }
+      },
+      Core::TaskPriority::Critical);
+
+  const std::size_t indexed = bucketStart_[bucketCount];
+  entries_.resize(indexed);
+  entryPositions_.resize(indexed);
+
+  // Scatter; chunks write disjoint ranges and keep index order per bucket
+  threadPool_.ParallelFor(
+      count, chunkSize, [&](std::size_t begin, std::size_t end) {
+        std::uint32_t *offsets = &chunkCounts_[begin / chunkSize * bucketCount];
+        for (std::size_t i = begin; i < end; ++i) {
+          const std::uint32_t bucket = particleBucket_[i];
+          if (bucket == NO_BUCKET)
+            continue;
+          const std::uint32_t entry = offsets[bucket]++;
+          entries_[entry] = static_cast<std::uint32_t>(i);
+          entryPositions_[entry] = particles[i].position;
+        }
+      },
+      Core::TaskPriority::Critical);
+}
+
+template <typename Visitor>
+void SpatialHash::ForEachInCells(const glm::ivec2 &min, const glm::ivec2 &max,
+                                 Visitor &&visit) const {
+  if (entries_.empty())
+    return;
+
+  // Ranges covering more cells than buckets are cheaper as a plain scan
+  const auto cells = static_cast<double>(max.x - min.x + 1) *
+                     static_cast<double>(max.y - min.y + 1);
+  if (cells > static_cast<double>(bucketMask_) + 1.0) {
+    for (std::size_t e = 0; e < entries_.size(); ++e) {
+      visit(e);
+    }
+    return;
+  }
+
+  for (int cy = min.y; cy <= max.y; ++cy) {
+    for (int cx = min.x; cx <= max.x; ++cx) {
+      const glm::ivec2 cell(cx, cy);
+      const std::uint32_t bucket = BucketOf(cell);
+      for (std::uint32_t e = bucketStart_[bucket]; e < bucketStart_[bucket + 1];
+           ++e) {
+        // Other cells can share the bucket; each entry is visited once
+        if (CellOf(entryPositions_[e]) == cell) {
+          visit(e);
+        }
+      }
+    }
+  }
+}
+
+void SpatialHash::QueryRadius(const glm::vec2 &center, float radius,
+                              std::vector<std::uint32_t> &result) const {
+  const float radiusSquared = radius * radius;
+  ForEachInCells(CellOf(center - glm::vec2(radius)),
+                 CellOf(center + glm::vec2(radius)), [&](std::size_t e) {
+                   const glm::vec2 d = entryPositions_[e] - center;
+                   if (glm::dot(d, d) <= radiusSquared) {
+                     result.push_back(entries_[e]);
+                   }
+                 });
+}
+
+void SpatialHash::QueryRect(const glm::vec2 &min, const glm::vec2 &max,
+                            std::vector<std::uint32_t> &result) const {
+  ForEachInCells(CellOf(min), CellOf(max), [&](std::size_t e) {
+    const glm::vec2 &p = entryPositions_[e];
+    if (p.x >= min.x && p.y >= min.y && p.x <= max.x && p.y <= max.y) {
+      result.push_back(entries_[e]);
+    }
+  });
+}
+
+std::optional<std::uint32_t> SpatialHash::Nearest(const glm::vec2 &position,
+                                                  float maxDistance) const {
+  const glm::ivec2 center = CellOf(position);
+  const int maxRing = static_cast<int>(std::ceil(maxDistance * inverseCellSize_));
+  float bestSquared = maxDistance * maxDistance;
+  std::optional<std::uint32_t> best;
+
+  auto consider = [&](std::size_t e) {
+    const glm::vec2 d = entryPositions_[e] - position;
+    const float distanceSquared = glm::dot(d, d);
+    // Ties go to the lower index so the answer does not depend on the order
+    if (distanceSquared < bestSquared ||
+        (best && distanceSquared == bestSquared && entries_[e] < *best)) {
+      bestSquared = distanceSquared;
+      best = entries_[e];
+    }
+  };
+
+  // Square rings of cells around the query cell, nearest first. Everything
+  // in ring r is at least (r - 1) cells away.
+  for (int ring = 0; ring <= maxRing; ++ring) {
+    if (ring > 1) {
+      const float gap = (ring - 1) * cellSize_;
+      if (gap * gap > bestSquared)
+        break;
+    }
+    if (ring == 0) {
+      ForEachInCells(center, center, consider);
+      continue;
+    }
+    const glm::ivec2 low = center - glm::ivec2(ring, ring);
+    const glm::ivec2 high = center + glm::ivec2(ring, ring);
+    ForEachInCells(low, glm::ivec2(high.x, low.y), consider);
+    ForEachInCells(glm::ivec2(low.x, high.y), high, consider);
+    ForEachInCells(glm::ivec2(low.x, low.y + 1), glm::ivec2(low.x, high.y - 1),
+                   consider);
+    ForEachInCells(glm::ivec2(high.x, low.y + 1), glm::ivec2(high.x, high.y - 1),
+                   consider);
+  }
+  return best;
+}
+
+} // namespace Physics
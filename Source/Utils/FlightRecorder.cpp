@@ -0,0 +1,334 @@
+#include "Utils/FlightRecorder.hpp"
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+
+namespace Core {
+
+namespace {
+
+std::string EscapeJson(std::string_view text) {
+  std::string escaped;
+  escaped.reserve(text.size());
+  for (char c : text) {
+    switch (c) {
+    case '"':
+      escaped += "\\\"";
+      break;
+    case '\\':
+      escaped += "\\\\";
+      break;
+    case '\n':
+      escaped += "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+      } else {
+        escaped += c;
+      }
+    }
+  }
+  return escaped;
+}
+
+std::string_view EventName(const TraceEvent &event) {
+  return std::string_view(event.name.data(),
+                          std::find(event.name.begin(), event.name.end(), '\0') -
+                              event.name.begin());
+}
+
+double ToMicroseconds(std::int64_t nanoseconds) {
+  return static_cast<double>(nanoseconds) / 1000.0;
+}
+
+} // namespace
+
+FlightRecorder &FlightRecorder::GetInstance() {
+  static FlightRecorder instance;
+  return instance;
+}
+
+FlightRecorder::FlightRecorder() : epoch_(std::chrono::steady_clock::now()) {}
+
+FlightRecorder::~FlightRecorder() {
+  if (pendingDump_.valid()) {
+    pendingDump_.wait();
+  }
+}
+
+void FlightRecorder::Configure(const FlightRecorderSettings &settings) {
+  settings_ = settings;
+  while (frames_.size() > settings_.framesToKeep) {
+    frames_.pop_front();
+  }
+}
+
+void FlightRecorder::SetThreadName(std::string_view name) {
+  auto &buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffersMutex_);
+  buffer.threadName = name;
+}
+
+void FlightRecorder::ThreadBuffer::Write(const TraceEvent &event) {
+  static_assert(sizeof(TraceEvent) == SLOT_WORDS * 8 &&
+                std::is_trivially_copyable_v<TraceEvent>);
+  const auto words =
+      std::bit_cast<std::array<std::uint64_t, SLOT_WORDS>>(event);
+
+  const std::uint64_t index = written.load(std::memory_order_relaxed);
+  Slot &slot = slots[index % EVENTS_PER_THREAD];
+  slot.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (std::size_t i = 0; i < SLOT_WORDS; ++i) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.sequence.store(index + 1, std::memory_order_release);
+  written.store(index + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::ThreadBuffer::Read(std::uint64_t index,
+                                        TraceEvent &event) const {
+  const Slot &slot = slots[index % EVENTS_PER_THREAD];
+  if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+    return false;
+
+  std::array<std::uint64_t, SLOT_WORDS> words;
+  for (std::size_t i = 0; i < SLOT_WORDS; ++i) {
+    words[i] = slot.words[i].load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (slot.sequence.load(std::memory_order_relaxed) != index + 1)
+    return false;
+
+  event = std::bit_cast<TraceEvent>(words);
+  return true;
+}
+
+FlightRecorder::ThreadBufferOwner::~ThreadBufferOwner() {
+  if (buffer) {
+    auto &recorder = GetInstance();
+    std::lock_guard<std::mutex> lock(recorder.buffersMutex_);
+    recorder.freeBuffers_.push_back(buffer);
+  }
+}
+
+FlightRecorder::ThreadBuffer &FlightRecorder::GetThreadBuffer() {
+  thread_local ThreadBufferOwner owner;
+  if (owner.buffer) {
+    return *owner.buffer;
+  }
+
+  std::unique_lock<std::mutex> lock(buffersMutex_);
+  if (!freeBuffers_.empty()) {
+    // Nobody writes a free buffer, and dumps hold the lock while reading
+    ThreadBuffer *buffer = freeBuffers_.back();
+    freeBuffers_.pop_back();
+    buffer->written.store(0, std::memory_order_relaxed);
+    buffer->threadId = nextThreadId_++;
+    buffer->threadName.clear();
+    owner.buffer = buffer;
+    return *buffer;
+  }
+  lock.unlock();
+
+  auto created = std::make_unique<ThreadBuffer>();
+  created->slots = std::make_unique<Slot[]>(EVENTS_PER_THREAD);
+  lock.lock();
+  created->threadId = nextThreadId_++;
+  owner.buffer = created.get();
+  buffers_.push_back(std::move(created));
+  return *owner.buffer;
+}
+
+std::int64_t FlightRecorder::Now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch_)
+      .count();
+}
+
+void FlightRecorder::Record(TraceEventType type, std::string_view name,
+                            std::uint64_t value) {
+  if (!enabled_.load(std::memory_order_relaxed))
+    return;
+
+  TraceEvent event;
+  event.timestamp = Now();
+  event.value = value;
+  event.type = type;
+  std::copy_n(name.begin(), std::min(name.size(), event.name.size() - 1),
+              event.name.begin());
+
+  GetThreadBuffer().Write(event);
+}
+
+void FlightRecorder::BeginFrame() {
+  frameStart_ = Now();
+  frameThread_ = GetThreadBuffer().threadId;
+}
+
+bool FlightRecorder::EndFrame() {
+  const std::int64_t frameEnd = Now();
+  frames_.push_back({frameIndex_++, frameStart_, frameEnd});
+  while (frames_.size() > settings_.framesToKeep) {
+    frames_.pop_front();
+  }
+
+  if (!enabled_)
+    return false;
+
+  const double seconds = (frameEnd - frameStart_) * 1e-9;
+  if (seconds <= settings_.frameBudget * settings_.slowFrameFactor)
+    return false;
+
+  return !hasDumped_ || (frameEnd - lastDump_) * 1e-9 >= settings_.dumpCooldown;
+}
+
+bool FlightRecorder::DumpAsync(TraceContext context) {
+  if (!enabled_ || frames_.empty())
+    return false;
+  if (pendingDump_.valid() && pendingDump_.wait_for(std::chrono::seconds(0)) !=
+                                  std::future_status::ready)
+    return false;
+
+  const std::int64_t windowStart = frames_.front().start;
+
+  // Copy the window out of the rings; serialisation happens off-thread
+  std::vector<TraceEvent> events;
+  std::vector<std::uint32_t> eventThreads;
+  std::vector<std::pair<std::uint32_t, std::string>> threadNames;
+  {
+    std::lock_guard<std::mutex> buffersLock(buffersMutex_);
+    for (const auto &buffer : buffers_) {
+      // Threads keep recording; events they overwrite meanwhile are dropped
+      const std::uint64_t written =
+          buffer->written.load(std::memory_order_acquire);
+      const std::uint64_t count =
+          std::min<std::uint64_t>(written, EVENTS_PER_THREAD);
+      for (std::uint64_t i = written - count; i < written; ++i) {
+        TraceEvent event;
+        if (buffer->Read(i, event) && event.timestamp >= windowStart) {
+          events.push_back(event);
+          eventThreads.push_back(buffer->threadId);
+        }
+      }
+      if (!buffer->threadName.empty()) {
+        threadNames.emplace_back(buffer->threadId, buffer->threadName);
+      }
+    }
+  }
+
+  std::vector<FrameRecord> frames(frames_.begin(), frames_.end());
+  auto path = settings_.outputDirectory /
+              fmt::format("hitch_{:06}.json", frames.back().index);
+
+  lastDump_ = Now();
+  hasDumped_ = true;
+
+  pendingDump_ = std::async(
+      std::launch::async,
+      [this, path = std::move(path), events = std::move(events),
+       eventThreads = std::move(eventThreads),
+       threadNames = std::move(threadNames), frames = std::move(frames),
+       frameThread = frameThread_, context = std::move(context),
+       settings = settings_]() {
+        WriteTrace(path, events, eventThreads, threadNames, frames,
+                   frameThread, context, settings);
+      });
+  return true;
+}
+
+void FlightRecorder::WriteTrace(
+    const std::filesystem::path &path, const std::vector<TraceEvent> &events,
+    const std::vector<std::uint32_t> &eventThreads,
+    const std::vector<std::pair<std::uint32_t, std::string>> &threadNames,
+    const std::vector<FrameRecord> &frames, std::uint32_t frameThread,
+    const TraceContext &context, const FlightRecorderSettings &settings) const {
+  std::error_code error;
+  std::filesystem::create_directories(path.parent_path(), error);
+
+  std::ofstream file(path);
+  if (!file) {
+    spdlog::error("Failed to write flight recorder trace to {}",
+                  path.string());
+    return;
+  }
+
+  const FrameRecord &slowFrame = frames.back();
+  const double frameMs = (slowFrame.end - slowFrame.start) * 1e-6;
+
+  file << "{\"displayTimeUnit\":\"ms\",\"otherData\":{";
+  file << fmt::format("\"slowFrame\":\"{}\",\"frameMs\":\"{:.3f}\","
+                      "\"budgetMs\":\"{:.3f}\"",
+                      slowFrame.index, frameMs, settings.frameBudget * 1000.0f);
+  for (const auto &[key, value] : context) {
+    file << ",\"" << EscapeJson(key) << "\":\"" << EscapeJson(value) << '"';
+  }
+  file << "},\"traceEvents\":[";
+
+  bool first = true;
+  auto separator = [&]() -> const char * {
+    if (first) {
+      first = false;
+      return "";
+    }
+    return ",\n";
+  };
+
+  for (const auto &[threadId, name] : threadNames) {
+    file << separator()
+         << fmt::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                        "\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                        threadId, EscapeJson(name));
+  }
+
+  for (const auto &frame : frames) {
+    file << separator()
+         << fmt::format("{{\"name\":\"Frame {}\",\"cat\":\"frame\",\"ph\":"
+                        "\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                        frame.index, frameThread, ToMicroseconds(frame.start),
+                        ToMicroseconds(frame.end - frame.start));
+  }
+
+  for (std::size_t i = 0; i < events.size(); ++i) {
+    const auto &event = events[i];
+    const std::string name = EscapeJson(EventName(event));
+    const double ts = ToMicroseconds(event.timestamp);
+
+    switch (event.type) {
+    case TraceEventType::SectionBegin:
+    case TraceEventType::TaskBegin:
+    case TraceEventType::SectionEnd:
+    case TraceEventType::TaskEnd: {
+      const bool begin = event.type == TraceEventType::SectionBegin ||
+                         event.type == TraceEventType::TaskBegin;
+      const bool task = event.type == TraceEventType::TaskBegin ||
+                        event.type == TraceEventType::TaskEnd;
+      file << separator()
+           << fmt::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\","
+                          "\"pid\":1,\"tid\":{},\"ts\":{:.3f}}}",
+                          name, task ? "task" : "section", begin ? "B" : "E",
+                          eventThreads[i], ts);
+      break;
+    }
+    case TraceEventType::Allocation:
+      file << separator()
+           << fmt::format("{{\"name\":\"{}\",\"cat\":\"allocation\",\"ph\":"
+                          "\"i\",\"s\":\"t\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},"
+                          "\"args\":{{\"bytes\":{}}}}}",
+                          name, eventThreads[i], ts, event.value);
+      break;
+    }
+  }
+
+  file << "]}\n";
+
+  spdlog::warn("Slow frame {} took {:.1f} ms; flight recorder trace written "
+               "to {}",
+               slowFrame.index, frameMs, path.string());
+}
+
+} // namespace Core
@@ -1,4 +1,6 @@
 #include "Utils/PerformanceProfiler.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Utils/FlightRecorder.hpp"
 #include <algorithm>
 #include <numeric>
 #include <spdlog/spdlog.h>
@@ -26,12 +28,16 @@ void PerformanceProfiler::EndFrame() {
 }
 
 void PerformanceProfiler::BeginSection(const std::string &name) {
+  FlightRecorder::GetInstance().Record(TraceEventType::SectionBegin, name);
+
   std::lock_guard<std::mutex> lock(mutex_);
 
   activeSections_[name] = SectionTimer{std::chrono::steady_clock::now(), true};
 }
 
 void PerformanceProfiler::EndSection(const std::string &name) {
+  FlightRecorder::GetInstance().Record(TraceEventType::SectionEnd, name);
+
   std::lock_guard<std::mutex> lock(mutex_);
 
   auto it = activeSections_.find(name);
@@ -92,6 +98,11 @@ PerformanceProfiler::GetSectionData(const std::string &name) const {
   return ProfileData{};
 }
 
+void PerformanceProfiler::SetThreadPool(const ThreadPool *threadPool) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  threadPool_ = threadPool;
+}
+
 void PerformanceProfiler::GenerateReport() const {
   std::lock_guard<std::mutex> lock(mutex_);
 
@@ -110,6 +121,31 @@ void PerformanceProfiler::GenerateReport() const {
                    data.maxTime * 1000.0, data.sampleCount);
     }
   }
+
+  if (threadPool_) {
+    const auto metrics = threadPool_->GetMetrics();
+    spdlog::info("--- Thread Pool ---");
+    spdlog::info("Utilization: {:.1f}% over {:.1f}s, {} tasks submitted",
+                 metrics.GetUtilization() * 100.0, metrics.wallSeconds,
+                 metrics.tasksSubmitted);
+    spdlog::info("Submit to start: p50 <{:.0f}us, p99 <{:.0f}us, max "
+                 "<{:.0f}us",
+                 metrics.GetLatencyPercentile(0.5),
+                 metrics.GetLatencyPercentile(0.99),
+                 metrics.GetLatencyPercentile(1.0));
+    spdlog::info("Queue depth: {} (high water {}), blocked on queue lock: "
+                 "{:.3f}ms",
+                 metrics.queueDepth, metrics.queueDepthHighWater,
+                 metrics.GetLockWaitSeconds() * 1000.0);
+    for (std::size_t i = 0; i < metrics.workers.size(); ++i) {
+      const auto &worker = metrics.workers[i];
+      spdlog::info("Worker {}: {} tasks, busy {:.1f}ms, idle {:.1f}ms, lock "
+                   "{:.3f}ms",
+                   i, worker.tasks, worker.busySeconds * 1000.0,
+                   worker.idleSeconds * 1000.0,
+                   worker.lockWaitSeconds * 1000.0);
+    }
+  }
 }
 
 void PerformanceProfiler::Reset() {
@@ -1,7 +1,16 @@
 #include "Core/DisplaySystem.hpp"
+#include "Core/ExecutionBackend.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Core/LargeBufferAllocator.hpp"
+#include "Graphics/ParticleRenderBackend.hpp"
 #include "Modes/ParticleGalaxyMode.hpp"
+#include "Physics/ForceSolver.hpp"
+#include "Physics/GravityKernels.hpp"
+#include "Physics/OutOfCoreSimulation.hpp"
+#include <cstdint>
 #include <exception>
 #include <iostream>
+#include <optional>
 #include <spdlog/spdlog.h>
 
 int main(int argc, char *argv[]) {
@@ -19,6 +28,28 @@ int main(int argc, char *argv[]) {
         .antialiasing_level = 8};
 
     bool demoMode = false;
+    std::string catalogPath;
+    std::string analysisCsvPath;
+    bool deterministic = false;
+    std::optional<std::uint32_t> seed;
+    std::optional<Core::ExecutionBackendType> backend;
+    std::optional<Physics::Precision> precision;
+    std::optional<Physics::SolverType> solver;
+    std::optional<std::uint32_t> temporalLOD;
+    bool fusedPipeline = false;
+    std::optional<Graphics::ParticleRenderBackendType> particleRenderer;
+    bool calibrateParticleRenderer = false;
+    std::string checkpointPath;
+    std::string restorePath;
+    std::string trajectoryPath;
+    std::uint64_t trajectoryInterval = 10;
+    bool trajectoryColors = false;
+    std::string audioSource;
+    std::optional<std::size_t> sonifyBuffer;
+    std::string outOfCorePath;
+    std::optional<std::uint64_t> outOfCoreCreate;
+    std::uint64_t outOfCoreSteps = 100;
+    Physics::OutOfCoreSettings outOfCoreSettings;
 
     // Parse command line arguments
     for (int i = 1; i < argc; ++i) {
@@ -35,9 +66,115 @@ int main(int argc, char *argv[]) {
       } else if (arg == "--demo") {
         demoMode = true;
         spdlog::info("Demo mode enabled - will cycle through all configurations");
+      } else if (arg == "--catalog" && i + 1 < argc) {
+        catalogPath = argv[++i];
+      } else if (arg == "--analysis-csv" && i + 1 < argc) {
+        analysisCsvPath = argv[++i];
+      } else if (arg == "--deterministic") {
+        deterministic = true;
+      } else if (arg == "--no-flight-recorder") {
+        config.flight_recorder = false;
+      } else if (arg == "--hitch-dir" && i + 1 < argc) {
+        config.hitch_directory = argv[++i];
+      } else if (arg == "--huge-pages" && i + 1 < argc) {
+        std::string policy = argv[++i];
+        if (policy == "off") {
+          Core::ConfigureLargeBuffers(Core::PagePolicy::Default);
+        } else if (policy == "thp") {
+          Core::ConfigureLargeBuffers(Core::PagePolicy::TransparentHugePages);
+        } else if (policy == "hugetlb") {
+          Core::ConfigureLargeBuffers(Core::PagePolicy::HugeTLB);
+        } else {
+          spdlog::warn("Unknown --huge-pages policy '{}'", policy);
+        }
+      } else if (arg == "--precision" && i + 1 < argc) {
+        std::string name = argv[++i];
+        precision = Physics::ParsePrecision(name);
+        if (!precision) {
+          spdlog::warn("Unknown --precision '{}' (expected fast, mixed or "
+                       "accurate)",
+                       name);
+        }
+      } else if (arg == "--solver" && i + 1 < argc) {
+        std::string name = argv[++i];
+        solver = Physics::ParseSolver(name);
+        if (!solver) {
+          spdlog::warn("Unknown --solver '{}' (expected bodies, direct, tree "
+                       "or grid)",
+                       name);
+        }
+      } else if (arg == "--temporal-lod" && i + 1 < argc) {
+        temporalLOD = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+      } else if (arg == "--fused") {
+        fusedPipeline = true;
+      } else if (arg == "--particle-renderer" && i + 1 < argc) {
+        std::string name = argv[++i];
+        particleRenderer = Graphics::ParseParticleRenderBackend(name);
+        calibrateParticleRenderer = name == "auto";
+        if (!particleRenderer && !calibrateParticleRenderer) {
+          spdlog::warn("Unknown --particle-renderer '{}' (expected quads, vbo, "
+                       "points, splat or auto)",
+                       name);
+        }
+      } else if (arg == "--direct") {
+        solver = Physics::SolverType::Direct;
+      } else if (arg == "--backend" && i + 1 < argc) {
+        std::string name = argv[++i];
+        backend = Core::ParseExecutionBackend(name);
+        if (!backend) {
+          spdlog::warn("Unknown --backend '{}' (expected pool, std, openmp or "
+                       "serial)",
+                       name);
+        }
+      } else if (arg == "--checkpoint" && i + 1 < argc) {
+        checkpointPath = argv[++i];
+      } else if (arg == "--restore" && i + 1 < argc) {
+        restorePath = argv[++i];
+      } else if (arg == "--trajectory" && i + 1 < argc) {
+        trajectoryPath = argv[++i];
+      } else if (arg == "--trajectory-every" && i + 1 < argc) {
+        trajectoryInterval = std::stoull(argv[++i]);
+      } else if (arg == "--trajectory-colors") {
+        trajectoryColors = true;
+      } else if (arg == "--audio" && i + 1 < argc) {
+        audioSource = argv[++i];
+      } else if (arg == "--sonify") {
+        sonifyBuffer = sonifyBuffer.value_or(512);
+      } else if (arg == "--sonify-buffer" && i + 1 < argc) {
+        sonifyBuffer = std::stoull(argv[++i]);
+      } else if (arg == "--out-of-core" && i + 1 < argc) {
+        outOfCorePath = argv[++i];
+      } else if (arg == "--ooc-create" && i + 1 < argc) {
+        outOfCoreCreate = std::stoull(argv[++i]);
+      } else if (arg == "--ooc-steps" && i + 1 < argc) {
+        outOfCoreSteps = std::stoull(argv[++i]);
+      } else if (arg == "--ooc-block" && i + 1 < argc) {
+        outOfCoreSettings.blockParticles = std::stoull(argv[++i]);
+      } else if (arg == "--seed" && i + 1 < argc) {
+        seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
       }
     }
 
+    // Headless job: no window, throughput goes to the log
+    if (!outOfCorePath.empty()) {
+      if (seed) {
+        outOfCoreSettings.seed = *seed;
+      }
+      if (outOfCoreCreate) {
+        outOfCoreSettings.particleCount = *outOfCoreCreate;
+      }
+
+      Core::ThreadPool threadPool;
+      Physics::OutOfCoreSimulation simulation(threadPool, outOfCoreSettings);
+      const bool ready = outOfCoreCreate ? simulation.Create(outOfCorePath)
+                                         : simulation.Open(outOfCorePath);
+      if (!ready) {
+        return 1;
+      }
+      simulation.Run(outOfCoreSteps);
+      return 0;
+    }
+
     Core::DisplaySystem displaySystem;
 
     if (!displaySystem.Initialize(config)) {
@@ -49,14 +186,77 @@ int main(int argc, char *argv[]) {
     displaySystem.RegisterVisualMode(
         std::make_unique<Modes::ParticleGalaxyMode>(displaySystem));
 
+    auto* galaxyMode = dynamic_cast<Modes::ParticleGalaxyMode*>(
+        displaySystem.GetCurrentMode());
+
     // Set demo mode flag if enabled
-    if (demoMode) {
-      auto* galaxyMode = dynamic_cast<Modes::ParticleGalaxyMode*>(
-          displaySystem.GetCurrentMode());
-      if (galaxyMode) {
-        galaxyMode->EnableDemoMode();
+    if (demoMode && galaxyMode) {
+      galaxyMode->EnableDemoMode();
+    }
+
+    // Reproducible runs: fixed timestep, fixed seed, periodic state hashes
+    if (deterministic && galaxyMode) {
+      galaxyMode->EnableDeterministicMode();
+      if (!seed) {
+        seed = Modes::ParticleGalaxyMode::DEFAULT_SEED;
       }
     }
+    if (seed && galaxyMode) {
+      galaxyMode->SetSeed(*seed);
+    }
+
+    if (precision && galaxyMode) {
+      galaxyMode->SetPrecision(*precision);
+    }
+    if (solver && galaxyMode) {
+      galaxyMode->SetSolver(*solver);
+    }
+    if (fusedPipeline && galaxyMode) {
+      galaxyMode->SetFusedPipeline(true);
+    }
+    if (temporalLOD && galaxyMode) {
+      galaxyMode->SetTemporalLOD(*temporalLOD);
+    }
+
+    if (backend && galaxyMode) {
+      galaxyMode->SetExecutionBackend(*backend);
+    }
+
+    // Seed the simulation from an external star catalog
+    if (!catalogPath.empty() && galaxyMode) {
+      galaxyMode->LoadCatalog(catalogPath);
+    }
+
+    if (!analysisCsvPath.empty() && galaxyMode) {
+      galaxyMode->EnableAnalysisCsv(analysisCsvPath);
+    }
+
+    if (!checkpointPath.empty() && galaxyMode) {
+      galaxyMode->SetCheckpointPath(checkpointPath);
+    }
+    if (!restorePath.empty() && galaxyMode) {
+      galaxyMode->RestoreCheckpoint(restorePath);
+    }
+
+    if (!trajectoryPath.empty() && galaxyMode) {
+      galaxyMode->EnableTrajectoryOutput(trajectoryPath, trajectoryInterval,
+                                         trajectoryColors);
+    }
+
+    if (!audioSource.empty() && galaxyMode) {
+      galaxyMode->EnableAudio(audioSource);
+    }
+
+    if (sonifyBuffer && galaxyMode) {
+      galaxyMode->EnableSonification(*sonifyBuffer);
+    }
+
+    // Calibrated on the scene that was just loaded
+    if (particleRenderer && galaxyMode) {
+      galaxyMode->SetParticleRenderer(*particleRenderer);
+    } else if (calibrateParticleRenderer && galaxyMode) {
+      galaxyMode->SelectFastestParticleRenderer();
+    }
 
     displaySystem.Run();
     displaySystem.Shutdown();
@@ -0,0 +1,28 @@
+#include "Analysis/ProfileAnalyzer.hpp"
+#include "Core/ThreadPool.hpp"
+#include <catch2/catch_all.hpp>
+#include <cmath>
+
+TEST_CASE("ProfileAnalyzer keeps radii just under the edge in the last bin",
+          "[ProfileAnalyzer]") {
+  Core::ThreadPool pool(2);
+  Analysis::ProfileAnalyzer analyzer(pool);
+  // 700 / 39 rounds so that the largest radius below 700 divides to 39
+  Analysis::ProfileSettings settings;
+  settings.maxRadius = 700.0f;
+  settings.binCount = 39;
+  analyzer.SetSettings(settings);
+
+  Analysis::ParticleSnapshot snapshot;
+  snapshot.positions = {{std::nextafter(settings.maxRadius, 0.0f), 0.0f},
+                        {10.0f, 0.0f}};
+  snapshot.velocities = {{0.0f, 1.0f}, {0.0f, 1.0f}};
+  snapshot.masses = {1.0f, 1.0f};
+  snapshot.particleIndices = {0, 1};
+
+  const auto profile = analyzer.Analyze(snapshot, {0.0f, 0.0f}, {0.0f, 0.0f},
+                                        0.0);
+  REQUIRE(profile.bins.size() == settings.binCount);
+  REQUIRE(profile.bins.back().count == 1);
+  REQUIRE(profile.bins.front().count == 1);
+}
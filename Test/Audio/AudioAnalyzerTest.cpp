@@ -0,0 +1,40 @@
+#include "Audio/AudioAnalyzer.hpp"
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <random>
+#include <vector>
+
+TEST_CASE("RealFFT magnitudes match a naive DFT", "[Audio][RealFFT]") {
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> sample(-1.0f, 1.0f);
+
+  for (std::size_t size : {4, 16, 128, 2048}) {
+    std::vector<float> input(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      // Noise plus a tone, so a few bins stand well above the rest
+      input[i] = 0.3f * sample(rng) +
+                 std::sin(2.0f * std::numbers::pi_v<float> * 3.0f *
+                          static_cast<float>(i) / static_cast<float>(size));
+    }
+
+    Audio::RealFFT fft(size);
+    std::vector<float> magnitudes(size / 2 + 1);
+    fft.Forward(input, magnitudes);
+
+    for (std::size_t k = 0; k <= size / 2; ++k) {
+      std::complex<double> sum(0.0, 0.0);
+      for (std::size_t n = 0; n < size; ++n) {
+        const double angle = -2.0 * std::numbers::pi *
+                             static_cast<double>(k * n % size) /
+                             static_cast<double>(size);
+        sum += static_cast<double>(input[n]) * std::polar(1.0, angle);
+      }
+      // Float rounding grows with log2(size) butterfly stages
+      INFO("size " << size << ", bin " << k);
+      REQUIRE(std::abs(magnitudes[k] - std::abs(sum)) <
+              1e-4 * static_cast<double>(size));
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#include "Core/ExecutionBackend.hpp"
+#include "Core/ThreadPool.hpp"
+#include "Physics/GravityKernels.hpp"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t PARTICLE_COUNT = 100000;
+constexpr std::size_t CHUNK_SIZE = 4096;
+
+std::vector<Graphics::Particle> MakeParticles(std::size_t count) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+  std::uniform_real_distribution<float> velocity(-5.0f, 5.0f);
+
+  std::vector<Graphics::Particle> particles(count);
+  for (auto &particle : particles) {
+    particle.position = {position(rng), position(rng)};
+    particle.velocity = {velocity(rng), velocity(rng)};
+  }
+  return particles;
+}
+
+const std::vector<Physics::GravitySource> SOURCES = {
+    {{0.0f, 0.0f}, 5000.0f}, {{120.0f, -80.0f}, 800.0f}};
+
+void Step(Core::ExecutionBackend &backend,
+          std::vector<Graphics::Particle> &particles) {
+  backend.ForEachChunk(particles.size(), CHUNK_SIZE,
+                       [&](std::size_t begin, std::size_t end) {
+                         Physics::AdvanceParticles(
+                             std::span(particles).subspan(begin, end - begin),
+                             SOURCES, 50.0f, 1.0f / 60.0f, {0.0f, 0.0f},
+                             2000.0f);
+                       });
+}
+
+std::uint64_t Hash(Core::ExecutionBackend &backend,
+                   const std::vector<Graphics::Particle> &particles) {
+  std::span<const Graphics::Particle> all(particles);
+  return backend.Reduce(
+      particles.size(), CHUNK_SIZE, std::uint64_t{0},
+      [all](std::size_t begin, std::size_t end) {
+        return Physics::HashParticleState(all.subspan(begin, end - begin));
+      },
+      Physics::CombineHashes);
+}
+
+} // namespace
+
+TEST_CASE("Execution backends give identical results", "[ExecutionBackend]") {
+  Core::ThreadPool pool(4);
+  auto reference = Core::CreateExecutionBackend(
+      Core::ExecutionBackendType::Serial, pool);
+
+  auto expected = MakeParticles(PARTICLE_COUNT);
+  for (int step = 0; step < 10; ++step) {
+    Step(*reference, expected);
+  }
+  const std::uint64_t expectedHash = Hash(*reference, expected);
+
+  for (auto type : Core::GetAvailableExecutionBackends()) {
+    auto backend = Core::CreateExecutionBackend(type, pool);
+    INFO("Backend: " << backend->GetName());
+    REQUIRE(backend->GetType() == type);
+
+    auto particles = MakeParticles(PARTICLE_COUNT);
+    for (int step = 0; step < 10; ++step) {
+      Step(*backend, particles);
+    }
+    REQUIRE(Hash(*backend, particles) == expectedHash);
+  }
+}
+
+TEST_CASE("Execution backends can be shared between threads",
+          "[ExecutionBackend]") {
+  Core::ThreadPool pool(4);
+  for (auto type : Core::GetAvailableExecutionBackends()) {
+    auto backend = Core::CreateExecutionBackend(type, pool);
+    INFO("Backend: " << backend->GetName());
+
+    // Each call covers its own range exactly once while the other runs
+    auto visitAll = [&backend](std::size_t count) {
+      std::vector<int> visits(count, 0);
+      for (int round = 0; round < 50; ++round) {
+        backend->ForEachChunk(count, 64,
+                              [&](std::size_t begin, std::size_t end) {
+                                for (std::size_t i = begin; i < end; ++i) {
+                                  ++visits[i];
+                                }
+                              });
+      }
+      return std::ranges::count(visits, 50) ==
+             static_cast<std::ptrdiff_t>(count);
+    };
+
+    bool otherOk = false;
+    std::thread other([&] { otherOk = visitAll(10000); });
+    const bool ok = visitAll(3000);
+    other.join();
+    REQUIRE(ok);
+    REQUIRE(otherOk);
+  }
+}
+
+TEST_CASE("Execution backend names round-trip", "[ExecutionBackend]") {
+  REQUIRE(Core::ParseExecutionBackend("pool") ==
+          Core::ExecutionBackendType::ThreadPool);
+  REQUIRE(Core::ParseExecutionBackend("serial") ==
+          Core::ExecutionBackendType::Serial);
+  REQUIRE_FALSE(Core::ParseExecutionBackend("cuda"));
+}
+
+// Side-by-side timings; hidden by default, run with "[benchmark]"
+TEST_CASE("Execution backend benchmarks", "[.][benchmark]") {
+  Core::ThreadPool pool;
+  auto particles = MakeParticles(1000000);
+  std::vector<float> quads(particles.size() * 8);
+
+  for (auto type : Core::GetAvailableExecutionBackends()) {
+    auto backend = Core::CreateExecutionBackend(type, pool);
+    const std::string name = backend->GetName();
+
+    BENCHMARK("Physics step (" + name + ")") { Step(*backend, particles); };
+
+    BENCHMARK("Vertex generation (" + name + ")") {
+      backend->ForEachChunk(
+          particles.size(), CHUNK_SIZE, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+              const float half = particles[i].size * 0.5f;
+              const auto &p = particles[i].position;
+              float *quad = &quads[i * 8];
+              quad[0] = p.x - half, quad[1] = p.y - half;
+              quad[2] = p.x + half, quad[3] = p.y - half;
+              quad[4] = p.x + half, quad[5] = p.y + half;
+              quad[6] = p.x - half, quad[7] = p.y + half;
+            }
+          });
+      return quads.back();
+    };
+
+    BENCHMARK("State hash reduction (" + name + ")") {
+      return Hash(*backend, particles);
+    };
+  }
+}
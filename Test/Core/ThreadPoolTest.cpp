@@ -1,8 +1,29 @@
+#include "Core/LargeBufferAllocator.hpp"
 #include "Core/ThreadPool.hpp"
 #include <atomic>
 #include <catch2/catch_all.hpp>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <vector>
 
+namespace {
+
+// Waits up to a second for the pending count to settle at expected
+std::size_t SettledPendingTasks(const Core::ThreadPool &pool,
+                                std::size_t expected) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (pool.GetNumPendingTasks() != expected &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return pool.GetNumPendingTasks();
+}
+
+} // namespace
+
 TEST_CASE("ThreadPool basic functionality", "[ThreadPool]") {
   Core::ThreadPool pool(4);
 
@@ -36,4 +57,170 @@ TEST_CASE("ThreadPool basic functionality", "[ThreadPool]") {
     REQUIRE(
         std::all_of(data.begin(), data.end(), [](int v) { return v == 1; }));
   }
-}
\ No newline at end of file
+
+  SECTION("Parallel for over chunks") {
+    std::vector<int> data(1000, 0);
+
+    pool.ParallelFor(data.size(), 64, [&data](std::size_t begin,
+                                              std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) {
+        data[i] += 1;
+      }
+    });
+
+    REQUIRE(
+        std::all_of(data.begin(), data.end(), [](int v) { return v == 1; }));
+  }
+
+  SECTION("Parallel reduce is independent of thread count") {
+    std::vector<float> data(10000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      data[i] = 1.0f / static_cast<float>(i + 1);
+    }
+
+    auto sumChunk = [&data](std::size_t begin, std::size_t end) {
+      float sum = 0.0f;
+      for (std::size_t i = begin; i < end; ++i) {
+        sum += data[i];
+      }
+      return sum;
+    };
+
+    Core::ThreadPool single(1);
+    float parallel =
+        pool.ParallelReduce(data.size(), 128, 0.0f, sumChunk, std::plus<>());
+    float serial =
+        single.ParallelReduce(data.size(), 128, 0.0f, sumChunk, std::plus<>());
+
+    REQUIRE(parallel == serial);
+  }
+}
+
+TEST_CASE("ThreadPool runs the most urgent queued task first",
+          "[ThreadPool]") {
+  Core::ThreadPool pool(1);
+
+  // Hold the only worker while tasks of every priority queue up
+  std::promise<void> release;
+  auto gate = release.get_future().share();
+  auto blocker = pool.Submit([gate] { gate.wait(); });
+
+  std::mutex orderMutex;
+  std::vector<int> order;
+  auto record = [&](int value) {
+    std::lock_guard<std::mutex> lock(orderMutex);
+    order.push_back(value);
+  };
+  std::vector<std::future<void>> futures;
+  futures.push_back(pool.Submit(Core::TaskPriority::Background, record, 3));
+  futures.push_back(pool.Submit(Core::TaskPriority::Normal, record, 2));
+  futures.push_back(pool.Submit(Core::TaskPriority::Background, record, 4));
+  futures.push_back(pool.Submit(Core::TaskPriority::Critical, record, 1));
+  REQUIRE(SettledPendingTasks(pool, 5) == 5);
+
+  release.set_value();
+  for (auto &future : futures) {
+    future.get();
+  }
+  REQUIRE(order == std::vector<int>{1, 2, 3, 4});
+}
+
+TEST_CASE("Reserved workers only take critical tasks", "[ThreadPool]") {
+  Core::ThreadPool pool(2);
+  pool.SetReservedWorkers(5); // Clamped so one worker stays general
+  REQUIRE(pool.GetReservedWorkers() == 1);
+
+  // Occupy the general worker
+  std::promise<void> started;
+  std::promise<void> release;
+  auto gate = release.get_future().share();
+  auto blocker =
+      pool.Submit(Core::TaskPriority::Background, [&started, gate] {
+        started.set_value();
+        gate.wait();
+      });
+  started.get_future().wait();
+
+  std::atomic<bool> normalRan{false};
+  auto normal = pool.Submit([&normalRan] { normalRan = true; });
+  // Runs on the reserved worker although the general one is busy
+  auto critical = pool.Submit(Core::TaskPriority::Critical, [] { return 7; });
+  REQUIRE(critical.wait_for(std::chrono::seconds(5)) ==
+          std::future_status::ready);
+  REQUIRE(critical.get() == 7);
+  REQUIRE_FALSE(normalRan);
+
+  release.set_value();
+  normal.get();
+  REQUIRE(normalRan);
+}
+
+TEST_CASE("ThreadPool metrics count tasks and waiting", "[ThreadPool]") {
+  Core::ThreadPool pool(2);
+  pool.Submit([] {}).get();
+  // The future is ready before the worker finishes its accounting
+  pool.WaitForAll();
+  pool.ResetMetrics();
+
+  // Queue work behind a blocked pool so every task waits to start
+  std::promise<void> release;
+  auto gate = release.get_future().share();
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 2; ++i) {
+    futures.push_back(pool.Submit([gate] { gate.wait(); }));
+  }
+  for (int i = 0; i < 20; ++i) {
+    futures.push_back(pool.Submit([] {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }));
+  }
+  REQUIRE(SettledPendingTasks(pool, 22) == 22);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  release.set_value();
+  for (auto &future : futures) {
+    future.get();
+  }
+  pool.WaitForAll();
+
+  const auto metrics = pool.GetMetrics();
+  REQUIRE(metrics.tasksSubmitted == 22);
+  REQUIRE(metrics.workers.size() == 2);
+  std::uint64_t tasks = 0;
+  std::uint64_t started = 0;
+  for (const auto &worker : metrics.workers) {
+    tasks += worker.tasks;
+    REQUIRE(worker.busySeconds >= 0.0);
+  }
+  for (auto count : metrics.startLatency) {
+    started += count;
+  }
+  REQUIRE(tasks == 22);
+  REQUIRE(started == 22);
+  REQUIRE(metrics.queueDepthHighWater >= 20);
+  REQUIRE(metrics.queueDepth == 0);
+  // The queued tasks waited out the 20 ms block
+  REQUIRE(metrics.GetLatencyPercentile(1.0) >= 16384.0);
+  REQUIRE(metrics.GetUtilization() > 0.0);
+  REQUIRE(metrics.GetUtilization() <= 1.0);
+}
+
+TEST_CASE("Large buffers allocated on a pool worker do not wait on the pool",
+          "[ThreadPool]") {
+  // With one worker, a parallel first touch from inside a task would queue
+  // behind the task itself
+  Core::ThreadPool pool(1);
+  Core::SetFirstTouchPool(&pool);
+  REQUIRE_FALSE(Core::ThreadPool::IsWorkerThread());
+
+  constexpr std::size_t BYTES = 4 * Core::LARGE_BUFFER_THRESHOLD;
+  auto allocated = pool.Submit([] {
+    void *data = Core::AllocateLargeBuffer(BYTES);
+    Core::DeallocateLargeBuffer(data, BYTES);
+    return Core::ThreadPool::IsWorkerThread();
+  });
+  const bool finished = allocated.wait_for(std::chrono::seconds(10)) ==
+                        std::future_status::ready;
+  Core::SetFirstTouchPool(nullptr);
+  REQUIRE(finished);
+  REQUIRE(allocated.get());
+}
@@ -0,0 +1,99 @@
+#include "Graphics/ParticleRenderBackend.hpp"
+#include <catch2/catch_all.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<Graphics::Particle> MakeParticles(std::size_t count,
+                                              float extent) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> position(0.0f, extent);
+
+  std::vector<Graphics::Particle> particles(count);
+  for (auto &particle : particles) {
+    particle.position = {position(rng), position(rng)};
+    particle.color = sf::Color(200, 180, 255, 120);
+    particle.size = 2.0f;
+  }
+  return particles;
+}
+
+} // namespace
+
+TEST_CASE("Particle render backends parse their names",
+          "[ParticleRenderBackend]") {
+  for (auto type : {Graphics::ParticleRenderBackendType::Quads,
+                    Graphics::ParticleRenderBackendType::StreamedQuads,
+                    Graphics::ParticleRenderBackendType::Points,
+                    Graphics::ParticleRenderBackendType::CpuSplat}) {
+    REQUIRE(Graphics::ParseParticleRenderBackend(Graphics::ToString(type)) ==
+            type);
+  }
+  REQUIRE_FALSE(Graphics::ParseParticleRenderBackend("vulkan"));
+}
+
+TEST_CASE("CPU splat adds particles into the pixel buffer",
+          "[ParticleRenderBackend]") {
+  std::vector<Graphics::Particle> particles(3);
+  particles[0].position = {2.5f, 1.5f};
+  particles[0].color = sf::Color(100, 50, 0, 255);
+  // Same pixel at half alpha: adds half its color
+  particles[1].position = {2.5f, 1.5f};
+  particles[1].color = sf::Color(200, 0, 0, 128);
+  particles[2].position = {6.5f, 6.5f};
+  particles[2].active = false;
+
+  // The view shows world [0, 4) on an 8 pixel target: two pixels per unit
+  Graphics::CpuSplatRenderBackend backend;
+  backend.Prepare(particles, sf::View(sf::FloatRect(0.0f, 0.0f, 4.0f, 4.0f)),
+                  {8, 8});
+  const auto pixels = backend.GetPixels();
+  REQUIRE(pixels.size() == 8 * 8 * 4);
+
+  auto pixel = [&](unsigned x, unsigned y) { return &pixels[(y * 8 + x) * 4]; };
+  // Size 1 covers the 2x2 pixels around (5, 3)
+  for (unsigned y = 2; y < 4; ++y) {
+    for (unsigned x = 4; x < 6; ++x) {
+      REQUIRE(pixel(x, y)[0] == 200);
+      REQUIRE(pixel(x, y)[1] == 50);
+      REQUIRE(pixel(x, y)[3] == 255);
+    }
+  }
+  REQUIRE(pixel(3, 2)[3] == 0);
+  REQUIRE(pixel(6, 2)[3] == 0);
+  std::size_t lit = 0;
+  for (std::size_t i = 3; i < pixels.size(); i += 4) {
+    lit += pixels[i] != 0;
+  }
+  REQUIRE(lit == 4);
+}
+
+// Milliseconds per frame per backend; hidden by default, run with "[render]".
+// Without a GL context only the CPU side (Prepare) is timed.
+TEST_CASE("Particle render backend benchmarks", "[.][benchmark][render]") {
+  constexpr unsigned SIZE = 1024;
+  constexpr int FRAMES = 10;
+  sf::RenderTexture target;
+  const bool hasTarget = target.create(SIZE, SIZE);
+  const sf::View view(sf::FloatRect(0.0f, 0.0f, SIZE, SIZE));
+
+  for (std::size_t count : {10000, 100000, 1000000}) {
+    const auto particles = MakeParticles(count, static_cast<float>(SIZE));
+    for (auto type : Graphics::GetAvailableParticleRenderBackends()) {
+      auto backend = Graphics::CreateParticleRenderBackend(type);
+      const std::string name =
+          backend->GetName() + " (" + std::to_string(count) + " particles)";
+      if (hasTarget) {
+        WARN(name << ": "
+                  << Graphics::BenchmarkParticleRenderBackend(
+                         *backend, particles, target, FRAMES)
+                  << " ms/frame");
+      } else {
+        BENCHMARK("Prepare " + name) {
+          backend->Prepare(particles, view, {SIZE, SIZE});
+        };
+      }
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#include "Core/ThreadPool.hpp"
+#include "Graphics/Starfield.hpp"
+#include <catch2/catch_all.hpp>
+
+TEST_CASE("Starfield tiles are generated from their key", "[Starfield]") {
+  const Graphics::StarfieldTileKey key{-3, 7, 1, 2};
+  const auto tile = Graphics::Starfield::GenerateTile(key, 42);
+  REQUIRE_FALSE(tile.empty());
+  REQUIRE(tile.size() % 4 == 0);
+
+  // Same key and seed, same stars
+  const auto again = Graphics::Starfield::GenerateTile(key, 42);
+  REQUIRE(again.size() == tile.size());
+  for (std::size_t i = 0; i < tile.size(); ++i) {
+    REQUIRE(again[i].position.x == tile[i].position.x);
+    REQUIRE(again[i].position.y == tile[i].position.y);
+  }
+
+  // Star centers lie inside the tile (level 1: half the base size)
+  const float size = Graphics::Starfield::BASE_TILE_SIZE * 0.5f;
+  for (std::size_t i = 0; i < tile.size(); i += 4) {
+    const float x = (tile[i].position.x + tile[i + 2].position.x) * 0.5f;
+    const float y = (tile[i].position.y + tile[i + 2].position.y) * 0.5f;
+    REQUIRE(x >= -3.0f * size);
+    REQUIRE(x <= -2.0f * size);
+    REQUIRE(y >= 7.0f * size);
+    REQUIRE(y <= 8.0f * size);
+  }
+
+  const auto neighbour = Graphics::Starfield::GenerateTile({-2, 7, 1, 2}, 42);
+  REQUIRE((neighbour.size() != tile.size() ||
+           neighbour[0].position.y != tile[0].position.y));
+}
+
+TEST_CASE("Starfield cache stays bounded while panning and zooming",
+          "[Starfield]") {
+  constexpr std::size_t MAX_TILES = 64;
+  Core::ThreadPool pool(2);
+  Graphics::Starfield starfield(pool, 7, MAX_TILES);
+  const glm::vec2 screen(512.0f, 512.0f);
+
+  auto show = [&](const glm::vec2 &position, float zoom) {
+    starfield.Update(position, screen, zoom, 0.0f);
+    pool.WaitForAll();
+    starfield.Update(position, screen, zoom, 0.0f);
+  };
+
+  for (int step = 0; step < 40; ++step) {
+    const float zoom = step < 20 ? 1.0f : 0.25f * static_cast<float>(step);
+    show({static_cast<float>(step) * 3000.0f, 0.0f}, zoom);
+    REQUIRE(starfield.GetPendingTileCount() == 0);
+    REQUIRE(starfield.GetVisibleTileCount() > 0);
+    REQUIRE(starfield.GetCachedTileCount() <= MAX_TILES);
+  }
+
+  // An unchanged view is drawn from the cache alone
+  const std::size_t cached = starfield.GetCachedTileCount();
+  starfield.Update({117000.0f, 0.0f}, screen, 9.75f, 0.0f);
+  REQUIRE(starfield.GetPendingTileCount() == 0);
+  REQUIRE(starfield.GetCachedTileCount() == cached);
+}
@@ -0,0 +1,129 @@
+#include "Core/ThreadPool.hpp"
+#include "Graphics/ParticleSystem.hpp"
+#include "IO/CatalogImporter.hpp"
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void WriteFile(const std::filesystem::path &path, const std::string &bytes) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+TEST_CASE("CatalogImporter parses text catalogs", "[CatalogImporter]") {
+  Core::ThreadPool pool(4);
+  Graphics::ParticleSystem particleSystem(100);
+  IO::CatalogImporter importer(pool);
+
+  const auto path =
+      std::filesystem::temp_directory_path() / "catalog_importer_test.csv";
+  WriteFile(path, "x,y,vx,vy,mass,bv\n"
+                  "1,2,0.5,-0.5,2,0.65\n"
+                  "3,4\n"
+                  "abc,5\n"
+                  "# comment\n"
+                  " -1.5, 2.5, 0, 0, 1\n"
+                  "\n"
+                  "7,8,1,1,-1\n");
+
+  IO::CatalogImportOptions options;
+  options.origin = {10.0f, 20.0f};
+  options.positionScale = 2.0f;
+  options.velocityScale = 4.0f;
+  // Tiny chunks split the body across many parser tasks
+  options.chunkBytes = GENERATE(std::size_t{4 * 1024 * 1024}, std::size_t{8});
+
+  auto result = importer.Import(path.string(), particleSystem, options);
+  REQUIRE(result);
+  // Malformed, comment, blank and massless rows are skipped without taking
+  // a slot, so accepted stars stay in file order with no gaps
+  const auto &particles = particleSystem.GetParticles();
+  REQUIRE(particles.size() == 3);
+  REQUIRE(result->particleCount == 3);
+  REQUIRE(result->skippedRows == 4);
+
+  REQUIRE(particles[0].active);
+  REQUIRE(particles[0].position == glm::vec2(12.0f, 24.0f));
+  REQUIRE(particles[0].velocity == glm::vec2(2.0f, -2.0f));
+  REQUIRE(particles[0].mass == 2.0f);
+  // Omitted columns take their defaults
+  REQUIRE(particles[1].active);
+  REQUIRE(particles[1].position == glm::vec2(16.0f, 28.0f));
+  REQUIRE(particles[1].velocity == glm::vec2(0.0f, 0.0f));
+  REQUIRE(particles[1].mass == 1.0f);
+  REQUIRE(particles[2].active);
+  REQUIRE(particles[2].position == glm::vec2(7.0f, 25.0f));
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("CatalogImporter reads binary records", "[CatalogImporter]") {
+  Core::ThreadPool pool(2);
+  Graphics::ParticleSystem particleSystem(100);
+  IO::CatalogImporter importer(pool);
+  const auto path =
+      std::filesystem::temp_directory_path() / "catalog_importer_test.bin";
+
+  // Three records, the second massless, then a partial record
+  const std::vector<float> records = {1.0f, 2.0f, 0.0f, 1.0f, 3.0f, 0.2f,
+                                      5.0f, 6.0f, 0.0f, 0.0f, 0.0f, 0.2f,
+                                      -1.0f, 9.0f, 2.0f, 0.0f, 1.0f, 1.4f};
+  std::string bytes(reinterpret_cast<const char *>(records.data()),
+                    records.size() * sizeof(float));
+  WriteFile(path, bytes + "xx");
+
+  auto result = importer.Import(path.string(), particleSystem);
+  REQUIRE(result);
+  const auto &particles = particleSystem.GetParticles();
+  REQUIRE(particles.size() == 2);
+  REQUIRE(result->particleCount == 2);
+  REQUIRE(result->skippedRows == 1);
+  REQUIRE(particles[0].active);
+  REQUIRE(particles[0].position == glm::vec2(1.0f, 2.0f));
+  REQUIRE(particles[0].velocity == glm::vec2(0.0f, 1.0f));
+  REQUIRE(particles[0].mass == 3.0f);
+  REQUIRE(particles[1].active);
+  REQUIRE(particles[1].position == glm::vec2(-1.0f, 9.0f));
+
+  // Less than one record
+  WriteFile(path, bytes.substr(0, 10));
+  result = importer.Import(path.string(), particleSystem);
+  REQUIRE_FALSE(result);
+  REQUIRE(result.error() == IO::CatalogError::TruncatedBinary);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("CatalogImporter rejects empty and missing catalogs",
+          "[CatalogImporter]") {
+  Core::ThreadPool pool(2);
+  Graphics::ParticleSystem particleSystem(100);
+  IO::CatalogImporter importer(pool);
+  const auto path =
+      std::filesystem::temp_directory_path() / "catalog_importer_empty.csv";
+
+  WriteFile(path, "x,y,vx,vy\n");
+  auto result = importer.Import(path.string(), particleSystem);
+  REQUIRE_FALSE(result);
+  REQUIRE(result.error() == IO::CatalogError::EmptyCatalog);
+  // A failed import leaves the pool alone
+  REQUIRE(particleSystem.GetParticles().size() == 100);
+
+  // Rows that are all rejected count as empty too
+  WriteFile(path, "x,y\n# comment\n\nabc,1\n1,2,0,0,0\n");
+  result = importer.Import(path.string(), particleSystem);
+  REQUIRE_FALSE(result);
+  REQUIRE(result.error() == IO::CatalogError::EmptyCatalog);
+  REQUIRE(particleSystem.GetParticles().size() == 100);
+
+  std::filesystem::remove(path);
+  result = importer.Import(path.string(), particleSystem);
+  REQUIRE_FALSE(result);
+  REQUIRE(result.error() == IO::CatalogError::OpenFailed);
+}
@@ -0,0 +1,167 @@
+#include "IO/Checkpoint.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace {
+
+IO::CheckpointState MakeState() {
+  IO::CheckpointState state;
+  state.header.stepCount = 42;
+  state.header.simulationTime = 1.5;
+  state.header.timeDilation = 2.0f;
+  state.header.preset = 3;
+  state.header.seed = 7;
+
+  state.particles.resize(1000);
+  for (std::size_t i = 0; i < state.particles.size(); ++i) {
+    auto &particle = state.particles[i];
+    particle.position = {static_cast<float>(i), -0.5f * static_cast<float>(i)};
+    particle.velocity = {1.0f, static_cast<float>(i % 13)};
+    particle.mass = 1.0f + static_cast<float>(i % 5);
+    particle.active = i % 3 != 0;
+  }
+  state.bodies = {{{1.0f, 2.0f}, {0.0f, 1.0f}, 5000.0f, 12.0f, 0xff8000ffu, 2},
+                  {{-4.0f, 8.0f}, {1.0f, 0.0f}, 100.0f, 3.0f, 0xffffffffu, 1}};
+  state.trails = {{1.0f, 1.0f}, {1.5f, 1.5f}, {-4.0f, 7.0f}};
+  state.rngState = "5489 1 2 3";
+  return state;
+}
+
+std::string ReadBytes(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(file), {}};
+}
+
+void WriteBytes(const std::filesystem::path &path, const std::string &bytes) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+// Byte offset of a section table entry; entries follow the header
+std::size_t SectionOffset(std::size_t index) {
+  return sizeof(IO::CheckpointHeader) + index * sizeof(IO::CheckpointSection);
+}
+
+} // namespace
+
+TEST_CASE("Checkpoints round-trip through the mapped reader", "[Checkpoint]") {
+  const auto path =
+      std::filesystem::temp_directory_path() / "checkpoint_test.ckpt";
+  const auto state = MakeState();
+  REQUIRE(IO::WriteCheckpoint(state, path));
+
+  auto checkpoint = IO::Checkpoint::Open(path.string());
+  REQUIRE(checkpoint);
+  const auto &header = checkpoint->GetHeader();
+  REQUIRE(header.stepCount == 42);
+  REQUIRE(header.simulationTime == 1.5);
+  REQUIRE(header.timeDilation == 2.0f);
+  REQUIRE(header.preset == 3);
+  REQUIRE(header.seed == 7);
+
+  const auto particles = checkpoint->GetParticles();
+  REQUIRE(particles.size() == state.particles.size());
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    REQUIRE(particles[i].position == state.particles[i].position);
+    REQUIRE(particles[i].velocity == state.particles[i].velocity);
+    REQUIRE(particles[i].mass == state.particles[i].mass);
+    REQUIRE(particles[i].active == state.particles[i].active);
+  }
+
+  const auto bodies = checkpoint->GetBodies();
+  REQUIRE(bodies.size() == 2);
+  REQUIRE(bodies[0].position == state.bodies[0].position);
+  REQUIRE(bodies[0].color == state.bodies[0].color);
+  REQUIRE(bodies[1].trailCount == 1);
+  const auto trails = checkpoint->GetTrails();
+  REQUIRE(std::equal(trails.begin(), trails.end(), state.trails.begin(),
+                     state.trails.end()));
+  REQUIRE(checkpoint->GetRngState() == state.rngState);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Damaged checkpoints are rejected", "[Checkpoint]") {
+  const auto path =
+      std::filesystem::temp_directory_path() / "checkpoint_test_source.ckpt";
+  const auto damagedPath =
+      std::filesystem::temp_directory_path() / "checkpoint_test_damaged.ckpt";
+  REQUIRE(IO::WriteCheckpoint(MakeState(), path));
+  const std::string bytes = ReadBytes(path);
+  std::filesystem::remove(path);
+
+  auto openDamaged = [&](const std::string &damaged) {
+    WriteBytes(damagedPath, damaged);
+    return IO::Checkpoint::Open(damagedPath.string());
+  };
+  auto expectError = [&](const std::string &damaged,
+                         IO::CheckpointError error) {
+    const auto checkpoint = openDamaged(damaged);
+    REQUIRE_FALSE(checkpoint);
+    REQUIRE(checkpoint.error() == error);
+  };
+
+  SECTION("Truncated files") {
+    expectError(bytes.substr(0, sizeof(IO::CheckpointHeader) / 2),
+                IO::CheckpointError::Truncated);
+    // Header intact, section table cut short
+    expectError(bytes.substr(0, SectionOffset(2) + 8),
+                IO::CheckpointError::Truncated);
+    // Particle array cut short
+    IO::CheckpointSection particles;
+    std::memcpy(&particles, bytes.data() + SectionOffset(0),
+                sizeof(particles));
+    expectError(bytes.substr(0, particles.offset + particles.bytes / 2),
+                IO::CheckpointError::Truncated);
+  }
+
+  SECTION("Bad magic and version") {
+    std::string damaged = bytes;
+    damaged[0] = 'X';
+    expectError(damaged, IO::CheckpointError::BadMagic);
+
+    damaged = bytes;
+    const std::uint32_t version = IO::CHECKPOINT_VERSION + 1;
+    std::memcpy(damaged.data() + offsetof(IO::CheckpointHeader, version),
+                &version, sizeof(version));
+    expectError(damaged, IO::CheckpointError::UnsupportedVersion);
+  }
+
+  SECTION("Bad section table") {
+    auto patchSection = [&](std::size_t index, auto &&patch) {
+      std::string damaged = bytes;
+      IO::CheckpointSection section;
+      std::memcpy(&section, damaged.data() + SectionOffset(index),
+                  sizeof(section));
+      patch(section);
+      std::memcpy(damaged.data() + SectionOffset(index), &section,
+                  sizeof(section));
+      return damaged;
+    };
+
+    // Records of another size, as from a build with a different Particle
+    expectError(patchSection(0, [](auto &s) { s.recordSize += 4; }),
+                IO::CheckpointError::LayoutMismatch);
+    expectError(patchSection(1, [](auto &s) { s.offset += 4; }),
+                IO::CheckpointError::LayoutMismatch);
+    expectError(patchSection(2, [](auto &s) {
+                  s.type = static_cast<IO::CheckpointSectionType>(99);
+                }),
+                IO::CheckpointError::MissingSection);
+    // An array that runs past the end of the file
+    expectError(patchSection(3,
+                             [](auto &s) {
+                               s.count = 1ull << 40;
+                               s.bytes = s.count;
+                             }),
+                IO::CheckpointError::Truncated);
+  }
+
+  std::filesystem::remove(damagedPath);
+}
@@ -0,0 +1,131 @@
+#include "Core/ThreadPool.hpp"
+#include "IO/Trajectory.hpp"
+#include "IO/TrajectoryCodec.hpp"
+#include <bit>
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+TEST_CASE("Trajectory codec round-trips word arrays", "[Trajectory]") {
+  std::mt19937 rng(11);
+
+  SECTION("Smooth float data compresses") {
+    std::vector<std::uint32_t> words(50000);
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      words[i] = std::bit_cast<std::uint32_t>(100.0f + 0.01f * i);
+    }
+
+    auto encoded = IO::EncodeWords(words);
+    REQUIRE(encoded.size() < words.size() * 4 / 2);
+
+    std::vector<std::uint32_t> decoded(words.size());
+    REQUIRE(IO::DecodeWords(encoded, decoded));
+    REQUIRE(decoded == words);
+  }
+
+  SECTION("Deltas against a reference block round-trip") {
+    std::vector<std::uint32_t> reference(20000);
+    std::vector<std::uint32_t> words(reference.size());
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    for (std::size_t i = 0; i < words.size(); ++i) {
+      const float value = position(rng);
+      reference[i] = std::bit_cast<std::uint32_t>(value);
+      words[i] = std::bit_cast<std::uint32_t>(value - 0.001f * (i % 7));
+    }
+
+    auto encoded = IO::EncodeWords(words, reference);
+    REQUIRE(encoded.size() < IO::EncodeWords(words).size());
+
+    std::vector<std::uint32_t> decoded(words.size());
+    REQUIRE(IO::DecodeWords(encoded, decoded, reference));
+    REQUIRE(decoded == words);
+  }
+
+  SECTION("Random data falls back to stored blocks") {
+    std::vector<std::uint32_t> words(10000);
+    for (auto &word : words) {
+      word = rng();
+    }
+
+    auto encoded = IO::EncodeWords(words);
+    REQUIRE(encoded.size() <= words.size() * 4 + 1);
+
+    std::vector<std::uint32_t> decoded(words.size());
+    REQUIRE(IO::DecodeWords(encoded, decoded));
+    REQUIRE(decoded == words);
+  }
+
+  SECTION("Empty and constant arrays") {
+    std::vector<std::uint32_t> empty;
+    std::vector<std::uint32_t> decodedEmpty;
+    REQUIRE(IO::DecodeWords(IO::EncodeWords(empty), decodedEmpty));
+
+    std::vector<std::uint32_t> constant(4096, 0xDEADBEEF);
+    std::vector<std::uint32_t> decoded(constant.size());
+    REQUIRE(IO::DecodeWords(IO::EncodeWords(constant), decoded));
+    REQUIRE(decoded == constant);
+  }
+
+  SECTION("Corrupt blocks are rejected") {
+    std::vector<std::uint32_t> words(1000, 7);
+    auto encoded = IO::EncodeWords(words);
+    encoded.resize(encoded.size() / 2);
+
+    std::vector<std::uint32_t> decoded(words.size());
+    REQUIRE_FALSE(IO::DecodeWords(encoded, decoded));
+  }
+}
+
+TEST_CASE("Trajectory files can be read back frame by frame",
+          "[Trajectory]") {
+  Core::ThreadPool pool(4);
+  const auto path =
+      std::filesystem::temp_directory_path() / "trajectory_test.traj";
+
+  std::vector<Graphics::Particle> particles(150000);
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    particles[i].position = {static_cast<float>(i), 0.5f * i};
+    particles[i].velocity = {1.0f, -1.0f};
+    particles[i].active = i % 5 != 0;
+  }
+
+  {
+    IO::TrajectoryWriter writer(pool);
+    IO::TrajectoryOptions options;
+    options.fields = IO::TRAJECTORY_POSITION | IO::TRAJECTORY_VELOCITY;
+    options.keyframeInterval = 2;
+    REQUIRE(writer.Open(path, options));
+
+    for (std::uint64_t step = 0; step < 5; ++step) {
+      writer.SubmitFrame(particles, step * 10, step * 0.5);
+      for (auto &particle : particles) {
+        particle.position += particle.velocity;
+      }
+    }
+  }
+
+  auto opened = IO::TrajectoryReader::Open(path.string());
+  REQUIRE(opened);
+  auto &reader = opened.value();
+  REQUIRE(reader.GetFrameCount() == 5);
+  REQUIRE(reader.GetFrameEntry(3).keyframe == 2);
+
+  // Seek straight to a delta frame, then backwards across key frames
+  for (std::size_t index : {3, 1, 4, 0}) {
+    auto frame = reader.ReadFrame(index);
+    REQUIRE(frame);
+    REQUIRE(frame.value().step == index * 10);
+    REQUIRE(frame.value().positions.size() == particles.size());
+    REQUIRE(frame.value().colors.empty());
+
+    const float moved = static_cast<float>(index);
+    REQUIRE_FALSE(frame.value().active[5]);
+    REQUIRE(frame.value().active[6]);
+    REQUIRE(frame.value().positions[6] == glm::vec2(6.0f + moved, 3.0f - moved));
+    REQUIRE(frame.value().velocities[6] == glm::vec2(1.0f, -1.0f));
+  }
+
+  REQUIRE_FALSE(reader.ReadFrame(5));
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,58 @@
+#include "Core/ThreadPool.hpp"
+#include "Physics/DirectSummation.hpp"
+#include <catch2/catch_all.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+TEST_CASE("DirectSummation matches a naive all-pairs sum", "[DirectSummation]") {
+  // Not a multiple of the tile size, with some inactive stars
+  constexpr std::size_t COUNT = 700;
+  constexpr float G = 100.0f;
+  std::mt19937 rng(5);
+  std::normal_distribution<float> position(0.0f, 200.0f);
+  std::uniform_real_distribution<float> mass(0.5f, 2.0f);
+
+  std::vector<Graphics::Particle> particles(COUNT);
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    particles[i].position = {position(rng), position(rng)};
+    particles[i].mass = mass(rng);
+    particles[i].active = i % 9 != 0;
+  }
+
+  Core::ThreadPool pool(3);
+  Physics::DirectSummation direct(pool);
+  std::vector<glm::vec2> accelerations(COUNT);
+  const auto stats = direct.ComputeAccelerations(particles, G, accelerations);
+  REQUIRE(stats.bodies == COUNT - (COUNT + 8) / 9);
+
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    if (!particles[i].active) {
+      REQUIRE(accelerations[i] == glm::vec2(0.0f));
+      continue;
+    }
+    double ax = 0.0;
+    double ay = 0.0;
+    for (std::size_t j = 0; j < COUNT; ++j) {
+      if (j == i || !particles[j].active)
+        continue;
+      const double dx = particles[j].position.x - particles[i].position.x;
+      const double dy = particles[j].position.y - particles[i].position.y;
+      const double distanceSq =
+          dx * dx + dy * dy + Physics::DirectSummation::DEFAULT_SOFTENING_SQ;
+      const double scale =
+          G * particles[j].mass / (distanceSq * std::sqrt(distanceSq));
+      ax += dx * scale;
+      ay += dy * scale;
+    }
+    REQUIRE(std::abs(accelerations[i].x - ax) < 1e-4);
+    REQUIRE(std::abs(accelerations[i].y - ay) < 1e-4);
+  }
+
+  // Fixed work lanes: the worker count does not change a single bit
+  Core::ThreadPool single(1);
+  Physics::DirectSummation serial(single);
+  std::vector<glm::vec2> serialAccelerations(COUNT);
+  serial.ComputeAccelerations(particles, G, serialAccelerations);
+  REQUIRE(serialAccelerations == accelerations);
+}
@@ -0,0 +1,137 @@
+#include "Core/ThreadPool.hpp"
+#include "Physics/DirectSummation.hpp"
+#include "Physics/GravityKernels.hpp"
+#include "Physics/OutOfCoreSimulation.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+Physics::OutOfCoreSettings SmallDisk() {
+  Physics::OutOfCoreSettings settings;
+  settings.particleCount = 8192;
+  settings.blockParticles = 1024;
+  settings.diskRadius = 1000.0f;
+  settings.fieldResolution = 64;
+  settings.timeStep = 0.01f;
+  return settings;
+}
+
+std::vector<Physics::StreamedParticle>
+ReadParticles(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  Physics::OutOfCoreHeader header;
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  std::vector<Physics::StreamedParticle> particles(header.particleCount);
+  file.seekg(static_cast<std::streamoff>(header.dataOffset));
+  file.read(reinterpret_cast<char *>(particles.data()),
+            static_cast<std::streamsize>(particles.size() *
+                                         sizeof(Physics::StreamedParticle)));
+  return particles;
+}
+
+std::vector<Graphics::Particle>
+ToParticles(const std::vector<Physics::StreamedParticle> &streamed) {
+  std::vector<Graphics::Particle> particles(streamed.size());
+  for (std::size_t i = 0; i < streamed.size(); ++i) {
+    particles[i].position = streamed[i].position;
+    particles[i].velocity = streamed[i].velocity;
+    particles[i].mass = streamed[i].mass;
+    particles[i].active = true;
+  }
+  return particles;
+}
+
+double Median(std::vector<double> values) {
+  std::ranges::nth_element(values, values.begin() + values.size() / 2);
+  return values[values.size() / 2];
+}
+
+} // namespace
+
+TEST_CASE("Out-of-core steps match the in-memory kernel around a point mass",
+          "[OutOfCore]") {
+  Core::ThreadPool pool(4);
+  auto settings = SmallDisk();
+  settings.diskMass = 0.0f; // Only the central mass pulls
+  const auto path = std::filesystem::temp_directory_path() / "ooc_test.ooc";
+  {
+    Physics::OutOfCoreSimulation simulation(pool, settings);
+    REQUIRE(simulation.Create(path));
+  }
+  auto particles = ToParticles(ReadParticles(path));
+  for (auto &particle : particles) {
+    particle.mass = 1.0f;
+  }
+
+  // Resumed from the file, as a real run would be
+  constexpr int STEPS = 3;
+  {
+    Physics::OutOfCoreSimulation simulation(pool, settings);
+    REQUIRE(simulation.Open(path));
+    for (int step = 0; step < STEPS; ++step) {
+      simulation.Step();
+    }
+    REQUIRE(simulation.GetStep() == STEPS);
+  }
+
+  const Physics::GravitySource center{{0.0f, 0.0f}, settings.centralMass};
+  for (int step = 0; step < STEPS; ++step) {
+    Physics::AdvanceParticles(particles, std::span(&center, 1),
+                              settings.gravitationalConstant, settings.timeStep,
+                              {0.0f, 0.0f}, 1e9f);
+  }
+
+  const auto streamed = ReadParticles(path);
+  REQUIRE(streamed.size() == particles.size());
+  for (std::size_t i = 0; i < streamed.size(); ++i) {
+    REQUIRE(glm::length(streamed[i].position - particles[i].position) <
+            1e-3f);
+    REQUIRE(glm::length(streamed[i].velocity - particles[i].velocity) <
+            1e-3f);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("Out-of-core disk gravity follows direct summation", "[OutOfCore]") {
+  Core::ThreadPool pool(4);
+  const auto settings = SmallDisk();
+  const auto path = std::filesystem::temp_directory_path() / "ooc_test.ooc";
+  {
+    Physics::OutOfCoreSimulation simulation(pool, settings);
+    REQUIRE(simulation.Create(path));
+  }
+  const auto before = ReadParticles(path);
+  {
+    Physics::OutOfCoreSimulation simulation(pool, settings);
+    REQUIRE(simulation.Open(path));
+    simulation.Step();
+  }
+  const auto after = ReadParticles(path);
+
+  // Softened to about one grid cell (the disk spans 64 of them)
+  const auto particles = ToParticles(before);
+  std::vector<glm::vec2> disk(particles.size());
+  Physics::DirectSummation direct(pool, 1000.0f);
+  direct.ComputeAccelerations(particles, settings.gravitationalConstant, disk);
+
+  std::vector<double> totalErrors;
+  std::vector<double> diskErrors;
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    const glm::vec2 central = Physics::GravitationalForce(
+        before[i].position, glm::vec2(0.0f, 0.0f), 1.0f, settings.centralMass,
+        settings.gravitationalConstant);
+    const glm::vec2 streamed =
+        (after[i].velocity - before[i].velocity) / settings.timeStep;
+    totalErrors.push_back(glm::length(streamed - central - disk[i]) /
+                          glm::length(central + disk[i]));
+    diskErrors.push_back(glm::length(streamed - central - disk[i]) /
+                         glm::length(disk[i]));
+  }
+  REQUIRE(Median(totalErrors) < 0.02);
+  REQUIRE(Median(diskErrors) < 0.1);
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,211 @@
+#include "Core/ThreadPool.hpp"
+#include "Graphics/ParticleRenderBackend.hpp"
+#include "Physics/DirectSummation.hpp"
+#include "Physics/PhysicsEngine.hpp"
+#include <catch2/catch_all.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+TEST_CASE("PhysicsEngine switches force solvers at runtime",
+          "[PhysicsEngine]") {
+  constexpr std::size_t COUNT = 40;
+  Core::ThreadPool pool(2);
+  Physics::PhysicsEngine engine(pool, COUNT);
+  auto &system = engine.GetParticleSystem();
+  system.SetDamping(1.0f);
+  system.Resize(COUNT);
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    auto &particle = system.GetParticles()[i];
+    particle.position = {static_cast<float>(i % 8) * 20.0f,
+                         static_cast<float>(i / 8) * 20.0f};
+    particle.lifetime = 1000.0f;
+    particle.active = true;
+  }
+
+  // No bodies and no star-star term: nothing pulls on the stars
+  engine.Step(0.1f);
+  REQUIRE_FALSE(engine.IsSolverApplied());
+  REQUIRE(system.GetParticles()[0].velocity == glm::vec2(0.0f));
+
+  // Empty slots are rejected and leave the solver unchanged
+  REQUIRE_FALSE(engine.SetSolver(Physics::SolverType::Tree));
+  REQUIRE(engine.GetSolver() == Physics::SolverType::MassiveBodies);
+
+  engine.RegisterSolver(std::make_unique<Physics::DirectSummation>(pool));
+  REQUIRE(engine.SetSolver(Physics::SolverType::Direct));
+  engine.Step(0.1f);
+  REQUIRE(engine.IsSolverApplied());
+  REQUIRE(system.GetParticles()[0].velocity != glm::vec2(0.0f));
+
+  // Timings are kept per solver
+  const auto &bodies =
+      engine.GetSolverTiming(Physics::SolverType::MassiveBodies);
+  const auto &direct = engine.GetSolverTiming(Physics::SolverType::Direct);
+  REQUIRE(bodies.steps == 1);
+  REQUIRE(direct.steps == 1);
+  REQUIRE(direct.averageSolverSeconds > 0.0);
+}
+
+TEST_CASE("PhysicsEngine temporal LOD catches deferred stars up",
+          "[PhysicsEngine]") {
+  constexpr std::size_t COUNT = 12;
+  constexpr float DT = 0.1f;
+  Core::ThreadPool pool(2);
+  Physics::PhysicsEngine engine(pool, COUNT);
+  auto &system = engine.GetParticleSystem();
+  system.SetDamping(1.0f);
+  system.Resize(COUNT);
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    auto &particle = system.GetParticles()[i];
+    particle.position = {static_cast<float>(i) * 100.0f, 0.0f};
+    particle.velocity = {1.0f, 0.0f};
+    particle.lifetime = 1000.0f;
+    particle.active = true;
+  }
+
+  // Only the first star is in view
+  engine.SetTemporalLOD(4);
+  engine.SetViewRegion({-50.0f, -50.0f}, {50.0f, 50.0f});
+  for (int step = 0; step < 3; ++step) {
+    engine.Step(DT);
+  }
+  REQUIRE(engine.GetDeferredCount() > 0);
+  const auto &particles = system.GetParticles();
+  // No forces: the kernel and the particle system each drift by v * t
+  const float travelled = 2.0f * 3.0f * DT;
+  REQUIRE(std::abs(particles[0].position.x - travelled) < 1e-5f);
+  REQUIRE(particles[5].position.x < 500.0f + travelled - 1e-3f);
+
+  engine.CatchUp();
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    REQUIRE(std::abs(particles[i].position.x -
+                     (static_cast<float>(i) * 100.0f + travelled)) < 1e-3f);
+  }
+}
+
+TEST_CASE("PhysicsEngine accurate runs keep double state under a solver",
+          "[PhysicsEngine]") {
+  constexpr std::size_t COUNT = 16;
+  constexpr float DT = 0.1f;
+  constexpr float G = 1e-3f;
+  Core::ThreadPool pool(2);
+  Physics::PhysicsEngine engine(pool, COUNT);
+  engine.SetPrecision(Physics::Precision::Accurate);
+  engine.SetGravitationalConstant(G);
+  engine.RegisterSolver(std::make_unique<Physics::DirectSummation>(pool));
+  REQUIRE(engine.SetSolver(Physics::SolverType::Direct));
+  auto &system = engine.GetParticleSystem();
+  system.SetDamping(1.0f);
+  system.Resize(COUNT);
+  // Far from the origin each step moves a star by about one float ulp, so
+  // float state would lose most of every step
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    auto &particle = system.GetParticles()[i];
+    particle.position = {10000.0f + static_cast<float>(i % 4) * 20.0f,
+                         10000.0f + static_cast<float>(i / 4) * 20.0f};
+    particle.velocity = {0.01f, 0.005f};
+    particle.mass = 1.0f;
+    particle.lifetime = 1e6f;
+    particle.active = true;
+  }
+
+  // The same steps in double: solver kick, kernel drift (no bodies), then
+  // the particle system's drift
+  std::vector<Graphics::Particle> reference(system.GetParticles().begin(),
+                                            system.GetParticles().end());
+  std::vector<glm::dvec2> positions(COUNT);
+  std::vector<glm::dvec2> velocities(COUNT);
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    positions[i] = glm::dvec2(reference[i].position);
+    velocities[i] = glm::dvec2(reference[i].velocity);
+  }
+  Physics::DirectSummation direct(pool);
+  std::vector<glm::vec2> accelerations(COUNT);
+  constexpr int STEPS = 100;
+  for (int step = 0; step < STEPS; ++step) {
+    engine.Step(DT);
+    direct.ComputeAccelerations(reference, G, accelerations);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+      velocities[i] += glm::dvec2(accelerations[i]) * static_cast<double>(DT);
+      positions[i] += velocities[i] * static_cast<double>(DT);
+      positions[i] += velocities[i] * static_cast<double>(DT);
+      reference[i].position = glm::vec2(positions[i]);
+    }
+  }
+
+  // Within a float ulp at 10000 of the double result
+  const auto &particles = system.GetParticles();
+  double maxError = 0.0;
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    maxError = std::max(
+        maxError,
+        glm::length(glm::dvec2(particles[i].position) - positions[i]));
+  }
+  REQUIRE(maxError < 2e-3);
+}
+
+TEST_CASE("PhysicsEngine fused pipeline matches separate passes",
+          "[PhysicsEngine]") {
+  constexpr std::size_t COUNT = 10000;
+  Core::ThreadPool pool(3);
+  auto makeEngine = [&](bool fused) {
+    auto engine = std::make_unique<Physics::PhysicsEngine>(pool, COUNT);
+    engine->SetFusedPipeline(fused);
+    engine->GetBodies().push_back(
+        {{0.0f, 0.0f}, {0.0f, 0.0f}, 5000.0f, 10.0f, sf::Color(), {}});
+    auto &system = engine->GetParticleSystem();
+    system.Resize(COUNT);
+    for (std::size_t i = 0; i < COUNT; ++i) {
+      auto &particle = system.GetParticles()[i];
+      particle.position = {static_cast<float>(i % 100) * 7.0f - 350.0f,
+                           static_cast<float>(i / 100) * 7.0f - 350.0f};
+      particle.velocity = {particle.position.y * 0.1f,
+                           -particle.position.x * 0.1f};
+      particle.lifetime = 0.5f + static_cast<float>(i % 7) * 0.1f;
+      // Every chunk partly inactive, and one (of 4096) entirely
+      particle.active = i % 5 != 0 && (i < 4096 || i >= 8192);
+    }
+    return engine;
+  };
+
+  auto separate = makeEngine(false);
+  auto fused = makeEngine(true);
+  for (int step = 0; step < 8; ++step) {
+    separate->Step(0.1f);
+    fused->Step(0.1f);
+  }
+
+  // Same per-particle operations in the same order: bit-identical
+  const auto &a = separate->GetParticleSystem().GetParticles();
+  const auto &b = fused->GetParticleSystem().GetParticles();
+  std::size_t mismatches = 0;
+  for (std::size_t i = 0; i < COUNT; ++i) {
+    mismatches += a[i].active != b[i].active ||
+                  a[i].position != b[i].position ||
+                  a[i].velocity != b[i].velocity ||
+                  a[i].color.a != b[i].color.a;
+  }
+  REQUIRE(mismatches == 0);
+
+  // The fused quads, gaps skipped, are the quads the render backend builds
+  // from the same particles
+  const auto &system = fused->GetParticleSystem();
+  REQUIRE(system.HasFusedVertices());
+  std::vector<sf::Vertex> fusedVertices;
+  system.ForEachFusedRange([&](const sf::Vertex *vertices, std::size_t count) {
+    fusedVertices.insert(fusedVertices.end(), vertices, vertices + count);
+  });
+  auto quads = Graphics::CreateParticleRenderBackend(
+      Graphics::ParticleRenderBackendType::Quads);
+  quads->Prepare(b, sf::View(), {512, 512});
+  const auto expected = quads->GetVertices();
+  REQUIRE(fusedVertices.size() == expected.size());
+  REQUIRE(fusedVertices.size() < COUNT * 4);
+  for (std::size_t i = 0; i < fusedVertices.size(); ++i) {
+    mismatches += fusedVertices[i].position != expected[i].position ||
+                  fusedVertices[i].color != expected[i].color;
+  }
+  REQUIRE(mismatches == 0);
+}
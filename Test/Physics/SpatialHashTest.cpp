@@ -0,0 +1,105 @@
+#include "Core/ThreadPool.hpp"
+#include "Physics/SpatialHash.hpp"
+#include <algorithm>
+#include <catch2/catch_all.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+
+std::vector<Graphics::Particle> MakeParticles(std::size_t count) {
+  std::mt19937 rng(11);
+  std::normal_distribution<float> position(0.0f, 300.0f);
+
+  std::vector<Graphics::Particle> particles(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    particles[i].position = {position(rng), position(rng)};
+    particles[i].active = i % 7 != 0;
+  }
+  return particles;
+}
+
+std::vector<std::uint32_t> BruteForceRadius(
+    const std::vector<Graphics::Particle> &particles, const glm::vec2 &center,
+    float radius) {
+  std::vector<std::uint32_t> result;
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    const glm::vec2 d = particles[i].position - center;
+    if (particles[i].active && glm::dot(d, d) <= radius * radius) {
+      result.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("SpatialHash queries match a linear scan", "[Physics][SpatialHash]") {
+  Core::ThreadPool pool(4);
+  auto particles = MakeParticles(200000);
+  Physics::SpatialHash hash(pool, 6.0f);
+
+  // The second build takes the path where particles changed cells
+  const bool moveParticles = GENERATE(false, true);
+  hash.Build(particles);
+  if (moveParticles) {
+    for (auto &particle : particles) {
+      particle.position += glm::vec2(7.5f, -3.0f);
+    }
+    hash.Build(particles);
+  }
+
+  const std::vector<glm::vec2> probes = {
+      {0.0f, 0.0f}, {150.0f, -40.0f}, {-700.0f, 300.0f}, {2000.0f, 2000.0f}};
+  for (const auto &probe : probes) {
+    std::vector<std::uint32_t> found;
+    hash.QueryRadius(probe, 25.0f, found);
+    std::ranges::sort(found);
+    REQUIRE(found == BruteForceRadius(particles, probe, 25.0f));
+
+    std::vector<std::uint32_t> inRect;
+    hash.QueryRect(probe - glm::vec2(30.0f, 10.0f), probe + glm::vec2(5.0f, 40.0f),
+                   inRect);
+    const auto expectedInRect = std::ranges::count_if(particles, [&](const auto &p) {
+      return p.active && p.position.x >= probe.x - 30.0f &&
+             p.position.x <= probe.x + 5.0f && p.position.y >= probe.y - 10.0f &&
+             p.position.y <= probe.y + 40.0f;
+    });
+    REQUIRE(inRect.size() == static_cast<std::size_t>(expectedInRect));
+
+    // Nearest within a generous radius equals the brute-force minimum
+    const auto nearest = hash.Nearest(probe, 200.0f);
+    float bestDistance = 200.0f * 200.0f;
+    std::optional<std::uint32_t> expected;
+    for (std::uint32_t i = 0; i < particles.size(); ++i) {
+      const glm::vec2 d = particles[i].position - probe;
+      const float distance = glm::dot(d, d);
+      if (particles[i].active && distance < bestDistance) {
+        bestDistance = distance;
+        expected = i;
+      }
+    }
+    REQUIRE(nearest == expected);
+  }
+}
+
+TEST_CASE("SpatialHash widens chunks for large tables",
+          "[Physics][SpatialHash]") {
+  // 2M particles get 2^18 buckets, so the histogram cap allows 16 chunks
+  // of 125000 rather than 31 of the default size
+  Core::ThreadPool pool(4);
+  const auto particles = MakeParticles(2000000);
+  Physics::SpatialHash hash(pool, 6.0f);
+  hash.Build(particles);
+  REQUIRE(hash.GetIndexedCount() ==
+          static_cast<std::size_t>(std::ranges::count_if(
+              particles, [](const auto &p) { return p.active; })));
+
+  for (const glm::vec2 probe :
+       {glm::vec2(0.0f, 0.0f), glm::vec2(-420.0f, 90.0f)}) {
+    std::vector<std::uint32_t> found;
+    hash.QueryRadius(probe, 12.0f, found);
+    std::ranges::sort(found);
+    REQUIRE(found == BruteForceRadius(particles, probe, 12.0f));
+  }
+}
@@ -0,0 +1,69 @@
+#include "Utils/SpscRing.hpp"
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <thread>
+
+TEST_CASE("SpscRing keeps FIFO order across wraparound", "[SpscRing]") {
+  Utils::SpscRing<int, 4> ring;
+  int value = 0;
+  REQUIRE_FALSE(ring.TryPop(value));
+
+  // Three in, two out per round: the indices wrap the four slots many
+  // times and the ring fills up every other round
+  int pushed = 0;
+  int popped = 0;
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 3; ++i) {
+      if (ring.TryPush(pushed)) {
+        ++pushed;
+      }
+    }
+    for (int i = 0; i < 2; ++i) {
+      REQUIRE(ring.TryPop(value));
+      REQUIRE(value == popped++);
+    }
+  }
+  // Full: one more push fails until something is popped
+  while (ring.TryPush(pushed)) {
+    ++pushed;
+  }
+  REQUIRE(pushed - popped == 4);
+  REQUIRE(ring.TryPop(value));
+  REQUIRE(value == popped++);
+  REQUIRE(ring.TryPush(pushed++));
+
+  while (ring.TryPop(value)) {
+    REQUIRE(value == popped++);
+  }
+  REQUIRE(popped == pushed);
+}
+
+TEST_CASE("SpscRing hands every value across threads in order",
+          "[SpscRing]") {
+  constexpr std::uint32_t COUNT = 200'000;
+  Utils::SpscRing<std::uint32_t, 64> ring;
+
+  std::thread producer([&ring] {
+    for (std::uint32_t i = 0; i < COUNT;) {
+      if (ring.TryPush(i)) {
+        ++i;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::uint32_t expected = 0;
+  bool ordered = true;
+  while (expected < COUNT) {
+    std::uint32_t value;
+    if (ring.TryPop(value)) {
+      ordered = ordered && value == expected;
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  REQUIRE(ordered);
+}
@@ -0,0 +1,73 @@
+#include "Utils/TripleBuffer.hpp"
+#include <array>
+#include <atomic>
+#include <catch2/catch_all.hpp>
+#include <cstdint>
+#include <thread>
+
+namespace {
+
+// Every word carries the sequence number, so a torn copy shows up as a
+// mismatch between words
+struct Snapshot {
+  std::uint64_t sequence = 0;
+  std::array<std::uint64_t, 15> payload{};
+};
+
+} // namespace
+
+TEST_CASE("TripleBuffer returns the latest published value", "[TripleBuffer]") {
+  Utils::TripleBuffer<int> buffer(-1);
+  REQUIRE(buffer.Read() == -1);
+
+  buffer.Publish(1);
+  buffer.Publish(2);
+  REQUIRE(buffer.Read() == 2);
+  // Nothing new: the last value read stays
+  REQUIRE(buffer.Read() == 2);
+
+  buffer.GetWriteBuffer() = 3;
+  REQUIRE(buffer.Read() == 2);
+  buffer.Publish();
+  REQUIRE(buffer.Read() == 3);
+}
+
+TEST_CASE("TripleBuffer readers see whole, current snapshots",
+          "[TripleBuffer]") {
+  constexpr std::uint64_t COUNT = 200'000;
+  Utils::TripleBuffer<Snapshot> buffer;
+  std::atomic<std::uint64_t> published{0};
+
+  std::thread producer([&] {
+    for (std::uint64_t sequence = 1; sequence <= COUNT; ++sequence) {
+      Snapshot &snapshot = buffer.GetWriteBuffer();
+      snapshot.sequence = sequence;
+      snapshot.payload.fill(sequence);
+      buffer.Publish();
+      published.store(sequence, std::memory_order_release);
+      if (sequence % 64 == 0) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  bool whole = true;
+  bool current = true;
+  std::uint64_t last = 0;
+  while (last < COUNT) {
+    // Anything published before the read starts must be visible to it
+    const std::uint64_t latest = published.load(std::memory_order_acquire);
+    const Snapshot &snapshot = buffer.Read();
+    for (std::uint64_t word : snapshot.payload) {
+      whole = whole && word == snapshot.sequence;
+    }
+    current = current && snapshot.sequence >= latest &&
+              snapshot.sequence >= last;
+    last = snapshot.sequence;
+    std::this_thread::yield();
+  }
+  producer.join();
+  REQUIRE(whole);
+  REQUIRE(current);
+  REQUIRE(buffer.Read().sequence == COUNT);
+}